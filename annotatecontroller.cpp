@@ -39,9 +39,15 @@ struct AnnotateController::Private {
     AnnotateDialog *dialog;
     ProgressDialog *progress;
 
-    bool execute(const QString &fileName, const QString &revision);
-    void parseCvsLogOutput();
-    void parseCvsAnnotateOutput();
+    // state of the parser of the output
+    enum { Begin, Tags, Admin, Revision, Author, Branches, Comment, Finished, Annotate } state;
+    QString comment, rev;
+    QString oldRevision;
+    bool odd;
+
+    bool execute(const QString &fileName, const QString &revision, QObject *receiver);
+    void parseCvsLogLine(const QString &line);
+    void parseCvsAnnotateLine(const QString &line);
 };
 
 AnnotateController::AnnotateController(AnnotateDialog *dialog, OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService)
@@ -51,6 +57,8 @@ AnnotateController::AnnotateController(AnnotateDialog *dialog, OrgKdeCervisia5Cv
     d->cvsService = cvsService;
     d->dialog = dialog;
     d->progress = 0;
+    d->state = Private::Begin;
+    d->odd = false;
 }
 
 AnnotateController::~AnnotateController()
@@ -60,129 +68,125 @@ AnnotateController::~AnnotateController()
 
 void AnnotateController::showDialog(const QString &fileName, const QString &revision)
 {
-    if (!d->execute(fileName, revision)) {
+    d->dialog->setWindowTitle(i18n("CVS Annotate: %1", fileName));
+
+    if (!d->execute(fileName, revision, this)) {
+        delete d->progress;
+        d->progress = 0;
         delete d->dialog;
         return;
     }
 
-    d->parseCvsLogOutput();
-    d->parseCvsAnnotateOutput();
-
     // hide progress dialog
     delete d->progress;
     d->progress = 0;
 
-    d->dialog->setWindowTitle(i18n("CVS Annotate: %1", fileName));
     d->dialog->show();
 }
 
-bool AnnotateController::Private::execute(const QString &fileName, const QString &revision)
+void AnnotateController::parseLine(const QString &line)
+{
+    if (d->state == Private::Annotate)
+        d->parseCvsAnnotateLine(line);
+    else
+        d->parseCvsLogLine(line);
+}
+
+bool AnnotateController::Private::execute(const QString &fileName, const QString &revision, QObject *receiver)
 {
     QDBusReply<QDBusObjectPath> job = cvsService->annotate(fileName, revision);
     if (!job.isValid())
         return false;
 
+    // the annotated lines are shown while the output arrives
     progress = new ProgressDialog(dialog, "Annotate", cvsService->service(), job, "annotate", i18n("CVS Annotate"));
+    progress->setStreaming(true);
+    QObject::connect(progress, SIGNAL(receivedLine(QString)), receiver, SLOT(parseLine(QString)));
 
     return progress->execute();
 }
 
-void AnnotateController::Private::parseCvsLogOutput()
+void AnnotateController::Private::parseCvsLogLine(const QString &line)
 {
-    QString line, comment, rev;
-
-    enum { Begin, Tags, Admin, Revision, Author, Branches, Comment, Finished } state;
-
-    state = Begin;
-    while (progress->getLine(line)) {
-        switch (state) {
-        case Begin:
-            if (line == "symbolic names:")
-                state = Tags;
-            break;
-        case Tags:
-            if (line[0] != '\t')
-                state = Admin;
-            break;
-        case Admin:
-            if (line == "----------------------------")
-                state = Revision;
-            break;
-        case Revision:
-            rev = line.section(' ', 1, 1);
-            state = Author;
-            break;
-        case Author:
-            state = Branches;
-            break;
-        case Branches:
-            if (!line.startsWith(QLatin1String("branches:"))) {
-                state = Comment;
-                comment = line;
-            }
-            break;
-        case Comment:
-            if (line == "----------------------------")
-                state = Revision;
-            else if (line == "=============================================================================")
-                state = Finished;
-            if (state == Comment)
-                comment += QString("\n") + line;
-            else
-                comments[rev] = comment;
-            break;
-        case Finished:;
+    switch (state) {
+    case Begin:
+        if (line == "symbolic names:")
+            state = Tags;
+        break;
+    case Tags:
+        if (line[0] != '\t')
+            state = Admin;
+        break;
+    case Admin:
+        if (line == "----------------------------")
+            state = Revision;
+        break;
+    case Revision:
+        rev = line.section(' ', 1, 1);
+        state = Author;
+        break;
+    case Author:
+        state = Branches;
+        break;
+    case Branches:
+        if (!line.startsWith(QLatin1String("branches:"))) {
+            state = Comment;
+            comment = line;
         }
-
-        if (state == Finished)
-            break;
+        break;
+    case Comment:
+        if (line == "----------------------------")
+            state = Revision;
+        else if (line == "=============================================================================")
+            state = Finished;
+        if (state == Comment)
+            comment += QString("\n") + line;
+        else
+            comments[rev] = comment;
+        break;
+    case Finished:
+        // skip header part of cvs annotate output
+        if (line.startsWith(QLatin1String("*****")))
+            state = Annotate;
+        break;
+    case Annotate:;
     }
-
-    // skip header part of cvs annotate output
-    bool notEof = true;
-    while (notEof && !line.startsWith(QLatin1String("*****")))
-        notEof = progress->getLine(line);
 }
 
-void AnnotateController::Private::parseCvsAnnotateOutput()
+void AnnotateController::Private::parseCvsAnnotateLine(const QString &line)
 {
     LogInfo logInfo;
-    QString rev, content, line;
-    QString oldRevision;
-    bool odd = false;
 
-    while (progress->getLine(line)) {
-        int startIdxC2 = line.indexOf(QLatin1Char('(')); // column 2 "(author date):"
+    int startIdxC2 = line.indexOf(QLatin1Char('(')); // column 2 "(author date):"
 
-        QString authorDate = line.mid(startIdxC2 + 1, line.indexOf(QLatin1Char(')'), startIdxC2 + 1) - startIdxC2 - 1);
+    QString authorDate = line.mid(startIdxC2 + 1, line.indexOf(QLatin1Char(')'), startIdxC2 + 1) - startIdxC2 - 1);
 
-        QString dateString = authorDate.mid(authorDate.lastIndexOf(QLatin1Char(' '))).trimmed();
-        if (!dateString.isEmpty()) {
-            QDate date(QLocale::c().toDate(dateString, QLatin1String("dd-MMM-yy")));
-            if (date.year() < 1970)
-                date = date.addYears(100);
-            logInfo.m_dateTime = QDateTime(date, QTime(), Qt::UTC);
-        }
+    QString dateString = authorDate.mid(authorDate.lastIndexOf(QLatin1Char(' '))).trimmed();
+    if (!dateString.isEmpty()) {
+        QDate date(QLocale::c().toDate(dateString, QLatin1String("dd-MMM-yy")));
+        if (date.year() < 1970)
+            date = date.addYears(100);
+        logInfo.m_dateTime = QDateTime(date, QTime(), Qt::UTC);
+    }
 
-        rev = line.left(startIdxC2).trimmed();
-        logInfo.m_author = authorDate.left(authorDate.indexOf(QLatin1Char(' '))).trimmed();
-        content = line.mid(line.indexOf(QLatin1String("): "), startIdxC2 + 1) + 3);
-
-        logInfo.m_comment = comments[rev];
-
-        if (rev == oldRevision) {
-            // don't remove revision/author info on following lines, since the user can not easily get
-            // the revision nor show the check-in comment tooltip when the first line of a large
-            // block with the same revision is already scrolled out of the viewport
-            // logInfo.m_author.clear();
-            // rev.clear();
-        } else {
-            oldRevision = rev;
-            odd = !odd;
-        }
+    const QString rev = line.left(startIdxC2).trimmed();
+    logInfo.m_author = authorDate.left(authorDate.indexOf(QLatin1Char(' '))).trimmed();
+    const QString content = line.mid(line.indexOf(QLatin1String("): "), startIdxC2 + 1) + 3);
+
+    logInfo.m_comment = comments[rev];
+
+    if (rev == oldRevision) {
+        // don't remove revision/author info on following lines, since the user can not easily get
+        // the revision nor show the check-in comment tooltip when the first line of a large
+        // block with the same revision is already scrolled out of the viewport
+        // logInfo.m_author.clear();
+        // rev.clear();
+    } else {
+        oldRevision = rev;
+        odd = !odd;
+    }
 
-        logInfo.m_revision = rev;
+    logInfo.m_revision = Cervisia::Revision(rev);
 
-        dialog->addLine(logInfo, content, odd);
-    }
+    dialog->addLine(logInfo, content, odd);
 }
@@ -19,19 +19,30 @@
 #ifndef ANNOTATECONTROLLER_H
 #define ANNOTATECONTROLLER_H
 
+#include <qobject.h>
 #include <qstring.h>
 
 class AnnotateDialog;
 class OrgKdeCervisia5CvsserviceCvsserviceInterface;
 
-class AnnotateController
+/**
+ * Runs cvs annotate and fills the dialog with the annotated lines as they
+ * arrive. The output starts with the log of the file, which provides the
+ * comments of the revisions.
+ */
+class AnnotateController : public QObject
 {
+    Q_OBJECT
+
 public:
     AnnotateController(AnnotateDialog *dialog, OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService);
     ~AnnotateController();
 
     void showDialog(const QString &fileName, const QString &revision = QString());
 
+private Q_SLOTS:
+    void parseLine(const QString &line);
+
 private:
     struct Private;
     Private *const d;
@@ -74,7 +74,7 @@ QVariant AnnotateViewItem::data(int column, int role) const
             if (m_logInfo.m_author.isNull())
                 return QString();
             else
-                return (m_logInfo.m_author + QChar(' ') + m_logInfo.m_revision);
+                return (m_logInfo.m_author + QChar(' ') + m_logInfo.m_revision.toString());
         case ContentColumn:
             return m_content;
         default:;
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "changesetindex.h"
+
+class ChangesetIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+    void testRegroup();
+    void testUpdate();
+    void testIncompleteUpdate();
+
+private:
+    void addLog(ChangesetIndex &index);
+};
+
+struct LogRevision {
+    const char *revision;
+    const char *time; // on 2003/06/02 (UTC)
+    const char *author;
+    const char *comment;
+};
+
+// the rlog output of a file of the module, newest revision first
+static QStringList fileLog(const QString &fileName, const QList<LogRevision> &revisions)
+{
+    QStringList lines;
+    lines << QLatin1String("RCS file: /cvsroot/module/") + fileName + QLatin1String(",v");
+    lines << "head: 1.1"
+          << "branch:"
+          << "locks: strict"
+          << "access list:"
+          << "symbolic names:"
+          << "keyword substitution: kv"
+          << "total revisions: 1;\tselected revisions: 1"
+          << "description:";
+    for (const LogRevision &revision : revisions) {
+        lines << "----------------------------";
+        lines << QLatin1String("revision ") + QLatin1String(revision.revision);
+        lines << QString("date: 2003/06/02 %1;  author: %2;  state: Exp;").arg(revision.time, revision.author);
+        lines << QLatin1String(revision.comment);
+    }
+    lines << "=============================================================================";
+    return lines;
+}
+
+static QDateTime commitTime(const char *time)
+{
+    return QDateTime(QDate(2003, 6, 2), QTime::fromString(time, "hh:mm:ss"), Qt::UTC);
+}
+
+void ChangesetIndexTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ChangesetIndexTest::init()
+{
+    // each test starts without an index file
+    QDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/changesets")).removeRecursively();
+}
+
+void ChangesetIndexTest::cleanupTestCase()
+{
+    init();
+}
+
+void ChangesetIndexTest::addLog(ChangesetIndex &index)
+{
+    QStringList lines;
+    lines << fileLog("src/a.cpp",
+                     {{"1.4", "12:21:00", "alice", "fix"},
+                      {"1.3", "12:20:00", "alice", "fix"},
+                      {"1.2", "12:01:00", "alice", "feature"},
+                      {"1.1", "10:00:00", "bob", "import"}});
+    lines << fileLog("src/b.cpp", {{"1.2", "12:03:00", "alice", "feature"}, {"1.1", "10:00:30", "bob", "import"}});
+    // removed files are in the Attic
+    lines << fileLog("doc/Attic/c.txt", {{"1.2", "12:10:00", "alice", "feature"}, {"1.1", "09:59:00", "carol", "import"}});
+
+    for (const QString &line : qAsConst(lines))
+        index.addLogLine(line);
+    QVERIFY(index.finishUpdate(true));
+}
+
+void ChangesetIndexTest::testRegroup()
+{
+    ChangesetIndex index("/cvsroot", "module");
+    QVERIFY(!index.load());
+    QVERIFY(!index.updateStart().isValid());
+
+    addLog(index);
+
+    QCOMPARE(index.revisionCount(), 8);
+    QCOMPARE(index.changesetCount(), 6);
+
+    // in the order of the commits
+    Cervisia::Changeset changeset = index.changeset(0);
+    QCOMPARE(changeset.m_author, QString("carol"));
+    QCOMPARE(changeset.m_files, QStringList({"doc/c.txt"}));
+
+    // same author and message within the window
+    changeset = index.changeset(1);
+    QCOMPARE(changeset.m_author, QString("bob"));
+    QCOMPARE(changeset.m_comment, QString("import"));
+    QCOMPARE(changeset.m_files, QStringList({"src/a.cpp", "src/b.cpp"}));
+    QCOMPARE(changeset.m_revisions, QStringList({"1.1", "1.1"}));
+    QCOMPARE(changeset.m_dateTime, commitTime("10:00:30"));
+
+    changeset = index.changeset(2);
+    QCOMPARE(changeset.m_files, QStringList({"src/a.cpp", "src/b.cpp"}));
+    QCOMPARE(changeset.m_revisions, QStringList({"1.2", "1.2"}));
+
+    // more than 300 seconds after the previous revision
+    changeset = index.changeset(3);
+    QCOMPARE(changeset.m_comment, QString("feature"));
+    QCOMPARE(changeset.m_files, QStringList({"doc/c.txt"}));
+
+    // a file can't be twice in a changeset
+    QCOMPARE(index.changeset(4).m_revisions, QStringList({"1.3"}));
+    QCOMPARE(index.changeset(5).m_revisions, QStringList({"1.4"}));
+
+    QCOMPARE(index.findChangeset("src/b.cpp", "1.2"), 2);
+    QCOMPARE(index.findChangeset("src/a.cpp", "1.4"), 5);
+    QCOMPARE(index.findChangeset("src/b.cpp", "1.3"), -1);
+    QCOMPARE(index.findChangeset("unknown", "1.1"), -1);
+    QVERIFY(index.changeset(6).m_files.isEmpty());
+
+    QCOMPARE(index.updateStart(), commitTime("12:21:00"));
+}
+
+void ChangesetIndexTest::testUpdate()
+{
+    {
+        ChangesetIndex index("/cvsroot", "module");
+        addLog(index);
+    }
+
+    ChangesetIndex index("/cvsroot", "module");
+    QVERIFY(index.load());
+    QCOMPARE(index.revisionCount(), 8);
+    QCOMPARE(index.changesetCount(), 6);
+
+    // the update starts with the newest second, its revisions come twice
+    const QStringList lines = fileLog("src/a.cpp", {{"1.5", "13:00:00", "alice", "more"}, {"1.4", "12:21:00", "alice", "fix"}});
+    for (const QString &line : lines)
+        index.addLogLine(line);
+    QVERIFY(index.finishUpdate(true));
+
+    QCOMPARE(index.revisionCount(), 9);
+    QCOMPARE(index.changesetCount(), 7);
+    QCOMPARE(index.findChangeset("src/a.cpp", "1.5"), 6);
+    QCOMPARE(index.findChangeset("src/a.cpp", "1.4"), 5);
+
+    // a different module has its own index
+    ChangesetIndex other("/cvsroot", "other");
+    QVERIFY(!other.load());
+}
+
+void ChangesetIndexTest::testIncompleteUpdate()
+{
+    {
+        ChangesetIndex index("/cvsroot", "module");
+        addLog(index);
+    }
+
+    ChangesetIndex index("/cvsroot", "module");
+    QVERIFY(index.load());
+
+    const QStringList lines = fileLog("src/a.cpp", {{"1.5", "13:00:00", "alice", "more"}});
+    for (const QString &line : lines)
+        index.addLogLine(line);
+    QVERIFY(!index.finishUpdate(false));
+
+    QCOMPARE(index.revisionCount(), 8);
+    QCOMPARE(index.findChangeset("src/a.cpp", "1.5"), -1);
+}
+
+QTEST_GUILESS_MAIN(ChangesetIndexTest)
+
+#include "changesetindextest.moc"
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QTest>
+
+#include "cvsservice/cvsrecords.h"
+
+using namespace CvsRecords;
+
+class CvsRecordsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testLogParser();
+    void testSeparatorInComment();
+    void testNoRevisions();
+    void testParseLog();
+};
+
+// the calls of the parser in the order they were made
+class LogRecorder : public LogParser
+{
+public:
+    QStringList calls;
+    QList<LogRecord> files;
+    QList<RevisionRecord> revisions;
+
+protected:
+    void revisionParsed(const LogRecord &file, const RevisionRecord &revision) override
+    {
+        calls << QLatin1String("revision ") + file.fileName + QLatin1Char(' ') + revision.revision;
+        revisions << revision;
+    }
+
+    void fileParsed(const LogRecord &file) override
+    {
+        calls << QLatin1String("file ") + file.fileName;
+        files << file;
+    }
+};
+
+static const QString LOG_SEPARATOR = QStringLiteral("----------------------------");
+static const QString LOG_END = QStringLiteral("=============================================================================");
+
+static QStringList fileHeader(const QString &fileName, const QStringList &tags)
+{
+    QStringList lines;
+    lines << QLatin1String("RCS file: /cvsroot/module/") + fileName + QLatin1String(",v");
+    lines << QLatin1String("Working file: ") + fileName;
+    lines << "head: 1.2"
+          << "branch:"
+          << "locks: strict"
+          << "access list:"
+          << "symbolic names:";
+    for (const QString &tag : tags)
+        lines << QLatin1Char('\t') + tag;
+    lines << "keyword substitution: kv"
+          << "total revisions: 2;\tselected revisions: 2"
+          << "description:";
+    return lines;
+}
+
+static void feed(LogParser &parser, const QStringList &lines)
+{
+    for (const QString &line : lines)
+        parser.parseLine(line);
+}
+
+void CvsRecordsTest::testLogParser()
+{
+    QStringList lines = fileHeader("a.cpp", {"RELEASE_1: 1.1", "STABLE: 1.2.0.4", "VENDOR: 1.1.1"});
+    lines << LOG_SEPARATOR << "revision 1.2"
+          << "date: 2003/06/02 12:34:56;  author: jdoe;  state: Exp;  lines: +2 -1"
+          << "first line"
+          << "second line" << LOG_SEPARATOR << "revision 1.1"
+          << "date: 2003/06/01 08:00:00;  author: alice;  state: Exp;"
+          << "branches:  1.1.1;"
+          << "initial" << LOG_END;
+    lines << fileHeader("b.cpp", {}) << LOG_SEPARATOR << "revision 1.1"
+          << "date: 2004-01-02 03:04:05 +0000;  author: bob;  state: Exp;  commitid: 1234;"
+          << "b" << LOG_END;
+
+    LogRecorder parser;
+    feed(parser, lines);
+
+    QCOMPARE(parser.calls, QStringList({"revision a.cpp 1.2", "revision a.cpp 1.1", "file a.cpp", "revision b.cpp 1.1", "file b.cpp"}));
+
+    QCOMPARE(parser.revisions.at(0).author, QString("jdoe"));
+    QCOMPARE(parser.revisions.at(0).dateTime, QDateTime(QDate(2003, 6, 2), QTime(12, 34, 56), Qt::UTC));
+    QCOMPARE(parser.revisions.at(0).comment, QString("first line\nsecond line"));
+    QCOMPARE(parser.revisions.at(1).author, QString("alice"));
+    QCOMPARE(parser.revisions.at(1).comment, QString("initial"));
+    QCOMPARE(parser.revisions.at(2).author, QString("bob"));
+    QCOMPARE(parser.revisions.at(2).dateTime, QDateTime(QDate(2004, 1, 2), QTime(3, 4, 5), Qt::UTC));
+
+    const QList<TagRecord> tags = parser.files.at(0).tags;
+    QCOMPARE(tags.count(), 3);
+    QCOMPARE(tags.at(0).name, QString("RELEASE_1"));
+    QCOMPARE(tags.at(0).revision, QString("1.1"));
+    QVERIFY(!tags.at(0).isBranch);
+    // the magic branch number is reported as the branch
+    QCOMPARE(tags.at(1).revision, QString("1.2.4"));
+    QVERIFY(tags.at(1).isBranch);
+    QVERIFY(tags.at(2).isBranch);
+    QVERIFY(parser.files.at(1).tags.isEmpty());
+}
+
+void CvsRecordsTest::testSeparatorInComment()
+{
+    QStringList lines = fileHeader("a.cpp", {});
+    lines << LOG_SEPARATOR << "revision 1.2"
+          << "date: 2003/06/02 12:34:56;  author: jdoe;  state: Exp;"
+          << "above" << LOG_SEPARATOR << "below" << LOG_SEPARATOR << "revision 1.1 is mentioned here" << "not a date"
+          << LOG_SEPARATOR << "revision 1.1"
+          << "date: 2003/06/01 08:00:00;  author: alice;  state: Exp;"
+          << "initial" << LOG_END;
+
+    LogRecorder parser;
+    feed(parser, lines);
+
+    QCOMPARE(parser.revisions.count(), 2);
+    QCOMPARE(parser.revisions.at(0).comment,
+             QString("above\n" + LOG_SEPARATOR + "\nbelow\n" + LOG_SEPARATOR + "\nrevision 1.1 is mentioned here\nnot a date"));
+    QCOMPARE(parser.revisions.at(1).revision, QString("1.1"));
+    QCOMPARE(parser.revisions.at(1).comment, QString("initial"));
+}
+
+void CvsRecordsTest::testNoRevisions()
+{
+    // e.g. log -d for a file without changes in that time
+    QStringList lines = fileHeader("a.cpp", {"RELEASE_1: 1.1"});
+    lines << LOG_END;
+
+    LogRecorder parser;
+    feed(parser, lines);
+
+    QCOMPARE(parser.calls, QStringList({"file a.cpp"}));
+    QCOMPARE(parser.files.at(0).tags.count(), 1);
+}
+
+void CvsRecordsTest::testParseLog()
+{
+    QStringList lines = fileHeader("a.cpp", {"RELEASE_1: 1.1"});
+    lines << LOG_SEPARATOR << "revision 1.2"
+          << "date: 2003/06/02 12:34:56;  author: jdoe;  state: Exp;"
+          << "change" << LOG_SEPARATOR << "revision 1.1"
+          << "date: 2003/06/01 08:00:00;  author: alice;  state: Exp;"
+          << "initial" << LOG_END;
+
+    const QList<LogRecord> records = read<LogRecord>(parse(Log, lines));
+
+    QCOMPARE(records.count(), 1);
+    QCOMPARE(records.at(0).fileName, QString("a.cpp"));
+    QCOMPARE(records.at(0).tags.count(), 1);
+    QCOMPARE(records.at(0).revisions.count(), 2);
+    QCOMPARE(records.at(0).revisions.at(0).comment, QString("change"));
+    QCOMPARE(records.at(0).revisions.at(1).author, QString("alice"));
+    QCOMPARE(records.at(0).revisions.at(1).dateTime, QDateTime(QDate(2003, 6, 1), QTime(8, 0), Qt::UTC));
+}
+
+QTEST_GUILESS_MAIN(CvsRecordsTest)
+
+#include "cvsrecordstest.moc"
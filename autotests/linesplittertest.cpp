@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QTest>
+
+#include "cvsservice/linesplitter.h"
+
+class LineSplitterTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSplit_data();
+    void testSplit();
+    void testFinish();
+    void testCompaction();
+    void testClear();
+};
+
+/**
+ * Feeds @p text to @p splitter in chunks of @p chunkSize characters and
+ * collects the lines which are complete after each chunk.
+ */
+static QStringList split(LineSplitter &splitter, const QString &text, int chunkSize)
+{
+    QStringList lines;
+    QStringView line;
+
+    for (int pos = 0; pos < text.size(); pos += chunkSize) {
+        splitter.append(text.mid(pos, chunkSize));
+        while (splitter.nextLine(&line))
+            lines << line.toString();
+    }
+
+    splitter.finish();
+    while (splitter.nextLine(&line))
+        lines << line.toString();
+
+    return lines;
+}
+
+void LineSplitterTest::testSplit_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("lines");
+
+    QTest::newRow("empty") << QString() << QStringList();
+    QTest::newRow("one line") << "M foo.cpp\n" << QStringList{"M foo.cpp"};
+    QTest::newRow("two lines") << "M foo.cpp\nU bar.cpp\n" << QStringList{"M foo.cpp", "U bar.cpp"};
+    QTest::newRow("empty lines") << "\n\na\n\n" << QStringList{"", "", "a", ""};
+    QTest::newRow("no trailing newline") << "a\nb" << QStringList{"a", "b"};
+    // only the newline ends a line, a CR may belong to the content of a file
+    QTest::newRow("CR/LF") << "a\r\nb\r\n" << QStringList{"a\r", "b\r"};
+    QTest::newRow("lone CR") << "a\rb\n" << QStringList{"a\rb"};
+}
+
+void LineSplitterTest::testSplit()
+{
+    QFETCH(QString, text);
+    QFETCH(QStringList, lines);
+
+    // every chunk boundary, including one in the middle of each line and
+    // between a CR and its newline
+    for (int chunkSize = 1; chunkSize <= qMax(1, int(text.size())); ++chunkSize) {
+        LineSplitter splitter;
+        QCOMPARE(split(splitter, text, chunkSize), lines);
+        QVERIFY(!splitter.hasPendingText());
+    }
+}
+
+void LineSplitterTest::testFinish()
+{
+    LineSplitter splitter;
+    QStringView line;
+
+    splitter.append(QStringLiteral("a\nincomplete"));
+    QVERIFY(splitter.nextLine(&line));
+    QCOMPARE(line.toString(), QStringLiteral("a"));
+
+    // the last line is held back until the text is finished
+    QVERIFY(!splitter.nextLine(&line));
+    QVERIFY(splitter.hasPendingText());
+
+    splitter.finish();
+    QVERIFY(splitter.nextLine(&line));
+    QCOMPARE(line.toString(), QStringLiteral("incomplete"));
+    QVERIFY(!splitter.nextLine(&line));
+    QVERIFY(!splitter.hasPendingText());
+
+    // a finished text which ends with a newline has no extra empty line
+    splitter.clear();
+    splitter.append(QStringLiteral("a\n"));
+    splitter.finish();
+    QVERIFY(splitter.nextLine(&line));
+    QCOMPARE(line.toString(), QStringLiteral("a"));
+    QVERIFY(!splitter.nextLine(&line));
+}
+
+void LineSplitterTest::testCompaction()
+{
+    LineSplitter splitter;
+    QStringView line;
+
+    // the consumed "aaaa\n" is the larger part of the buffer, so it is
+    // dropped by the next append() while "bb" has to survive
+    splitter.append(QStringLiteral("aaaa\nbb"));
+    QVERIFY(splitter.nextLine(&line));
+    QCOMPARE(line.toString(), QStringLiteral("aaaa"));
+    QVERIFY(!splitter.nextLine(&line));
+
+    splitter.append(QStringLiteral("b\nc"));
+    QVERIFY(splitter.nextLine(&line));
+    QCOMPARE(line.toString(), QStringLiteral("bbb"));
+    QVERIFY(!splitter.nextLine(&line));
+
+    // many lines of growing length, so that the buffer is compacted at
+    // different positions
+    QString text;
+    QStringList expected;
+    for (int i = 0; i < 200; ++i) {
+        expected << QString(i % 17, QLatin1Char('x')) + QString::number(i);
+        text += expected.last() + QLatin1Char('\n');
+    }
+
+    for (int chunkSize : {1, 3, 64, 1000}) {
+        splitter.clear();
+        QCOMPARE(split(splitter, text, chunkSize), expected);
+    }
+}
+
+void LineSplitterTest::testClear()
+{
+    LineSplitter splitter;
+    QStringView line;
+
+    splitter.append(QStringLiteral("a\nb"));
+    splitter.finish();
+    splitter.clear();
+    QVERIFY(!splitter.hasPendingText());
+    QVERIFY(!splitter.nextLine(&line));
+
+    // clear() also resets the end of the text
+    splitter.append(QStringLiteral("c"));
+    QVERIFY(!splitter.nextLine(&line));
+}
+
+QTEST_GUILESS_MAIN(LineSplitterTest)
+
+#include "linesplittertest.moc"
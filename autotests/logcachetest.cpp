@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "logcache.h"
+
+class LogCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+    void testLines();
+    void testMerge();
+    void testMergeMismatch();
+    void testSaveUnchanged();
+
+private:
+    void fillCache();
+};
+
+struct LogRevision {
+    const char *revision;
+    const char *date;
+    const char *author;
+    const char *comment;
+};
+
+static const QString LOG_SEPARATOR = QStringLiteral("----------------------------");
+static const QString LOG_END = QStringLiteral("=============================================================================");
+
+static const QStringList TAGS = {"RELEASE_1: 1.1", "STABLE: 1.2.0.4", "VENDOR: 1.1.1"};
+
+static const QList<LogRevision> REVISIONS = {{"1.2", "2003/06/02 12:00:00", "alice", "second\nline"}, {"1.1", "2003/06/01 08:00:00", "bob", "first"}};
+
+static QString cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/logs");
+}
+
+// the output of cvs log, without revisions for cvs log -h
+static QStringList fileLog(const QStringList &tags, int total, const QList<LogRevision> &revisions = QList<LogRevision>())
+{
+    QStringList lines;
+    lines << "RCS file: /cvsroot/module/a.cpp,v"
+          << "Working file: a.cpp"
+          << "head: 1.2"
+          << "branch:"
+          << "locks: strict"
+          << "access list:"
+          << "symbolic names:";
+    for (const QString &tag : tags)
+        lines << QLatin1Char('\t') + tag;
+    lines << "keyword substitution: kv";
+    lines << QString("total revisions: %1;\tselected revisions: %2").arg(total).arg(revisions.count());
+    lines << "description:";
+    for (const LogRevision &revision : revisions) {
+        lines << LOG_SEPARATOR;
+        lines << QLatin1String("revision ") + QLatin1String(revision.revision);
+        lines << QString("date: %1;  author: %2;  state: Exp;").arg(revision.date, revision.author);
+        lines << QString(revision.comment).split('\n');
+    }
+    lines << LOG_END;
+    return lines;
+}
+
+// the revisions of the log, newest first
+static QStringList revisions(const QStringList &lines)
+{
+    QStringList result;
+    for (const QString &line : lines) {
+        if (line.startsWith(QLatin1String("revision ")))
+            result << line.mid(9);
+    }
+    return result;
+}
+
+void LogCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void LogCacheTest::init()
+{
+    // each test starts without cached logs
+    QDir(cacheDir()).removeRecursively();
+}
+
+void LogCacheTest::cleanupTestCase()
+{
+    init();
+}
+
+void LogCacheTest::fillCache()
+{
+    LogCache cache("/cvsroot", "module", "a.cpp");
+    QVERIFY(!cache.load());
+
+    const QStringList lines = fileLog(TAGS, 2, REVISIONS);
+    for (const QString &line : lines)
+        cache.addLine(line);
+    QVERIFY(cache.save());
+}
+
+void LogCacheTest::testLines()
+{
+    fillCache();
+
+    LogCache cache("/cvsroot", "module", "a.cpp");
+    QVERIFY(cache.load());
+    QCOMPARE(cache.revisionCount(), 2);
+
+    // in the format of cvs log, with the magic branch numbers
+    QStringList expected;
+    expected << "Working file: a.cpp"
+             << "symbolic names:"
+             << "\tRELEASE_1: 1.1"
+             << "\tSTABLE: 1.2.0.4"
+             << "\tVENDOR: 1.1.1"
+             << "total revisions: 2;\tselected revisions: 2"
+             << "description:" << LOG_SEPARATOR << "revision 1.2"
+             << "date: 2003/06/02 12:00:00;  author: alice;"
+             << "second"
+             << "line" << LOG_SEPARATOR << "revision 1.1"
+             << "date: 2003/06/01 08:00:00;  author: bob;"
+             << "first" << LOG_END;
+    QCOMPARE(cache.lines(), expected);
+
+    // a different file has its own log
+    LogCache other("/cvsroot", "module", "b.cpp");
+    QVERIFY(!other.load());
+}
+
+void LogCacheTest::testMerge()
+{
+    fillCache();
+
+    {
+        LogCache cache("/cvsroot", "module", "a.cpp");
+        QVERIFY(cache.load());
+
+        QVERIFY(cache.setHeader(fileLog(TAGS + QStringList("NEW: 1.4"), 4)));
+        QVERIFY(!cache.isComplete());
+        QCOMPARE(cache.updateStart(), QDateTime(QDate(2003, 6, 2), QTime(12, 0), Qt::UTC));
+
+        // cvs log -d reports the revisions of the newest second again
+        QVERIFY(cache.merge(fileLog(TAGS, 4, {{"1.4", "2003/06/04 09:00:00", "alice", "fourth"}, {"1.3", "2003/06/03 09:00:00", "bob", "third"}, REVISIONS.first()})));
+        QVERIFY(cache.isComplete());
+        QCOMPARE(revisions(cache.lines()), QStringList({"1.4", "1.3", "1.2", "1.1"}));
+        QVERIFY(cache.save());
+    }
+
+    LogCache cache("/cvsroot", "module", "a.cpp");
+    QVERIFY(cache.load());
+    QCOMPARE(cache.revisionCount(), 4);
+    QVERIFY(cache.lines().contains("\tNEW: 1.4"));
+}
+
+void LogCacheTest::testMergeMismatch()
+{
+    fillCache();
+
+    LogCache cache("/cvsroot", "module", "a.cpp");
+    QVERIFY(cache.load());
+
+    // revisions were removed
+    QVERIFY(!cache.setHeader(fileLog(TAGS, 1)));
+
+    // a revision is missing, e.g. because of a wrong date
+    QVERIFY(cache.setHeader(fileLog(TAGS, 4)));
+    QVERIFY(!cache.merge(fileLog(TAGS, 4, {{"1.3", "2003/06/03 09:00:00", "bob", "third"}})));
+    QCOMPARE(cache.revisionCount(), 2);
+
+    // an incomplete log
+    QVERIFY(!cache.merge(QStringList(fileLog(TAGS, 4).first())));
+}
+
+void LogCacheTest::testSaveUnchanged()
+{
+    fillCache();
+
+    LogCache cache("/cvsroot", "module", "a.cpp");
+    QVERIFY(cache.load());
+    QVERIFY(cache.setHeader(fileLog(TAGS, 2)));
+    QVERIFY(cache.isComplete());
+
+    // nothing is written if the log didn't change
+    QDir(cacheDir()).removeRecursively();
+    QVERIFY(cache.save());
+    QVERIFY(!QDir(cacheDir()).exists());
+}
+
+QTEST_GUILESS_MAIN(LogCacheTest)
+
+#include "logcachetest.moc"
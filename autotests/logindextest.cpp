@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QTest>
+
+#include "logindex.h"
+#include "loginfo.h"
+
+using Cervisia::LogInfo;
+using Cervisia::TagInfo;
+
+class LogIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testQuery_data();
+    void testQuery();
+    void testInvalidQuery_data();
+    void testInvalidQuery();
+
+private:
+    LogIndex m_index;
+};
+
+static LogInfo revision(const QString &author, const QString &comment, const QDate &date, const LogInfo::TTagInfoSeq &tags = LogInfo::TTagInfoSeq())
+{
+    LogInfo logInfo;
+    logInfo.m_revision = Cervisia::Revision(QLatin1String("1.1"));
+    logInfo.m_author = author;
+    logInfo.m_comment = comment;
+    logInfo.m_dateTime = QDateTime(date, QTime(12, 0));
+    logInfo.m_tags = tags;
+    return logInfo;
+}
+
+// the rows which are set in @p bits
+static QList<int> rows(const QBitArray &bits)
+{
+    QList<int> result;
+    for (int row = 0; row < bits.size(); ++row) {
+        if (bits.testBit(row))
+            result << row;
+    }
+    return result;
+}
+
+void LogIndexTest::initTestCase()
+{
+    m_index.addRevision(revision("alice", "Fix crash in the parser", QDate(2003, 6, 2), {TagInfo("RELEASE_1", TagInfo::Tag)}));
+    m_index.addRevision(revision("bob", "Add parser tests", QDate(2003, 7, 15)));
+    m_index.addRevision(revision("alice", "Update the docs", QDate(2004, 1, 10), {TagInfo("STABLE", TagInfo::Branch)}));
+
+    QCOMPARE(m_index.count(), 3);
+}
+
+void LogIndexTest::testQuery_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QList<int>>("rows");
+
+    QTest::newRow("empty") << QString() << QList<int>{0, 1, 2};
+    QTest::newRow("comment word") << "parser" << QList<int>{0, 1};
+    QTest::newRow("prefix, case insensitive") << "PARS" << QList<int>{0, 1};
+    QTest::newRow("author without field") << "alice" << QList<int>{0, 2};
+    QTest::newRow("tag without field") << "stable" << QList<int>{2};
+    QTest::newRow("author") << "author:bob" << QList<int>{1};
+    QTest::newRow("author prefix") << "author:al" << QList<int>{0, 2};
+    QTest::newRow("tag") << "tag:release" << QList<int>{0};
+    QTest::newRow("comment") << "comment:tests" << QList<int>{1};
+    QTest::newRow("quoted words") << "\"crash in\"" << QList<int>{0};
+    QTest::newRow("tagged, not branched") << "is:tagged" << QList<int>{0};
+    QTest::newRow("and") << "parser alice" << QList<int>{0};
+    QTest::newRow("or") << "fix OR docs" << QList<int>{0, 2};
+    QTest::newRow("minus") << "parser -bob" << QList<int>{0};
+    QTest::newRow("not") << "NOT parser" << QList<int>{2};
+    QTest::newRow("parentheses") << "(fix OR add) author:bob" << QList<int>{1};
+    QTest::newRow("nested parentheses") << "NOT (author:bob OR (docs))" << QList<int>{0};
+    QTest::newRow("date year") << "date:2003" << QList<int>{0, 1};
+    QTest::newRow("date month") << "date:2003-07" << QList<int>{1};
+    QTest::newRow("date day") << "date:2004-01-10" << QList<int>{2};
+    QTest::newRow("after") << "after:2003-07" << QList<int>{1, 2};
+    QTest::newRow("before") << "before:2003-07-15" << QList<int>{0};
+    QTest::newRow("no match") << "author:carol" << QList<int>();
+}
+
+void LogIndexTest::testQuery()
+{
+    QFETCH(QString, query);
+    QFETCH(QList<int>, rows);
+
+    QString errorMessage;
+    const QBitArray result = m_index.query(query, &errorMessage);
+
+    QVERIFY2(errorMessage.isEmpty(), qPrintable(errorMessage));
+    QCOMPARE(result.size(), m_index.count());
+    QCOMPARE(::rows(result), rows);
+}
+
+void LogIndexTest::testInvalidQuery_data()
+{
+    QTest::addColumn<QString>("query");
+
+    QTest::newRow("missing )") << "(fix OR docs";
+    QTest::newRow("unexpected )") << "fix )";
+    QTest::newRow("NOT at the end") << "fix NOT";
+    QTest::newRow("invalid date") << "after:yesterday";
+    QTest::newRow("unknown field") << "size:10";
+    QTest::newRow("unknown condition") << "is:merged";
+}
+
+void LogIndexTest::testInvalidQuery()
+{
+    QFETCH(QString, query);
+
+    QString errorMessage;
+    const QBitArray result = m_index.query(query, &errorMessage);
+
+    QVERIFY(result.isNull());
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(LogIndexTest)
+
+#include "logindextest.moc"
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QDateTime>
+#include <QTest>
+
+#include "multilogmodel.h"
+
+class MultiLogModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testFinish();
+    void testSetFilter_data();
+    void testSetFilter();
+    void testFilterBeforeFinish();
+
+private:
+    MultiLogModel *m_model;
+};
+
+// noon (UTC), so the day is the same in every time zone the test runs in
+static QDateTime day(int month, int day)
+{
+    return QDateTime(QDate(2003, month, day), QTime(12, 0), Qt::UTC);
+}
+
+// "file revision" of each row
+static QStringList rows(const MultiLogModel &model)
+{
+    QStringList result;
+    for (int row = 0; row < model.rowCount(); ++row)
+        result << model.fileName(row) + QLatin1Char(' ') + model.revision(row);
+    return result;
+}
+
+void MultiLogModelTest::init()
+{
+    m_model = new MultiLogModel;
+    QVERIFY(m_model->open());
+
+    // in the order of rlog: the revisions of a file one after another
+    m_model->addRevision("src/a.cpp", "1.2", day(6, 10), "alice", "second\nchange");
+    m_model->addRevision("src/a.cpp", "1.1", day(6, 1), "bob", "first");
+    m_model->addRevision("doc/b.txt", "1.1", day(6, 5), "carol", "docs");
+    m_model->addRevision("src/c.cpp", "1.1", day(6, 10), "Alice", "new file");
+}
+
+void MultiLogModelTest::cleanup()
+{
+    delete m_model;
+}
+
+void MultiLogModelTest::testFinish()
+{
+    m_model->finish();
+
+    // newest first, the order of the log for the same date
+    QCOMPARE(rows(*m_model), QStringList({"src/a.cpp 1.2", "src/c.cpp 1.1", "doc/b.txt 1.1", "src/a.cpp 1.1"}));
+    QCOMPARE(m_model->revisionCount(), 4);
+    QCOMPARE(m_model->revisionCount("src/a.cpp"), 2);
+    QCOMPARE(m_model->revisionCount("doc/b.txt"), 1);
+    QCOMPARE(m_model->revisionCount("unknown"), 0);
+    QCOMPARE(m_model->comment(0), QString("second\nchange"));
+}
+
+void MultiLogModelTest::testSetFilter_data()
+{
+    QTest::addColumn<QString>("author");
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QDate>("from");
+    QTest::addColumn<QDate>("to");
+    QTest::addColumn<QStringList>("rows");
+
+    QTest::newRow("none") << QString() << QString() << QDate() << QDate()
+                          << QStringList({"src/a.cpp 1.2", "src/c.cpp 1.1", "doc/b.txt 1.1", "src/a.cpp 1.1"});
+    QTest::newRow("author prefix, case insensitive") << "ALI" << QString() << QDate() << QDate() << QStringList({"src/a.cpp 1.2", "src/c.cpp 1.1"});
+    QTest::newRow("path prefix") << QString() << "src/" << QDate() << QDate() << QStringList({"src/a.cpp 1.2", "src/c.cpp 1.1", "src/a.cpp 1.1"});
+    QTest::newRow("from") << QString() << QString() << QDate(2003, 6, 5) << QDate() << QStringList({"src/a.cpp 1.2", "src/c.cpp 1.1", "doc/b.txt 1.1"});
+    QTest::newRow("to") << QString() << QString() << QDate() << QDate(2003, 6, 5) << QStringList({"doc/b.txt 1.1", "src/a.cpp 1.1"});
+    QTest::newRow("one day") << QString() << QString() << QDate(2003, 6, 5) << QDate(2003, 6, 5) << QStringList({"doc/b.txt 1.1"});
+    QTest::newRow("from after to") << QString() << QString() << QDate(2003, 6, 6) << QDate(2003, 6, 4) << QStringList();
+    QTest::newRow("all conditions") << "alice" << "src/c" << QDate(2003, 6, 5) << QDate(2003, 6, 30) << QStringList({"src/c.cpp 1.1"});
+    QTest::newRow("no match") << "bob" << "doc/" << QDate() << QDate() << QStringList();
+}
+
+void MultiLogModelTest::testSetFilter()
+{
+    QFETCH(QString, author);
+    QFETCH(QString, path);
+    QFETCH(QDate, from);
+    QFETCH(QDate, to);
+    QFETCH(QStringList, rows);
+
+    m_model->finish();
+    m_model->setFilter(author, path, from, to);
+
+    QCOMPARE(::rows(*m_model), rows);
+    QCOMPARE(m_model->revisionCount(), 4);
+
+    // and back to all revisions
+    m_model->setFilter(QString(), QString(), QDate(), QDate());
+    QCOMPARE(m_model->rowCount(), 4);
+}
+
+void MultiLogModelTest::testFilterBeforeFinish()
+{
+    m_model->setFilter("bob", QString(), QDate(), QDate());
+    m_model->finish();
+
+    QCOMPARE(m_model->rowCount(), 4);
+}
+
+QTEST_GUILESS_MAIN(MultiLogModelTest)
+
+#include "multilogmodeltest.moc"
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <QHash>
+#include <QTest>
+
+#include "revision.h"
+
+using Cervisia::Revision;
+
+class RevisionTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testParse_data();
+    void testParse();
+    void testBranch_data();
+    void testBranch();
+    void testPredecessor_data();
+    void testPredecessor();
+    void testSuccessor_data();
+    void testSuccessor();
+    void testCompare_data();
+    void testCompare();
+    void testHash();
+};
+
+void RevisionTest::testParse_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QString>("result");
+
+    QTest::newRow("trunk") << "1.5" << 2 << "1.5";
+    QTest::newRow("on branch") << "1.2.4.3" << 4 << "1.2.4.3";
+    QTest::newRow("branch") << "1.2.4" << 3 << "1.2.4";
+    QTest::newRow("added") << "0" << 1 << "0";
+    QTest::newRow("large") << "1.123456789" << 2 << "1.123456789";
+    QTest::newRow("empty") << "" << 0 << "";
+    QTest::newRow("tag") << "HEAD" << 0 << "";
+    QTest::newRow("trailing dot") << "1." << 0 << "";
+    QTest::newRow("leading dot") << ".1" << 0 << "";
+    QTest::newRow("double dot") << "1..2" << 0 << "";
+    QTest::newRow("space") << "1.2 " << 0 << "";
+    QTest::newRow("overflow") << "1.1234567890" << 0 << "";
+}
+
+void RevisionTest::testParse()
+{
+    QFETCH(QString, text);
+    QFETCH(int, count);
+    QFETCH(QString, result);
+
+    const Revision revision(text);
+    QCOMPARE(revision.count(), count);
+    QCOMPARE(revision.isNull(), count == 0);
+    QCOMPARE(revision.toString(), result);
+}
+
+void RevisionTest::testBranch_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("onBranch");
+    QTest::addColumn<bool>("magicBranch");
+    QTest::addColumn<QString>("branch");
+    QTest::addColumn<QString>("branchpoint");
+
+    QTest::newRow("trunk") << "1.5" << false << false << "" << "";
+    QTest::newRow("on branch") << "1.2.4.3" << true << false << "1.2.4" << "1.2";
+    QTest::newRow("branch") << "1.2.4" << false << false << "1.2.4" << "1.2";
+    QTest::newRow("magic branch") << "1.2.0.4" << false << true << "1.2.4" << "1.2";
+    QTest::newRow("vendor branch") << "1.1.1" << false << false << "1.1.1" << "1.1";
+    QTest::newRow("on nested branch") << "1.2.4.3.2.1" << true << false << "1.2.4.3.2" << "1.2.4.3";
+    QTest::newRow("null") << "" << false << false << "" << "";
+}
+
+void RevisionTest::testBranch()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, onBranch);
+    QFETCH(bool, magicBranch);
+    QFETCH(QString, branch);
+    QFETCH(QString, branchpoint);
+
+    const Revision revision(text);
+    QCOMPARE(revision.isOnBranch(), onBranch);
+    QCOMPARE(revision.isMagicBranch(), magicBranch);
+    QCOMPARE(revision.branch().toString(), branch);
+    QCOMPARE(revision.branchpoint().toString(), branchpoint);
+}
+
+void RevisionTest::testPredecessor_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("predecessor");
+
+    QTest::newRow("trunk") << "1.5" << "1.4";
+    QTest::newRow("first") << "1.1" << "";
+    QTest::newRow("on branch") << "1.2.4.3" << "1.2.4.2";
+    QTest::newRow("first on branch") << "1.2.4.1" << "1.2";
+    QTest::newRow("branch") << "1.2.4" << "";
+    QTest::newRow("magic branch") << "1.2.0.4" << "";
+    QTest::newRow("null") << "" << "";
+}
+
+void RevisionTest::testPredecessor()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, predecessor);
+
+    QCOMPARE(Revision(text).predecessor().toString(), predecessor);
+}
+
+void RevisionTest::testSuccessor_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("successor");
+
+    QTest::newRow("trunk") << "1.5" << "1.6";
+    QTest::newRow("carry") << "1.9" << "1.10";
+    QTest::newRow("on branch") << "1.2.4.3" << "1.2.4.4";
+    QTest::newRow("branch") << "1.2.4" << "";
+    QTest::newRow("magic branch") << "1.2.0.4" << "";
+    QTest::newRow("null") << "" << "";
+}
+
+void RevisionTest::testSuccessor()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, successor);
+
+    QCOMPARE(Revision(text).successor().toString(), successor);
+}
+
+void RevisionTest::testCompare_data()
+{
+    QTest::addColumn<QString>("lhs");
+    QTest::addColumn<QString>("rhs");
+    QTest::addColumn<int>("result");
+
+    QTest::newRow("equal") << "1.5" << "1.5" << 0;
+    QTest::newRow("less") << "1.5" << "1.6" << -1;
+    QTest::newRow("greater") << "1.6" << "1.5" << 1;
+    QTest::newRow("numeric") << "1.9" << "1.10" << -1;
+    QTest::newRow("major") << "2.1" << "1.10" << 1;
+    QTest::newRow("more parts") << "1.2" << "1.2.4.1" << -1;
+    QTest::newRow("branch after trunk") << "1.2.4.1" << "1.3" << -1;
+    QTest::newRow("null") << "" << "1.1" << -1;
+    QTest::newRow("both null") << "" << "" << 0;
+}
+
+void RevisionTest::testCompare()
+{
+    QFETCH(QString, lhs);
+    QFETCH(QString, rhs);
+    QFETCH(int, result);
+
+    const Revision left(lhs);
+    const Revision right(rhs);
+    QCOMPARE(left.compare(right), result);
+    QCOMPARE(right.compare(left), -result);
+    QCOMPARE(left == right, result == 0);
+    QCOMPARE(left != right, result != 0);
+    QCOMPARE(left < right, result < 0);
+}
+
+void RevisionTest::testHash()
+{
+    QCOMPARE(qHash(Revision("1.2.4.3")), qHash(Revision("1.2.4.3")));
+    QCOMPARE(qHash(Revision("1.2.0.4").branch()), qHash(Revision("1.2.4")));
+
+    QHash<Revision, int> rows;
+    rows.insert(Revision("1.1"), 0);
+    rows.insert(Revision("1.2"), 1);
+    rows.insert(Revision("1.2.4.1"), 2);
+
+    QCOMPARE(rows.value(Revision("1.2"), -1), 1);
+    QCOMPARE(rows.value(Revision("1.2.4.1"), -1), 2);
+    QCOMPARE(rows.value(Revision("1.2.4"), -1), -1);
+    QCOMPARE(rows.value(Revision(), -1), -1);
+}
+
+QTEST_GUILESS_MAIN(RevisionTest)
+
+#include "revisiontest.moc"
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
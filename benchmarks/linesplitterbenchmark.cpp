@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Feeds generated cvs log output to LineSplitter in chunks, as the progress
+ * dialog receives it, and prints the time per character while the amount
+ * of text grows. With linear splitting the time per character stays the
+ * same, from the first megabytes up to the whole output.
+ *
+ * Usage: linesplitterbenchmark [megabytes of log] [characters per chunk]
+ */
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+
+#include "cvsservice/linesplitter.h"
+
+// default amount of log, like the rlog output of a large module
+static const qint64 DEFAULT_MEGABYTES = 1024;
+
+// default size of the chunks, about what KProcess reads at once
+static const int DEFAULT_CHUNK_SIZE = 4096;
+
+// number of files in the generated log, repeated until the amount is reached
+static const int LOG_FILES = 64;
+
+// number of reports while the log is split
+static const int REPORTS = 8;
+
+static const qint64 MEGABYTE = 1024 * 1024;
+
+// the log of one file with some revisions, as cvs log prints it
+static QString logOfFile(int number)
+{
+    QString text;
+    QTextStream stream(&text);
+    stream << "\nRCS file: /cvsroot/module/src/file" << number << ".cpp,v\n"
+           << "Working file: src/file" << number << ".cpp\n"
+           << "head: 1.12\nbranch:\nlocks: strict\naccess list:\n"
+           << "symbolic names:\n\tRELEASE_1_0: 1.8\n\tSTABLE: 1.8.0.2\n"
+           << "keyword substitution: kv\n"
+           << "total revisions: 12;\tselected revisions: 12\n"
+           << "description:\n";
+    for (int revision = 12; revision > 0; --revision) {
+        stream << "----------------------------\n"
+               << "revision 1." << revision << '\n'
+               << "date: 2004/03/0" << (revision % 9 + 1) << " 12:34:56;  author: joe;  state: Exp;  lines: +" << revision << " -" << revision / 2
+               << '\n'
+               << "Fix the handling of revision " << revision << " of file " << number << ".\n"
+               << "A second line of the comment.\n";
+    }
+    stream << "=============================================================================\n";
+    stream.flush();
+
+    return text;
+}
+
+// takes all complete lines, like ProgressDialog::processOutput()
+static qint64 takeLines(LineSplitter &splitter, qint64 *lines)
+{
+    qint64 characters = 0;
+    QStringView line;
+    while (splitter.nextLine(&line)) {
+        characters += line.size();
+        ++*lines;
+    }
+    return characters;
+}
+
+static void splitLog(QTextStream &out, qint64 total, int chunkSize)
+{
+    QString log;
+    for (int i = 0; i < LOG_FILES; ++i)
+        log += logOfFile(i);
+
+    // a chunk may wrap around the end of the log
+    chunkSize = qMin(chunkSize, int(log.size()));
+    const QString ring = log + log.left(chunkSize);
+
+    out << "cvs log in chunks of " << chunkSize << " characters\n"
+        << "      MB        ms   ns/char     lines\n";
+    out.flush();
+
+    LineSplitter splitter;
+    qint64 fed = 0;
+    qint64 lines = 0;
+    qint64 taken = 0;
+    qint64 nextReport = total / REPORTS;
+    int offset = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (fed < total) {
+        const int size = int(qMin<qint64>(chunkSize, total - fed));
+        splitter.append(ring.mid(offset, size));
+        offset = (offset + size) % int(log.size());
+        fed += size;
+
+        taken += takeLines(splitter, &lines);
+
+        if (fed >= nextReport || fed == total) {
+            const qint64 nsecs = timer.nsecsElapsed();
+            out << qSetFieldWidth(8) << fed / MEGABYTE << qSetFieldWidth(10) << nsecs / 1000000 << double(nsecs) / fed << lines << qSetFieldWidth(0)
+                << '\n';
+            out.flush();
+            nextReport += total / REPORTS;
+        }
+    }
+
+    splitter.finish();
+    taken += takeLines(splitter, &lines);
+
+    // the newlines aren't part of the lines
+    if (taken + lines < fed)
+        out << "lost " << fed - taken - lines << " characters\n";
+}
+
+// one line which only ends with the output, e.g. a binary file; each chunk
+// must not search the whole line again
+static qint64 splitLongLine(qint64 length, int chunkSize)
+{
+    const QString chunk(chunkSize, QLatin1Char('x'));
+
+    LineSplitter splitter;
+    qint64 lines = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (qint64 fed = 0; fed < length; fed += chunkSize) {
+        splitter.append(chunk);
+        takeLines(splitter, &lines);
+    }
+    splitter.finish();
+    takeLines(splitter, &lines);
+
+    return timer.nsecsElapsed();
+}
+
+int main(int argc, char **argv)
+{
+    const qint64 megabytes = (argc > 1) ? QByteArray(argv[1]).toLongLong() : DEFAULT_MEGABYTES;
+    const int chunkSize = (argc > 2) ? QByteArray(argv[2]).toInt() : DEFAULT_CHUNK_SIZE;
+
+    QTextStream out(stdout);
+    if (megabytes <= 0 || chunkSize <= 0) {
+        out << "Usage: linesplitterbenchmark [megabytes of log] [characters per chunk]\n";
+        return 1;
+    }
+
+    splitLog(out, megabytes * MEGABYTE, chunkSize);
+
+    // the line is kept in memory, so it gets a 16th of the log
+    out << "\none line in chunks of " << chunkSize << " characters\n"
+        << "      MB        ms   ns/char\n";
+    for (qint64 length = qMax<qint64>(1, megabytes / 256) * MEGABYTE; length <= qMax<qint64>(1, megabytes / 16) * MEGABYTE; length *= 2) {
+        const qint64 nsecs = splitLongLine(length, chunkSize);
+        out << qSetFieldWidth(8) << length / MEGABYTE << qSetFieldWidth(10) << nsecs / 1000000 << double(nsecs) / length << qSetFieldWidth(0) << '\n';
+        out.flush();
+    }
+
+    return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
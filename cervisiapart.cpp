@@ -20,9 +20,15 @@
 
 #include "cervisiapart.h"
 
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
 #include <QList>
+#include <QProcess>
 #include <QSplitter>
 #include <QStatusBar>
+#include <QUuid>
 #include <qlabel.h>
 #include <qmenu.h>
 #include <qmessagebox.h>
@@ -46,28 +52,32 @@
 #include <kshell.h>
 #include <kstandardaction.h>
 #include <ktoggleaction.h>
-#include <ktoolinvocation.h>
 #include <kxmlguifactory.h>
 
 #include "addignoremenu.h"
 #include "annotatecontroller.h"
 #include "annotatedialog.h"
+#include "cervisiasettings.h"
 #include "changelogdialog.h"
 #include "cvsinitdialog.h"
+#include "cvsservice/cvsservice.h"
 #include "cvsserviceinterface.h"
 #include "debug.h"
 #include "diffdialog.h"
 #include "editwithmenu.h"
 #include "globalignorelist.h"
 #include "historydialog.h"
+#include "jobstatisticsview.h"
 #include "logdialog.h"
 #include "mergedialog.h"
 #include "misc.h"
+#include "multilogdialog.h"
 #include "patchoptiondialog.h"
 #include "progressdialog.h"
 #include "protocolview.h"
 #include "repositorydialog.h"
 #include "resolvedialog.h"
+#include "revision.h"
 #include "settingsdialog.h"
 #include "updatedialog.h"
 #include "updateview.h"
@@ -77,16 +87,19 @@
 #include <repositoryinterface.h>
 
 #include "cervisia_version.h"
-#include "cvsjobinterface.h"
 
 using Cervisia::TagDialog;
 
 K_PLUGIN_CLASS_WITH_JSON(CervisiaPart, "cervisiapart.json")
 
+// time (in ms) the cvs service has to register on the bus
+static const int SERVICE_TIMEOUT = 30 * 1000;
+
 #include <cervisiapart.moc>
 
 CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVariantList & /*args*/)
     : KParts::ReadOnlyPart(parent)
+    , m_jobStatistics(0)
     , hasRunningJob(false)
     , opt_hideFiles(false)
     , opt_hideUpToDate(false)
@@ -100,6 +113,7 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
     , opt_doCVSEdit(false)
     , recent(0)
     , cvsService(0)
+    , m_localService(0)
     , m_statusBar(new KParts::StatusBarExtension(this))
     , m_browserExt(0)
     , filterLabel(0)
@@ -108,18 +122,33 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
     , m_addIgnoreAction(0)
     , m_currentIgnoreMenu(0)
     , m_jobType(Unknown)
+    , m_serviceReady(false)
+    , m_serviceWaitLoop(0)
+    , m_lastStartupPhase(0)
 {
+    m_startupTimer.start();
+
     setComponentName("cervisiapart", i18n("Cervisia"));
 
     m_browserExt = new CervisiaBrowserExtension(this);
 
-    // start the cvs D-Bus service
-    QString error;
-    if (KToolInvocation::startServiceByDesktopName("org.kde.cvsservice5", QStringList(), &error, &m_cvsServiceInterfaceName)) {
-        KMessageBox::error(0, i18n("Starting cvsservice failed with message: ") + error, "Cervisia");
-    } else
-        // create a reference to the service
+    // run the cvs service in our own process when requested. Its objects
+    // are registered on our connection, so the calls below don't leave the
+    // process. Only one instance per process is possible, further parts
+    // (e.g. in Konqueror) fall back to a separate service.
+    bool hasService = true;
+    if (CervisiaSettings::inProcessService() && !QDBusConnection::sessionBus().objectRegisteredAt("/CvsService")) {
+        m_localService = new CvsService(CvsService::InProcess);
+        m_cvsServiceInterfaceName = QDBusConnection::sessionBus().baseService();
+        m_serviceReady = true;
         cvsService = new OrgKdeCervisia5CvsserviceCvsserviceInterface(m_cvsServiceInterfaceName, "/CvsService", QDBusConnection::sessionBus(), this);
+    } else if (!startCvsService()) {
+        // start the cvs D-Bus service, it comes up while we build the UI.
+        // The reference to it is created when it announces its name.
+        hasService = false;
+        KMessageBox::error(0, i18n("Starting cvsservice failed."), "Cervisia");
+    }
+    traceStartup("service launch");
     // qCDebug(log_cervisia) << "m_cvsServiceInterfaceName:" << m_cvsServiceInterfaceName;
     // kdDebug(8050) << "cvsService->service():" << cvsService->service()<<endl;
     //  Create UI
@@ -128,7 +157,7 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
 
     // When we couldn't start the D-Bus service, we just display a QLabel with
     // an explanation
-    if (cvsService) {
+    if (hasService) {
         Qt::Orientation o = splitHorz ? Qt::Vertical : Qt::Horizontal;
         splitter = new QSplitter(o, parentWidget);
         // avoid PartManager's warning that Part's window can't handle focus
@@ -141,9 +170,12 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
         connect(update, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(popupRequested(QPoint)));
 
         connect(update, SIGNAL(fileOpened(QString)), this, SLOT(openFile(QString)));
+        // the name is still empty when the service is starting
         protocol = new ProtocolView(m_cvsServiceInterfaceName, splitter);
         protocol->setFocusPolicy(Qt::StrongFocus);
 
+        // the job statistics view is created when it is shown the first time
+
         setWidget(splitter);
     } else {
         setWidget(new QLabel(i18n("This KPart is non-functional, because the "
@@ -151,10 +183,26 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
                              parentWidget));
     }
 
-    if (cvsService) {
+    traceStartup("widgets");
+
+    if (hasService) {
         setupActions();
+        traceStartup("actions");
+
+        // the actions are enabled when the service is ready
+        if (!m_serviceReady) {
+            const QList<QAction *> actions = actionCollection()->actions();
+            for (QAction *action : actions) {
+                if (action->isEnabled()) {
+                    action->setEnabled(false);
+                    m_serviceActions.append(action);
+                }
+            }
+        }
+
         readSettings();
         connect(update, SIGNAL(itemSelectionChanged()), this, SLOT(updateActions()));
+        traceStartup("settings");
     }
 
     setXMLFile("cervisiaui.rc");
@@ -164,12 +212,109 @@ CervisiaPart::CervisiaPart(QWidget *parentWidget, QObject *parent, const QVarian
 
 CervisiaPart::~CervisiaPart()
 {
-    // stop the cvs DCOP service and delete reference
-    if (cvsService) {
+    // the settings exist only when the UI was built
+    if (recent)
         writeSettings();
+
+    // stop the cvs DCOP service and delete reference. A service that didn't
+    // announce itself yet quits when we leave the bus.
+    if (cvsService) {
         cvsService->quit();
         delete cvsService;
     }
+    delete m_localService;
+}
+
+bool CervisiaPart::startCvsService()
+{
+    // each instance of the service registers a different name
+    // (KDBusService::Multiple), which it announces with this id
+    m_serviceStartupId = QUuid::createUuid().toString();
+
+    QDBusConnection::sessionBus().connect(QString(),
+                                          "/CvsService",
+                                          "org.kde.cervisia5.cvsservice.cvsservice",
+                                          "serviceStarted",
+                                          this,
+                                          SLOT(slotServiceStarted(QString, QString)));
+
+    const QStringList args = {QStringLiteral("--client"),
+                              QDBusConnection::sessionBus().baseService(),
+                              QStringLiteral("--startup-id"),
+                              m_serviceStartupId};
+    if (!QProcess::startDetached(QStringLiteral("cvsservice5"), args)) {
+        stopWaitingForService();
+        return false;
+    }
+
+    QTimer::singleShot(SERVICE_TIMEOUT, this, SLOT(slotServiceTimeout()));
+
+    return true;
+}
+
+void CervisiaPart::stopWaitingForService()
+{
+    QDBusConnection::sessionBus().disconnect(QString(),
+                                             "/CvsService",
+                                             "org.kde.cervisia5.cvsservice.cvsservice",
+                                             "serviceStarted",
+                                             this,
+                                             SLOT(slotServiceStarted(QString, QString)));
+    m_serviceStartupId.clear();
+
+    if (m_serviceWaitLoop)
+        m_serviceWaitLoop->quit();
+}
+
+bool CervisiaPart::waitForService()
+{
+    // keep the bus running, but not the user input, until the service
+    // announced itself or the timeout hit
+    if (!m_serviceReady && !m_serviceStartupId.isEmpty()) {
+        QEventLoop loop;
+        m_serviceWaitLoop = &loop;
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+        m_serviceWaitLoop = 0;
+    }
+
+    return m_serviceReady;
+}
+
+void CervisiaPart::slotServiceStarted(const QString &startupId, const QString &serviceName)
+{
+    // the services of other parts announce themselves, too
+    if (m_serviceStartupId.isEmpty() || startupId != m_serviceStartupId)
+        return;
+
+    m_cvsServiceInterfaceName = serviceName;
+    m_serviceReady = true;
+    stopWaitingForService();
+    traceStartup("service ready");
+
+    // create a reference to the service
+    cvsService = new OrgKdeCervisia5CvsserviceCvsserviceInterface(m_cvsServiceInterfaceName, "/CvsService", QDBusConnection::sessionBus(), this);
+    protocol->setAppId(m_cvsServiceInterfaceName);
+
+    for (QAction *action : qAsConst(m_serviceActions))
+        action->setEnabled(true);
+    m_serviceActions.clear();
+    updateActions();
+}
+
+void CervisiaPart::slotServiceTimeout()
+{
+    if (m_serviceReady || m_serviceStartupId.isEmpty())
+        return;
+
+    stopWaitingForService();
+    KMessageBox::error(widget(), i18n("The cvs D-Bus service did not start."), "Cervisia");
+}
+
+void CervisiaPart::traceStartup(const char *phase)
+{
+    const qint64 now = m_startupTimer.elapsed();
+    qCDebug(log_cervisia) << "startup:" << phase << now - m_lastStartupPhase << "ms, total" << now << "ms";
+    m_lastStartupPhase = now;
 }
 
 KConfig *CervisiaPart::config()
@@ -202,6 +347,10 @@ bool CervisiaPart::openUrl(const QUrl &u)
     // KRecentFilesAction::addUrl() makes the URL invalid
     const QUrl deepCopy(u);
 
+    // the service may still be starting
+    if (!waitForService())
+        return false;
+
     return openSandbox(deepCopy);
 }
 
@@ -338,11 +487,13 @@ void CervisiaPart::setupActions()
     action->setToolTip(hint);
     action->setWhatsThis(hint);
 
-#if 0
-    action = new QAction( i18n("Browse Multi-File Log..."), 0,
-                          this, SLOT(slotBrowseMultiLog()),
-                          actionCollection() );
-#endif
+    action = new QAction(i18n("Browse &Multi-File Log..."), this);
+    actionCollection()->addAction("view_multilog", action);
+    connect(action, SIGNAL(triggered(bool)), SLOT(slotBrowseMultiLog()));
+    hint = i18n("Shows the revisions of all files in the selected folder, newest first");
+    action->setToolTip(hint);
+    action->setWhatsThis(hint);
+
     action = new QAction(i18n("&Annotate..."), this);
     actionCollection()->addAction("view_annotate", action);
     connect(action, SIGNAL(triggered(bool)), SLOT(slotAnnotate()));
@@ -381,6 +532,13 @@ void CervisiaPart::setupActions()
     action->setToolTip(hint);
     action->setWhatsThis(hint);
 
+    action = new KToggleAction(i18n("Show Job &Statistics"), this);
+    actionCollection()->addAction("view_job_statistics", action);
+    connect(action, SIGNAL(triggered(bool)), SLOT(slotJobStatistics()));
+    hint = i18n("Shows how long the cvs jobs took, grouped by command");
+    action->setToolTip(hint);
+    action->setWhatsThis(hint);
+
     action = new QAction(i18n("&Unfold File Tree"), this);
     actionCollection()->addAction("view_unfold_tree", action);
     connect(action, SIGNAL(triggered(bool)), SLOT(slotUnfoldTree()));
@@ -692,6 +850,10 @@ void CervisiaPart::popupRequested(const QPoint &p)
 
 void CervisiaPart::updateActions()
 {
+    // the actions stay disabled until the service is ready
+    if (!m_serviceReady)
+        return;
+
     bool hassandbox = !sandbox.isEmpty();
     stateChanged("has_sandbox", hassandbox ? StateNoReverse : StateReverse);
 
@@ -836,18 +998,12 @@ void CervisiaPart::slotStatus()
 
     QDBusReply<QDBusObjectPath> cvsJobPath = cvsService->simulateUpdate(list, opt_updateRecursive, opt_createDirs, opt_pruneDirs);
 
-    // get command line from cvs job
     QString cmdline;
     QDBusObjectPath cvsJob = cvsJobPath;
     if (cvsJob.path().isEmpty())
         return;
 
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob(true)) {
+    if (protocol->startJob(true, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(receivedLine(QString)), update, SLOT(processUpdateLine(QString)));
         connect(protocol, SIGNAL(jobFinished(bool, int)), update, SLOT(finishJob(bool, int)));
@@ -918,10 +1074,16 @@ void CervisiaPart::slotCommit()
 
     if (dlg.exec()) {
         // get new list of files
+        const QStringList selection = list;
         list = dlg.fileList();
         if (list.isEmpty())
             return;
 
+        // send directories instead of their content when possible
+        bool recursive = opt_commitRecursive;
+        if (list == selection)
+            list = update->minimalSelection(&recursive);
+
         QString msg = dlg.logMessage();
         if (!recentCommits.contains(msg)) {
             recentCommits.prepend(msg);
@@ -932,22 +1094,17 @@ void CervisiaPart::slotCommit()
             conf.writeEntry(sandbox, recentCommits);
         }
 
-        update->prepareJob(opt_commitRecursive, UpdateView::Commit);
+        update->prepareJob(recursive, UpdateView::Commit);
 
-        QDBusReply<QDBusObjectPath> cvsJobPath = cvsService->commit(list, dlg.logMessage(), opt_commitRecursive);
+        QDBusReply<QDBusObjectPath> cvsJobPath = cvsService->commit(list, dlg.logMessage(), recursive);
         QString cmdline;
         QDBusObjectPath cvsJob = cvsJobPath;
         qCDebug(log_cervisia) << " commit: cvsJob.path():" << cvsJob.path();
-        qCDebug(log_cervisia) << " list:" << list << "dlg.logMessage():" << dlg.logMessage() << "opt_commitRecursive" << opt_commitRecursive;
+        qCDebug(log_cervisia) << " list:" << list << "dlg.logMessage():" << dlg.logMessage() << "recursive" << recursive;
         if (cvsJob.path().isEmpty())
             return;
 
-        OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-        QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-        if (reply.isValid())
-            cmdline = reply;
-
-        if (protocol->startJob()) {
+        if (protocol->startJob(false, &cmdline)) {
             m_jobType = Commit;
             showJobStart(cmdline);
             connect(protocol, SIGNAL(jobFinished(bool, int)), update, SLOT(finishJob(bool, int)));
@@ -996,18 +1153,11 @@ void CervisiaPart::updateSandbox(const QString &extraopt)
 
     QDBusReply<QDBusObjectPath> cvsJobPath = cvsService->update(list, opt_updateRecursive, opt_createDirs, opt_pruneDirs, extraopt);
 
-    // get command line from cvs job
     QString cmdline;
     QDBusObjectPath cvsJob = cvsJobPath;
     if (cvsJob.path().isEmpty())
         return;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob(true)) {
+    if (protocol->startJob(true, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(receivedLine(QString)), update, SLOT(processUpdateLine(QString)));
         connect(protocol, SIGNAL(jobFinished(bool, int)), update, SLOT(finishJob(bool, int)));
@@ -1045,19 +1195,12 @@ void CervisiaPart::addOrRemove(AddRemoveDialog::ActionType action)
             break;
         }
 
-        // get command line from cvs job
         QString cmdline;
         QDBusObjectPath cvsJobPath = cvsJob;
         if (cvsJobPath.path().isEmpty())
             return;
 
-        OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJobPath.path(), QDBusConnection::sessionBus(), this);
-        QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-        if (reply.isValid())
-            cmdline = reply;
-
-        if (protocol->startJob()) {
+        if (protocol->startJob(false, &cmdline)) {
             showJobStart(cmdline);
             connect(protocol, SIGNAL(jobFinished(bool, int)), update, SLOT(finishJob(bool, int)));
             connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
@@ -1080,6 +1223,35 @@ void CervisiaPart::slotBrowseLog()
         delete l;
 }
 
+void CervisiaPart::slotBrowseMultiLog()
+{
+    // the selected folder, the folder of the selected file or the
+    // whole working copy
+    QString directory;
+    const QStringList selection = update->multipleSelection();
+    if (selection.count() == 1) {
+        directory = selection.first();
+        if (!QFileInfo(QDir(sandbox), directory).isDir())
+            directory = QFileInfo(directory).path();
+    }
+    if (directory == QLatin1String("."))
+        directory.clear();
+
+    QFile file(QDir(sandbox).filePath(directory.isEmpty() ? QString("CVS/Repository") : directory + "/CVS/Repository"));
+    const QString module = file.open(QIODevice::ReadOnly) ? QString::fromLocal8Bit(file.readLine()).trimmed() : QString();
+    if (module.isEmpty()) {
+        KMessageBox::error(widget(), i18n("The folder %1 is not in the repository.", directory.isEmpty() ? sandbox : directory), "Cervisia");
+        return;
+    }
+
+    // Non-modal dialog
+    auto l = new MultiLogDialog(*CervisiaPart::config());
+    if (l->parseCvsLog(cvsService, repository, module, directory))
+        l->show();
+    else
+        delete l;
+}
+
 void CervisiaPart::slotAnnotate()
 {
     QString filename, revision;
@@ -1135,13 +1307,7 @@ void CervisiaPart::addOrRemoveWatch(WatchDialog::ActionType action)
         if (cvsJobPath.path().isEmpty())
             return;
 
-        OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJobPath.path(), QDBusConnection::sessionBus(), this);
-        QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-        if (reply.isValid())
-            cmdline = reply;
-
-        if (protocol->startJob()) {
+        if (protocol->startJob(false, &cmdline)) {
             showJobStart(cmdline);
             connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
         }
@@ -1175,13 +1341,7 @@ void CervisiaPart::slotEdit()
     if (cvsJob.path().isEmpty())
         return;
 
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1200,13 +1360,7 @@ void CervisiaPart::slotUnedit()
     if (cvsJobPath.path().isEmpty())
         return;
 
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJobPath.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1223,13 +1377,7 @@ void CervisiaPart::slotLock()
     if (cvsJob.path().isEmpty())
         return;
     QString cmdline;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1247,13 +1395,7 @@ void CervisiaPart::slotUnlock()
         return;
 
     QString cmdline;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1271,13 +1413,7 @@ void CervisiaPart::slotShowEditors()
         return;
 
     QString cmdline;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1343,13 +1479,7 @@ void CervisiaPart::slotImport()
     ////qDebug()<<" cvsJob.path() :"<<cvsJob.path()<<endl;
     if (cvsJob.path().isEmpty())
         return;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1367,13 +1497,7 @@ void CervisiaPart::slotCreateRepository()
     QString cmdline;
     if (cvsJob.path().isEmpty())
         return;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1391,13 +1515,7 @@ void CervisiaPart::slotCheckout()
             ->checkout(dlg.workingDirectory(), dlg.repository(), dlg.module(), dlg.branch(), opt_pruneDirs, dlg.alias(), dlg.exportOnly(), dlg.recursive());
     QDBusObjectPath cvsJob = cvsJobPath;
     QString cmdline;
-    OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJob.path(), QDBusConnection::sessionBus(), this);
-    QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-    if (reply.isValid())
-        cmdline = reply;
-
-    if (protocol->startJob()) {
+    if (protocol->startJob(false, &cmdline)) {
         showJobStart(cmdline);
         connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
     }
@@ -1430,19 +1548,17 @@ void CervisiaPart::createOrDeleteTag(TagDialog::ActionType action)
     if (dlg.exec()) {
         QDBusReply<QDBusObjectPath> cvsJob;
 
+        // cvs tag is always recursive
+        bool recursive = true;
+        list = update->minimalSelection(&recursive, false);
+
         if (action == TagDialog::Create)
             cvsJob = cvsService->createTag(list, dlg.tag(), dlg.branchTag(), dlg.forceTag());
         else
             cvsJob = cvsService->deleteTag(list, dlg.tag(), dlg.branchTag(), dlg.forceTag());
         QDBusObjectPath cvsJobPath = cvsJob;
         QString cmdline;
-        OrgKdeCervisia5CvsserviceCvsjobInterface cvsjobinterface(m_cvsServiceInterfaceName, cvsJobPath.path(), QDBusConnection::sessionBus(), this);
-        QDBusReply<QString> reply = cvsjobinterface.cvsCommand();
-
-        if (reply.isValid())
-            cmdline = reply;
-
-        if (protocol->startJob()) {
+        if (protocol->startJob(false, &cmdline)) {
             showJobStart(cmdline);
             connect(protocol, SIGNAL(jobFinished(bool, int)), this, SLOT(slotJobFinished()));
         }
@@ -1451,27 +1567,26 @@ void CervisiaPart::createOrDeleteTag(TagDialog::ActionType action)
 
 void CervisiaPart::slotLastChange()
 {
-    QString filename, revA, revB;
-    update->getSingleSelection(&filename, &revA);
+    QString filename, revision;
+    update->getSingleSelection(&filename, &revision);
     if (filename.isEmpty())
         return;
 
-    int pos, lastnumber = 0;
-    bool ok;
-    if ((pos = revA.lastIndexOf('.')) == -1 || (lastnumber = revA.right(revA.length() - pos - 1).toUInt(&ok), !ok)) {
+    const Cervisia::Revision revA(revision);
+    if (revA.count() < 2) {
         KMessageBox::error(widget(), i18n("The revision looks invalid."), "Cervisia");
         return;
     }
-    if (lastnumber == 0) {
+    // the first revision on a branch is compared with its branchpoint
+    const Cervisia::Revision revB(revA.predecessor());
+    if (revB.isNull()) {
         KMessageBox::error(widget(), i18n("This is the first revision of the branch."), "Cervisia");
         return;
     }
-    revB = revA.left(pos + 1);
-    revB += QString::number(lastnumber - 1);
 
     // Non-modal dialog
     auto l = new DiffDialog(*config());
-    if (l->parseCvsDiff(cvsService, filename, revB, revA))
+    if (l->parseCvsDiff(cvsService, filename, revB.toString(), revA.toString()))
         l->show();
     else
         delete l;
@@ -1487,6 +1602,16 @@ void CervisiaPart::slotHistory()
         delete l;
 }
 
+void CervisiaPart::slotJobStatistics()
+{
+    if (!m_jobStatistics) {
+        m_jobStatistics = new JobStatisticsView(m_cvsServiceInterfaceName, splitter);
+        m_jobStatistics->hide();
+    }
+
+    m_jobStatistics->setVisible(!m_jobStatistics->isVisible());
+}
+
 void CervisiaPart::slotHideFiles()
 {
     opt_hideFiles = !opt_hideFiles;
@@ -25,6 +25,8 @@
 #include <kparts/part.h>
 #include <kparts/statusbarextension.h>
 
+#include <QElapsedTimer>
+
 #include "addremovedialog.h"
 #include "checkoutdialog.h"
 #include "commitdialog.h"
@@ -36,13 +38,16 @@ namespace Cervisia
 class AddIgnoreMenu;
 class EditWithMenu;
 }
+class QEventLoop;
 class QLabel;
 class QSplitter;
 class UpdateView;
 class ProtocolView;
+class JobStatisticsView;
 class KAboutData;
 class KRecentFilesAction;
 class OrgKdeCervisia5CvsserviceCvsserviceInterface;
+class CvsService;
 class CervisiaBrowserExtension;
 
 /**
@@ -94,12 +99,13 @@ public Q_SLOTS:
     void slotFileProperties();
     void slotRevert();
     void slotBrowseLog();
-    //    void slotBrowseMultiLog();
+    void slotBrowseMultiLog();
     void slotAnnotate();
     void slotDiffBase();
     void slotDiffHead();
     void slotLastChange();
     void slotHistory();
+    void slotJobStatistics();
     void slotCreateRepository();
     void slotCheckout();
     void slotImport();
@@ -144,6 +150,8 @@ private Q_SLOTS:
     // called by menu action "Open Sandbox..."
     void slotOpenSandbox();
     void slotSetupStatusBar();
+    void slotServiceStarted(const QString &startupId, const QString &serviceName);
+    void slotServiceTimeout();
 
 protected:
     void guiActivateEvent(KParts::GUIActivateEvent *event) override;
@@ -151,7 +159,11 @@ protected:
 private:
     enum JobType { Unknown, Commit };
 
+    bool startCvsService();
+    void stopWaitingForService();
+    bool waitForService();
     void setupActions();
+    void traceStartup(const char *phase);
 
     void readSettings();
     void writeSettings();
@@ -167,6 +179,7 @@ private:
 
     UpdateView *update;
     ProtocolView *protocol;
+    JobStatisticsView *m_jobStatistics;
     bool hasRunningJob;
     QSplitter *splitter;
 
@@ -183,6 +196,7 @@ private:
     KRecentFilesAction *recent;
 
     OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    CvsService *m_localService; // in-process cvs service (or null)
     KParts::StatusBarExtension *m_statusBar;
     CervisiaBrowserExtension *m_browserExt;
     QLabel *filterLabel;
@@ -193,6 +207,15 @@ private:
     Cervisia::AddIgnoreMenu *m_currentIgnoreMenu;
     JobType m_jobType;
     QString m_cvsServiceInterfaceName;
+
+    // the cvs service is started in the background
+    QString m_serviceStartupId; // announced back by the service
+    bool m_serviceReady;
+    QList<QAction *> m_serviceActions; // enabled when the service is ready
+    QEventLoop *m_serviceWaitLoop; // openUrl() waits here for the service
+
+    QElapsedTimer m_startupTimer;
+    qint64 m_lastStartupPhase;
 };
 
 /**
@@ -0,0 +1,322 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "changesetdialog.h"
+
+#include <QDialogButtonBox>
+#include <QFile>
+#include <QGridLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLocale>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTextCursor>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KGuiItem>
+#include <KHelpClient>
+#include <KLocalizedString>
+#include <KMessageBox>
+
+#include "cervisiasettings.h"
+#include "changesetindex.h"
+#include "cvsjobinterface.h"
+#include "cvsservice/cvsjob.h"
+#include "cvsserviceinterface.h"
+#include "diffdialog.h"
+#include "progressdialog.h"
+#include "repositoryinterface.h"
+#include "revision.h"
+
+namespace
+{
+enum { FileColumn, RevisionColumn, PreviousColumn };
+
+// 1.5 => 1.4, 1.2.2.1 => 1.2 and 1.1 => nothing
+QString previousRevision(const QString &revision)
+{
+    return Cervisia::Revision(revision).predecessor().toString();
+}
+}
+
+ChangesetDialog::ChangesetDialog(KConfig &cfg, QWidget *parent)
+    : QDialog(parent)
+    , index(0)
+    , current(-1)
+    , cvsService(0)
+    , partConfig(cfg)
+{
+    auto mainLayout = new QVBoxLayout;
+    setLayout(mainLayout);
+
+    auto grid = new QGridLayout;
+    mainLayout->addLayout(grid);
+    grid->setColumnStretch(1, 1);
+    grid->setColumnStretch(3, 1);
+
+    grid->addWidget(new QLabel(i18n("Author:")), 0, 0);
+    authorbox = new QLabel;
+    authorbox->setFrameStyle(QFrame::Panel | QFrame::Sunken);
+    authorbox->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    grid->addWidget(authorbox, 0, 1);
+
+    grid->addWidget(new QLabel(i18n("Date:")), 0, 2);
+    datebox = new QLabel;
+    datebox->setFrameStyle(QFrame::Panel | QFrame::Sunken);
+    datebox->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    grid->addWidget(datebox, 0, 3);
+
+    grid->addWidget(new QLabel(i18n("Comment:")), 1, 0, Qt::AlignTop);
+    commentbox = new QPlainTextEdit;
+    commentbox->setReadOnly(true);
+    commentbox->setMaximumHeight(5 * commentbox->fontMetrics().lineSpacing() + 10);
+    grid->addWidget(commentbox, 1, 1, 1, 3);
+
+    splitter = new QSplitter(Qt::Vertical);
+    mainLayout->addWidget(splitter, 1);
+
+    filelist = new QTreeWidget;
+    filelist->setRootIsDecorated(false);
+    filelist->setAllColumnsShowFocus(true);
+    filelist->setHeaderLabels(QStringList() << i18n("File") << i18n("Revision") << i18n("Previous"));
+    filelist->setWhatsThis(i18n("Double-click a file to show its changes in a separate window."));
+    connect(filelist, SIGNAL(itemActivated(QTreeWidgetItem *, int)), this, SLOT(fileActivated(QTreeWidgetItem *)));
+    splitter->addWidget(filelist);
+
+    diffbox = new QPlainTextEdit;
+    diffbox->setReadOnly(true);
+    diffbox->setLineWrapMode(QPlainTextEdit::NoWrap);
+    diffbox->setFont(CervisiaSettings::diffFont());
+    splitter->addWidget(diffbox);
+    splitter->setStretchFactor(1, 1);
+
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Help | QDialogButtonBox::Close);
+
+    olderButton = new QPushButton;
+    KGuiItem::assign(olderButton, KGuiItem(i18n("&Older")));
+    buttonBox->addButton(olderButton, QDialogButtonBox::ActionRole);
+
+    newerButton = new QPushButton;
+    KGuiItem::assign(newerButton, KGuiItem(i18n("&Newer")));
+    buttonBox->addButton(newerButton, QDialogButtonBox::ActionRole);
+
+    diffButton = new QPushButton;
+    KGuiItem::assign(diffButton, KGuiItem(i18n("&Diff")));
+    buttonBox->addButton(diffButton, QDialogButtonBox::ActionRole);
+
+    diffAllButton = new QPushButton;
+    KGuiItem::assign(diffAllButton, KGuiItem(i18n("Diff &All")));
+    buttonBox->addButton(diffAllButton, QDialogButtonBox::ActionRole);
+
+    connect(olderButton, SIGNAL(clicked()), this, SLOT(olderClicked()));
+    connect(newerButton, SIGNAL(clicked()), this, SLOT(newerClicked()));
+    connect(diffButton, SIGNAL(clicked()), this, SLOT(diffClicked()));
+    connect(diffAllButton, SIGNAL(clicked()), this, SLOT(diffAllClicked()));
+    connect(buttonBox, &QDialogButtonBox::helpRequested, this, &ChangesetDialog::slotHelp);
+    connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+
+    mainLayout->addWidget(buttonBox);
+    buttonBox->button(QDialogButtonBox::Close)->setDefault(true);
+
+    setAttribute(Qt::WA_DeleteOnClose, true);
+
+    KConfigGroup cg(&partConfig, "ChangesetDialog");
+    restoreGeometry(cg.readEntry<QByteArray>("geometry", QByteArray()));
+    splitter->restoreState(cg.readEntry<QByteArray>("Splitter", QByteArray()));
+    filelist->header()->restoreState(cg.readEntry<QByteArray>("FileList", QByteArray()));
+
+    updateButtons();
+}
+
+ChangesetDialog::~ChangesetDialog()
+{
+    KConfigGroup cg(&partConfig, "ChangesetDialog");
+    cg.writeEntry("geometry", saveGeometry());
+    cg.writeEntry("Splitter", splitter->saveState());
+    cg.writeEntry("FileList", filelist->header()->saveState());
+}
+
+bool ChangesetDialog::showChangeset(OrgKdeCervisia5CvsserviceCvsserviceInterface *service, const QString &fileName, const QString &revision)
+{
+    cvsService = service;
+
+    OrgKdeCervisia5RepositoryInterface cvsRepository(cvsService->service(), "/CvsRepository", QDBusConnection::sessionBus());
+    const QString repository = cvsRepository.location();
+
+    // the changesets are collected for the module of the working copy
+    QFile file(cvsRepository.workingCopy() + QLatin1String("/CVS/Repository"));
+    const QString module = file.open(QIODevice::ReadOnly) ? QString::fromLocal8Bit(file.readLine()).trimmed() : QString();
+    if (repository.isEmpty() || module.isEmpty())
+        return false;
+
+    index = new ChangesetIndex(repository, module, this);
+    index->load();
+
+    int id = index->findChangeset(fileName, revision);
+    if (id < 0) {
+        if (!updateIndex(repository, module))
+            return false;
+        id = index->findChangeset(fileName, revision);
+    }
+
+    if (id < 0) {
+        KMessageBox::information(this, i18n("Revision %1 of %2 is not in the log of the module.", revision, fileName), "Cervisia");
+        return false;
+    }
+
+    showChangeset(id);
+    return true;
+}
+
+bool ChangesetDialog::updateIndex(const QString &repository, const QString &module)
+{
+    // the first update reads the whole log of the module
+    QDBusReply<QDBusObjectPath> job;
+    const QDateTime start = index->updateStart();
+    if (start.isValid())
+        job = cvsService->rlogSince(repository, module, start.toString(QLatin1String("yyyy-MM-dd HH:mm:ss")) + QLatin1String(" UTC"));
+    else
+        job = cvsService->rlog(repository, module, true);
+    if (!job.isValid())
+        return false;
+
+    OrgKdeCervisia5CvsserviceCvsjobInterface cvsJob(cvsService->service(), job.value().path(), QDBusConnection::sessionBus());
+    // the revisions are kept by the index
+    cvsJob.setOutputRetention(CvsJob::RetainNone, 0);
+
+    ProgressDialog dlg(this, "Logging", cvsService->service(), job, "rlog", i18n("CVS Log"));
+    dlg.setStreaming(true);
+    connect(&dlg, SIGNAL(receivedLine(QString)), index, SLOT(addLogLine(QString)));
+    const bool complete = dlg.execute() && !dlg.wasCancelled();
+
+    return index->finishUpdate(complete);
+}
+
+void ChangesetDialog::showChangeset(int id)
+{
+    current = id;
+
+    const Cervisia::Changeset changeset = index->changeset(id);
+
+    setWindowTitle(i18n("CVS Changeset %1 of %2", id + 1, index->changesetCount()));
+    authorbox->setText(changeset.m_author);
+    datebox->setText(QLocale().toString(changeset.m_dateTime));
+    commentbox->setPlainText(changeset.m_comment);
+
+    filelist->clear();
+    for (int i = 0; i < changeset.m_files.count(); ++i) {
+        auto item = new QTreeWidgetItem(filelist);
+        item->setText(FileColumn, changeset.m_files.at(i));
+        item->setText(RevisionColumn, changeset.m_revisions.at(i));
+        item->setText(PreviousColumn, previousRevision(changeset.m_revisions.at(i)));
+    }
+    filelist->setCurrentItem(filelist->topLevelItem(0));
+
+    diffbox->clear();
+
+    updateButtons();
+}
+
+void ChangesetDialog::updateButtons()
+{
+    const bool valid = index && current >= 0;
+
+    olderButton->setEnabled(valid && current > 0);
+    newerButton->setEnabled(valid && current + 1 < index->changesetCount());
+    diffButton->setEnabled(valid);
+    diffAllButton->setEnabled(valid);
+}
+
+void ChangesetDialog::slotHelp()
+{
+    KHelpClient::invokeHelp(QLatin1String("browsinglogs"));
+}
+
+void ChangesetDialog::olderClicked()
+{
+    if (current > 0)
+        showChangeset(current - 1);
+}
+
+void ChangesetDialog::newerClicked()
+{
+    if (current + 1 < index->changesetCount())
+        showChangeset(current + 1);
+}
+
+void ChangesetDialog::diffClicked()
+{
+    fileActivated(filelist->currentItem());
+}
+
+void ChangesetDialog::fileActivated(QTreeWidgetItem *item)
+{
+    if (!item)
+        return;
+
+    const QString previous = item->text(PreviousColumn);
+    if (previous.isEmpty()) {
+        KMessageBox::information(this, i18n("%1 was added in this changeset.", item->text(FileColumn)), "Cervisia");
+        return;
+    }
+
+    // Non-modal dialog
+    auto l = new DiffDialog(partConfig);
+    if (l->parseCvsDiff(cvsService, item->text(FileColumn), previous, item->text(RevisionColumn)))
+        l->show();
+    else
+        delete l;
+}
+
+void ChangesetDialog::diffAllClicked()
+{
+    diffbox->clear();
+
+    for (int i = 0; i < filelist->topLevelItemCount(); ++i) {
+        const QTreeWidgetItem *item = filelist->topLevelItem(i);
+        const QString fileName = item->text(FileColumn);
+        const QString previous = item->text(PreviousColumn);
+
+        if (previous.isEmpty()) {
+            diffbox->appendPlainText(i18n("Index: %1 (added in revision %2)", fileName, item->text(RevisionColumn)));
+            continue;
+        }
+
+        QDBusReply<QDBusObjectPath> job = cvsService->diff(fileName, previous, item->text(RevisionColumn), QString(), QString("-u"));
+        if (!job.isValid())
+            return;
+
+        ProgressDialog dlg(this, "Diff", cvsService->service(), job, "diff", i18n("CVS Diff"));
+        if (!dlg.execute())
+            return;
+
+        // cvs prints "Index:" and the revisions itself
+        diffbox->appendPlainText(dlg.getOutput().join('\n'));
+    }
+
+    diffbox->moveCursor(QTextCursor::Start);
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CHANGESETDIALOG_H
+#define CHANGESETDIALOG_H
+
+#include <QDialog>
+
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+class QSplitter;
+class QTreeWidget;
+class QTreeWidgetItem;
+class KConfig;
+class ChangesetIndex;
+class OrgKdeCervisia5CvsserviceCvsserviceInterface;
+
+/**
+ * Shows the changeset of a revision, i.e. the revisions of the other files
+ * which were committed together with it, and their differences to the
+ * previous revisions.
+ */
+class ChangesetDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ChangesetDialog(KConfig &cfg, QWidget *parent = nullptr);
+    ~ChangesetDialog() override;
+
+    /**
+     * Finds the changeset of @p revision of @p fileName. The index of the
+     * module is updated first if it doesn't know the revision yet.
+     *
+     * @param fileName relative to the working copy
+     */
+    bool showChangeset(OrgKdeCervisia5CvsserviceCvsserviceInterface *service, const QString &fileName, const QString &revision);
+
+private Q_SLOTS:
+    void slotHelp();
+    void olderClicked();
+    void newerClicked();
+    void diffClicked();
+    void diffAllClicked();
+    void fileActivated(QTreeWidgetItem *item);
+
+private:
+    bool updateIndex(const QString &repository, const QString &module);
+    void showChangeset(int id);
+    void updateButtons();
+
+    QLabel *authorbox;
+    QLabel *datebox;
+    QPlainTextEdit *commentbox;
+    QTreeWidget *filelist;
+    QPlainTextEdit *diffbox;
+    QSplitter *splitter;
+    QPushButton *olderButton, *newerButton, *diffButton, *diffAllButton;
+
+    ChangesetIndex *index;
+    int current; // id of the shown changeset
+
+    OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    KConfig &partConfig;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,550 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "changesetindex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+
+#include "cvsservice/cvsrecords.h"
+#include "debug.h"
+
+// revisions of a changeset are at most this many seconds apart (cvsps -z)
+static const quint32 CHANGESET_WINDOW = 300;
+
+// number of lines of the log which are parsed by one task of the pool
+static const int BATCH_LINES = 16384;
+
+// identifies the index files and the layout of their records
+static const quint32 INDEX_MAGIC = 0x43565343;
+static const quint32 INDEX_VERSION = 1;
+
+static const char END_OF_FILE[] = "=============================================================================";
+
+namespace
+{
+struct Record {
+    quint32 time; // seconds since the epoch
+    quint32 file;
+    quint32 revision;
+    quint32 author;
+    quint32 comment;
+    quint32 changeset;
+};
+
+// most strings are shared by many records, so each is kept only once
+class StringTable
+{
+public:
+    quint32 intern(const QString &str)
+    {
+        const auto it = m_ids.constFind(str);
+        if (it != m_ids.constEnd())
+            return it.value();
+
+        const quint32 id = m_strings.count();
+        m_strings.append(str);
+        m_ids.insert(str, id);
+        return id;
+    }
+
+    int find(const QString &str) const
+    {
+        const auto it = m_ids.constFind(str);
+        return (it != m_ids.constEnd()) ? int(it.value()) : -1;
+    }
+
+    const QString &at(quint32 id) const
+    {
+        return m_strings.at(id);
+    }
+
+    int count() const
+    {
+        return m_strings.count();
+    }
+
+    void clear()
+    {
+        m_strings.clear();
+        m_ids.clear();
+    }
+
+    void write(QDataStream &stream) const
+    {
+        stream << m_strings;
+    }
+
+    void read(QDataStream &stream)
+    {
+        clear();
+        stream >> m_strings;
+        m_ids.reserve(m_strings.count());
+        for (int i = 0; i < m_strings.count(); ++i)
+            m_ids.insert(m_strings.at(i), i);
+    }
+
+private:
+    QStringList m_strings;
+    QHash<QString, quint32> m_ids;
+};
+
+struct ParsedRevision {
+    QString file;
+    QString revision;
+    QString author;
+    QString comment;
+    quint32 time;
+};
+
+// the revisions and their strings, shared with the parse tasks
+struct Revisions {
+    void add(const QVector<ParsedRevision> &parsed)
+    {
+        QMutexLocker locker(&mutex);
+
+        for (const ParsedRevision &revision : parsed) {
+            Record record;
+            record.time = revision.time;
+            record.file = files.intern(revision.file);
+            record.revision = revisions.intern(revision.revision);
+            record.author = authors.intern(revision.author);
+            record.comment = comments.intern(revision.comment);
+            record.changeset = 0;
+            records.append(record);
+        }
+    }
+
+    void clear()
+    {
+        files.clear();
+        revisions.clear();
+        authors.clear();
+        comments.clear();
+        records.clear();
+    }
+
+    StringTable files; // relative to the module
+    StringTable revisions;
+    StringTable authors;
+    StringTable comments;
+    QVector<Record> records;
+    QMutex mutex;
+};
+
+// parses the rlog output of whole files, i.e. the lines from "RCS file:"
+// up to the line of '=' which ends the file
+class RevisionParser : public CvsRecords::LogParser
+{
+public:
+    explicit RevisionParser(const QString &module)
+        : m_module(module)
+    {
+    }
+
+    QVector<ParsedRevision> revisions;
+
+protected:
+    void revisionParsed(const CvsRecords::LogRecord &file, const CvsRecords::RevisionRecord &revision) override
+    {
+        // all revisions of a file have the same RCS file
+        if (file.fileName != m_rcsFile) {
+            m_rcsFile = file.fileName;
+            m_fileName = CvsRecords::moduleFileName(m_rcsFile, m_module);
+        }
+
+        ParsedRevision parsed;
+        parsed.file = m_fileName;
+        parsed.revision = revision.revision;
+        parsed.author = revision.author;
+        parsed.comment = revision.comment;
+        parsed.time = quint32(qMax<qint64>(0, revision.dateTime.toSecsSinceEpoch()));
+        revisions.append(parsed);
+    }
+
+private:
+    const QString m_module;
+    QString m_rcsFile;
+    QString m_fileName; // of m_rcsFile
+};
+
+class ParseTask : public QRunnable
+{
+public:
+    ParseTask(Revisions *revisions, const QStringList &lines, const QString &module)
+        : m_revisions(revisions)
+        , m_lines(lines)
+        , m_module(module)
+    {
+    }
+
+    void run() override
+    {
+        RevisionParser parser(m_module);
+        for (const QString &line : qAsConst(m_lines))
+            parser.parseLine(line);
+
+        m_revisions->add(parser.revisions);
+    }
+
+private:
+    Revisions *const m_revisions;
+    const QStringList m_lines;
+    const QString m_module;
+};
+}
+
+struct ChangesetIndex::Private {
+    Private()
+        : newestTime(0)
+    {
+    }
+
+    void buildLookup();
+
+    QString repository;
+    QString module;
+    QString fileName; // of the index
+
+    Revisions revisions; // sorted by file and revision
+    quint32 newestTime;
+
+    QVector<int> fileStart; // first record of each file, and the end
+    QVector<int> members; // records by changeset
+    QVector<int> changesetStart; // first member of each changeset, and the end
+
+    // the lines of the files which weren't handed to the pool yet
+    QStringList batch;
+    QThreadPool pool;
+};
+
+void ChangesetIndex::Private::buildLookup()
+{
+    const QVector<Record> &records = revisions.records;
+
+    fileStart.fill(0, revisions.files.count() + 1);
+    int changesetCount = 0;
+    newestTime = 0;
+    for (const Record &record : records) {
+        ++fileStart[record.file + 1];
+        changesetCount = qMax(changesetCount, int(record.changeset) + 1);
+        newestTime = qMax(newestTime, record.time);
+    }
+    for (int i = 1; i < fileStart.count(); ++i)
+        fileStart[i] += fileStart[i - 1];
+
+    // counting sort of the records by their changeset
+    changesetStart.fill(0, changesetCount + 1);
+    for (const Record &record : records)
+        ++changesetStart[record.changeset + 1];
+    for (int i = 1; i < changesetStart.count(); ++i)
+        changesetStart[i] += changesetStart[i - 1];
+
+    QVector<int> next(changesetStart);
+    members.resize(records.count());
+    for (int i = 0; i < records.count(); ++i)
+        members[next[records.at(i).changeset]++] = i;
+}
+
+ChangesetIndex::ChangesetIndex(const QString &repository, const QString &module, QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    d->repository = repository;
+    d->module = module;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(repository.toUtf8());
+    // separate the parts, so that ("ab", "c") != ("a", "bc")
+    hash.addData("\0", 1);
+    hash.addData(module.toUtf8());
+
+    d->fileName = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/changesets/")
+        + QString::fromLatin1(hash.result().toHex()) + QLatin1String(".index");
+}
+
+ChangesetIndex::~ChangesetIndex()
+{
+    d->pool.waitForDone();
+    delete d;
+}
+
+bool ChangesetIndex::load()
+{
+    d->revisions.clear();
+    d->buildLookup();
+
+    QFile file(d->fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic, version;
+    QString repository, module;
+    stream >> magic >> version >> repository >> module;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || repository != d->repository || module != d->module)
+        return false;
+
+    Revisions &revisions = d->revisions;
+    revisions.files.read(stream);
+    revisions.revisions.read(stream);
+    revisions.authors.read(stream);
+    revisions.comments.read(stream);
+
+    // the records are only read on this machine, so they are kept in its
+    // byte order
+    qint32 count;
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count < 0)
+        return false;
+
+    revisions.records.resize(count);
+    const int size = count * int(sizeof(Record));
+    if (stream.readRawData(reinterpret_cast<char *>(revisions.records.data()), size) != size) {
+        revisions.clear();
+        return false;
+    }
+
+    for (const Record &record : qAsConst(revisions.records)) {
+        if (int(record.file) >= revisions.files.count() || int(record.revision) >= revisions.revisions.count()
+            || int(record.author) >= revisions.authors.count() || int(record.comment) >= revisions.comments.count()
+            || int(record.changeset) >= count) {
+            qCDebug(log_cervisia) << "corrupt changeset index" << d->fileName;
+            revisions.clear();
+            return false;
+        }
+    }
+
+    d->buildLookup();
+    return true;
+}
+
+bool ChangesetIndex::save() const
+{
+    QDir().mkpath(QFileInfo(d->fileName).absolutePath());
+
+    QSaveFile file(d->fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << INDEX_MAGIC << INDEX_VERSION << d->repository << d->module;
+
+    const Revisions &revisions = d->revisions;
+    revisions.files.write(stream);
+    revisions.revisions.write(stream);
+    revisions.authors.write(stream);
+    revisions.comments.write(stream);
+
+    stream << qint32(revisions.records.count());
+    stream.writeRawData(reinterpret_cast<const char *>(revisions.records.constData()), revisions.records.count() * sizeof(Record));
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+QDateTime ChangesetIndex::updateStart() const
+{
+    if (d->revisions.records.isEmpty())
+        return QDateTime();
+
+    // the revisions of the newest second may be incomplete
+    return QDateTime::fromSecsSinceEpoch(d->newestTime, Qt::UTC);
+}
+
+bool ChangesetIndex::finishUpdate(bool complete)
+{
+    flushBatch();
+    d->pool.waitForDone();
+
+    // a part of the log would hide the rest from later updates
+    if (!complete) {
+        load();
+        return false;
+    }
+
+    regroup();
+
+    if (!save())
+        qCDebug(log_cervisia) << "can't write changeset index" << d->fileName;
+
+    return true;
+}
+
+void ChangesetIndex::addLogLine(const QString &line)
+{
+    d->batch.append(line);
+
+    // the tasks only get whole files
+    if (d->batch.count() >= BATCH_LINES && line == QLatin1String(END_OF_FILE))
+        flushBatch();
+}
+
+void ChangesetIndex::flushBatch()
+{
+    if (d->batch.isEmpty())
+        return;
+
+    d->pool.start(new ParseTask(&d->revisions, d->batch, d->module));
+    d->batch.clear();
+}
+
+void ChangesetIndex::regroup()
+{
+    QVector<Record> &records = d->revisions.records;
+
+    // drop the revisions which were read twice, i.e. the ones of the
+    // second the update started with
+    std::sort(records.begin(), records.end(), [](const Record &a, const Record &b) {
+        return (a.file != b.file) ? a.file < b.file : a.revision < b.revision;
+    });
+    records.erase(std::unique(records.begin(),
+                              records.end(),
+                              [](const Record &a, const Record &b) {
+                                  return a.file == b.file && a.revision == b.revision;
+                              }),
+                  records.end());
+
+    // revisions of a changeset are next to each other in this order
+    QVector<int> order(records.count());
+    for (int i = 0; i < order.count(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&records](int a, int b) {
+        const Record &ra = records.at(a);
+        const Record &rb = records.at(b);
+        if (ra.author != rb.author)
+            return ra.author < rb.author;
+        if (ra.comment != rb.comment)
+            return ra.comment < rb.comment;
+        return ra.time < rb.time;
+    });
+
+    // the first record of each changeset
+    QVector<int> starts;
+    QSet<quint32> files;
+    for (int i = 0; i < order.count(); ++i) {
+        const Record &record = records.at(order.at(i));
+
+        bool start = (i == 0);
+        if (!start) {
+            const Record &previous = records.at(order.at(i - 1));
+            start = record.author != previous.author || record.comment != previous.comment || record.time - previous.time > CHANGESET_WINDOW
+                || files.contains(record.file);
+        }
+        if (start) {
+            starts.append(i);
+            files.clear();
+        }
+        files.insert(record.file);
+    }
+
+    // number the changesets in the order of the commits
+    QVector<int> changesets(starts.count());
+    for (int i = 0; i < changesets.count(); ++i)
+        changesets[i] = i;
+    std::stable_sort(changesets.begin(), changesets.end(), [&](int a, int b) {
+        return records.at(order.at(starts.at(a))).time < records.at(order.at(starts.at(b))).time;
+    });
+
+    for (int id = 0; id < changesets.count(); ++id) {
+        const int group = changesets.at(id);
+        const int end = (group + 1 < starts.count()) ? starts.at(group + 1) : order.count();
+        for (int i = starts.at(group); i < end; ++i)
+            records[order.at(i)].changeset = id;
+    }
+
+    d->buildLookup();
+}
+
+int ChangesetIndex::revisionCount() const
+{
+    return d->revisions.records.count();
+}
+
+int ChangesetIndex::changesetCount() const
+{
+    return d->changesetStart.count() - 1;
+}
+
+int ChangesetIndex::findChangeset(const QString &fileName, const QString &revision) const
+{
+    const int file = d->revisions.files.find(fileName);
+    const int rev = d->revisions.revisions.find(revision);
+    if (file < 0 || rev < 0)
+        return -1;
+
+    const QVector<Record> &records = d->revisions.records;
+    const auto begin = records.constBegin() + d->fileStart.at(file);
+    const auto end = records.constBegin() + d->fileStart.at(file + 1);
+    const auto it = std::lower_bound(begin, end, quint32(rev), [](const Record &record, quint32 value) {
+        return record.revision < value;
+    });
+
+    return (it != end && it->revision == quint32(rev)) ? int(it->changeset) : -1;
+}
+
+Cervisia::Changeset ChangesetIndex::changeset(int id) const
+{
+    Cervisia::Changeset result;
+    if (id < 0 || id >= changesetCount())
+        return result;
+
+    const Revisions &revisions = d->revisions;
+
+    QVector<QPair<QString, QString>> files;
+    quint32 time = 0;
+    for (int i = d->changesetStart.at(id); i < d->changesetStart.at(id + 1); ++i) {
+        const Record &record = revisions.records.at(d->members.at(i));
+        files.append(qMakePair(revisions.files.at(record.file), revisions.revisions.at(record.revision)));
+        time = qMax(time, record.time);
+
+        result.m_author = revisions.authors.at(record.author);
+        result.m_comment = revisions.comments.at(record.comment);
+    }
+
+    std::sort(files.begin(), files.end());
+    for (const auto &file : qAsConst(files)) {
+        result.m_files.append(file.first);
+        result.m_revisions.append(file.second);
+    }
+
+    result.m_dateTime = QDateTime::fromSecsSinceEpoch(time, Qt::UTC).toLocalTime();
+
+    return result;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CHANGESETINDEX_H
+#define CHANGESETINDEX_H
+
+#include <QDateTime>
+#include <QObject>
+#include <QStringList>
+
+namespace Cervisia
+{
+/**
+ * The revisions which were committed together, as far as this can be
+ * told from the log of cvs.
+ */
+struct Changeset {
+    QString m_author;
+    QString m_comment;
+    QDateTime m_dateTime; // of the last revision
+    QStringList m_files; // relative to the module
+    QStringList m_revisions; // of m_files
+};
+}
+
+/**
+ * Groups the revisions of all files of a module into changesets, like
+ * cvsps does: revisions with the same author and log message belong to
+ * the same changeset, unless more than CHANGESET_WINDOW seconds lie between
+ * them or a file would appear twice.
+ *
+ * The log of rlog is parsed in a thread pool while it arrives. The
+ * revisions and their changesets are kept in a file per repository and
+ * module, so later updates only ask cvs for the revisions committed since
+ * the newest one in the index (see ChangesetDialog).
+ */
+class ChangesetIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    ChangesetIndex(const QString &repository, const QString &module, QObject *parent = nullptr);
+    ~ChangesetIndex() override;
+
+    /**
+     * Reads the index file of the repository and the module.
+     *
+     * @return false if there is none yet or it can't be read
+     */
+    bool load();
+
+    /**
+     * @return The time from which on rlog has to report the revisions that
+     *         are missing in the index, or an invalid time if the whole
+     *         log of the module is needed.
+     */
+    QDateTime updateStart() const;
+
+    /**
+     * Waits for the lines passed to addLogLine(), groups the revisions
+     * into changesets and writes the index file.
+     *
+     * @param complete false if the log was cut off. The new revisions are
+     *        dropped then, as they would hide the rest of the log from
+     *        later updates.
+     * @return false if the new revisions were dropped
+     */
+    bool finishUpdate(bool complete);
+
+    /**
+     * @return The number of revisions in the index.
+     */
+    int revisionCount() const;
+
+    /**
+     * @return The number of changesets in the index.
+     */
+    int changesetCount() const;
+
+    /**
+     * @param fileName the file relative to the module
+     *
+     * @return The changeset of @p revision of @p fileName or -1 if the
+     *         index doesn't know it.
+     */
+    int findChangeset(const QString &fileName, const QString &revision) const;
+
+    /**
+     * @param id between 0 and changesetCount() - 1, in the order of the
+     *        commits
+     */
+    Cervisia::Changeset changeset(int id) const;
+
+public Q_SLOTS:
+    /**
+     * Adds the next line of the output of rlog for the module.
+     */
+    void addLogLine(const QString &line);
+
+private:
+    void flushBatch();
+    void regroup();
+    bool save() const;
+
+    struct Private;
+    Private *d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -43,6 +43,7 @@
 #include <kurlcompletion.h>
 
 #include "cervisiasettings.h"
+#include "cvsservice/cvsrecords.h"
 #include "cvsserviceinterface.h"
 #include "misc.h"
 #include "progressdialog.h"
@@ -385,21 +386,16 @@ void CheckoutDialog::branchButtonClicked()
         return;
 
     ProgressDialog dlg(this, "Remote Log", cvsService->service(), cvsJob, QString(), i18n("CVS Remote Log"));
+    dlg.setRecordsOnly(true);
     if (!dlg.execute())
         return;
 
-    QString line;
-    while (dlg.getLine(line)) {
-        int colonPos;
-
-        if (line.isEmpty() || line[0] != '\t')
-            continue;
-        if ((colonPos = line.indexOf(':', 1)) < 0)
-            continue;
-
-        const QString tag = line.mid(1, colonPos - 1);
-        if (!branchTagList.contains(tag))
-            branchTagList.push_back(tag);
+    const QList<CvsRecords::LogRecord> records = CvsRecords::read<CvsRecords::LogRecord>(dlg.getRecords(CvsRecords::Log));
+    for (const CvsRecords::LogRecord &record : records) {
+        for (const CvsRecords::TagRecord &tag : record.tags) {
+            if (!branchTagList.contains(tag.name))
+                branchTagList.push_back(tag.name);
+        }
     }
 
     branchTagList.sort();
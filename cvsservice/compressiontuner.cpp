@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "compressiontuner.h"
+
+#include "../debug.h"
+
+#include <QHash>
+#include <QStandardPaths>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+static const int LEVEL_COUNT = 10; // -z0 ... -z9
+
+// jobs with less output say nothing about the throughput
+static const qlonglong MIN_SAMPLE_BYTES = 64 * 1024;
+
+// weight of a new sample in the moving average
+static const double SMOOTHING = 0.3;
+
+// number of samples with the current level before a neighbour is tried
+static const int PROBE_INTERVAL = 8;
+
+// a neighbour must be this much better to replace the current level
+static const double MIN_IMPROVEMENT = 1.1;
+
+namespace
+{
+struct RepositoryState {
+    RepositoryState()
+        : current(0)
+        , probe(-1)
+        , direction(1)
+        , samplesSinceProbe(0)
+        , minLevel(0)
+        , maxLevel(LEVEL_COUNT - 1)
+    {
+        for (int i = 0; i < LEVEL_COUNT; ++i)
+            score[i] = 0.0;
+    }
+
+    int current;
+    int probe; // level which is tried, -1 if none
+    int direction; // of the next probe
+    int samplesSinceProbe;
+    int minLevel;
+    int maxLevel;
+    double score[LEVEL_COUNT]; // moving average, 0 if not measured
+};
+}
+
+struct CompressionTuner::Private {
+    KSharedConfig::Ptr state;
+    QHash<QString, RepositoryState> repositories;
+
+    RepositoryState &repository(const QString &location, int initialLevel);
+    void save(const QString &location, const RepositoryState &repo);
+};
+
+RepositoryState &CompressionTuner::Private::repository(const QString &location, int initialLevel)
+{
+    auto it = repositories.find(location);
+    if (it != repositories.end())
+        return it.value();
+
+    RepositoryState &repo = repositories[location];
+
+    const KConfigGroup group(state, QLatin1String("Repository-") + location);
+    repo.current = group.readEntry("Level", initialLevel);
+    repo.direction = group.readEntry("Direction", 1);
+    const QList<double> scores = group.readEntry("Scores", QList<double>());
+    for (int i = 0; i < LEVEL_COUNT && i < scores.count(); ++i)
+        repo.score[i] = scores.at(i);
+
+    return repo;
+}
+
+void CompressionTuner::Private::save(const QString &location, const RepositoryState &repo)
+{
+    QList<double> scores;
+    for (int i = 0; i < LEVEL_COUNT; ++i)
+        scores.append(repo.score[i]);
+
+    KConfigGroup group(state, QLatin1String("Repository-") + location);
+    group.writeEntry("Level", repo.current);
+    group.writeEntry("Direction", repo.direction);
+    group.writeEntry("Scores", scores);
+    state->sync();
+}
+
+CompressionTuner::CompressionTuner()
+    : d(new Private)
+{
+    // what was learned isn't configuration, so keep it out of cvsservicerc
+    d->state = KSharedConfig::openConfig(QStringLiteral("cervisia/compressionstaterc"), KConfig::SimpleConfig, QStandardPaths::GenericDataLocation);
+}
+
+CompressionTuner::~CompressionTuner()
+{
+    delete d;
+}
+
+bool CompressionTuner::isRemote(const QString &location)
+{
+    return location.startsWith(':') && !location.startsWith(QLatin1String(":local:"), Qt::CaseInsensitive)
+        && !location.startsWith(QLatin1String(":fork:"), Qt::CaseInsensitive);
+}
+
+int CompressionTuner::level(const QString &location, int initialLevel, int minLevel, int maxLevel)
+{
+    minLevel = qBound(0, minLevel, LEVEL_COUNT - 1);
+    maxLevel = qBound(minLevel, maxLevel, LEVEL_COUNT - 1);
+
+    RepositoryState &repo = d->repository(location, initialLevel);
+    repo.minLevel = minLevel;
+    repo.maxLevel = maxLevel;
+    repo.current = qBound(minLevel, repo.current, maxLevel);
+
+    if (repo.probe >= 0 && (repo.probe < minLevel || repo.probe > maxLevel))
+        repo.probe = -1;
+
+    return repo.probe >= 0 ? repo.probe : repo.current;
+}
+
+void CompressionTuner::addSample(const QString &location, int level, qlonglong bytes, qint64 wallMsecs, qint64 cpuMsecs)
+{
+    if (bytes < MIN_SAMPLE_BYTES || wallMsecs <= 0 || level < 0 || level >= LEVEL_COUNT)
+        return;
+
+    RepositoryState &repo = d->repository(location, level);
+
+    // effective throughput, reduced by the share of CPU time
+    const double throughput = bytes * 1000.0 / wallMsecs;
+    const double cpuShare = qMax<qint64>(cpuMsecs, 0) / double(wallMsecs);
+    const double score = throughput / (1.0 + cpuShare);
+
+    double &average = repo.score[level];
+    average = (average > 0.0) ? SMOOTHING * score + (1.0 - SMOOTHING) * average : score;
+
+    if (level == repo.probe) {
+        // keep the better level and continue in its direction
+        if (repo.score[level] > repo.score[repo.current] * MIN_IMPROVEMENT) {
+            repo.direction = (level > repo.current) ? 1 : -1;
+            repo.current = level;
+        } else {
+            repo.direction = -repo.direction;
+        }
+        repo.probe = -1;
+        repo.samplesSinceProbe = 0;
+
+        qCDebug(log_cervisia) << "compression level for" << location << "is now" << repo.current;
+    } else if (level == repo.current && ++repo.samplesSinceProbe >= PROBE_INTERVAL) {
+        int probe = repo.current + repo.direction;
+        if (probe < repo.minLevel || probe > repo.maxLevel) {
+            repo.direction = -repo.direction;
+            probe = repo.current + repo.direction;
+        }
+        if (probe >= repo.minLevel && probe <= repo.maxLevel)
+            repo.probe = probe;
+        repo.samplesSinceProbe = 0;
+    }
+
+    d->save(location, repo);
+}
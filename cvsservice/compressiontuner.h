@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMPRESSIONTUNER_H
+#define COMPRESSIONTUNER_H
+
+#include <qstring.h>
+
+/**
+ * Chooses the compression level (-z) for a remote repository from the
+ * measured effective throughput of the previous jobs. The throughput of
+ * each level is weighted with the CPU time the cvs client needed. From
+ * time to time a neighbouring level is tried; it replaces the current
+ * level when it performs better. What was learned is kept in a state file.
+ */
+class CompressionTuner
+{
+public:
+    CompressionTuner();
+    ~CompressionTuner();
+
+    /**
+     * @return true for repositories which are accessed over the network,
+     *         only for them compression makes a difference.
+     */
+    static bool isRemote(const QString &location);
+
+    /**
+     * @return The compression level for the next job on @p location.
+     *
+     * @param initialLevel level used until something was learned
+     * @param minLevel, maxLevel the bounds set by the user
+     */
+    int level(const QString &location, int initialLevel, int minLevel, int maxLevel);
+
+    /**
+     * Adds the measurement of a finished job. Jobs with little output are
+     * ignored, because their time is dominated by the latency.
+     *
+     * @param bytes size of the (uncompressed) output of the job
+     * @param wallMsecs run time of the job
+     * @param cpuMsecs CPU time used by the cvs client
+     */
+    void addSample(const QString &location, int level, qlonglong bytes, qint64 wallMsecs, qint64 cpuMsecs);
+
+private:
+    struct Private;
+    Private *d;
+};
+
+#endif
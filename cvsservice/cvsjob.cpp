@@ -21,37 +21,372 @@
 #include "cvsjob.h"
 
 #include "../debug.h"
+#include "compressiontuner.h"
+#include "cvsrecords.h"
+#include "cvsserviceutils.h"
+#include "jobstatistics.h"
+#include "linesplitter.h"
+#include "resultcache.h"
 #include "sshagent.h"
 
+#include <QContiguousCache>
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRegularExpression>
+#include <QTemporaryFile>
+#include <QVector>
 #include <kprocess.h>
 
 #include <cvsjobadaptor.h>
 
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// stands for the file list in the arguments of the job
+static const char FILE_LIST_ARG[] = "\001files\001";
+
+// The whole command line is a single argument of the shell, which Linux
+// limits to 128 KiB (MAX_ARG_STRLEN). Longer file lists are split into
+// batches of this size, leaving room for the rest of the command.
+static const int MAX_FILE_LIST_LENGTH = 96 * 1024;
+
+namespace
+{
+/**
+ * KProcess which can redirect the standard output of the child
+ * directly into a file descriptor handed out by CvsJob::outputChannel().
+ */
+class CvsProcess : public KProcess
+{
+public:
+    CvsProcess()
+        : m_stdoutFd(-1)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        setChildProcessModifier([this]() {
+            if (m_stdoutFd >= 0)
+                ::dup2(m_stdoutFd, STDOUT_FILENO);
+        });
+#endif
+    }
+
+    void setStandardOutputDescriptor(int fd)
+    {
+        m_stdoutFd = fd;
+    }
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+protected:
+    void setupChildProcess() override
+    {
+        if (m_stdoutFd >= 0)
+            ::dup2(m_stdoutFd, STDOUT_FILENO);
+    }
+#endif
+
+private:
+    int m_stdoutFd;
+};
+
+struct ResultCacheEntry {
+    QString key;
+    QString sourceFile; // empty: the standard output of the job
+    int maxExitStatus;
+    QStringList outputPrefixes; // one of them required if the status isn't 0
+};
+
+/**
+ * @return The command line of @p program with @p fileList in place of
+ *         the FILE_LIST_ARG argument.
+ */
+QString commandLine(QStringList program, const QString &fileList)
+{
+    for (QString &arg : program) {
+        if (arg == QLatin1String(FILE_LIST_ARG))
+            arg = fileList;
+    }
+
+    return program.join(QLatin1String(" "));
+}
+
+/**
+ * @return The compression level (-z) in the command line of a job,
+ *         -1 if it doesn't use compression.
+ */
+int compressionLevel(const QString &cmdline)
+{
+    static const QRegularExpression re(QStringLiteral("(?:^|\\s)-z(\\d)(?:\\s|$)"));
+
+    const QRegularExpressionMatch match = re.match(cmdline);
+    return match.hasMatch() ? match.captured(1).toInt() : -1;
+}
+
+/**
+ * @return The CPU time (in ms) used by all terminated children of the
+ *         service. The difference between two calls is only exact when
+ *         no other job finished in between.
+ */
+qint64 childrenCpuTime()
+{
+    struct rusage usage;
+    if (::getrusage(RUSAGE_CHILDREN, &usage) != 0)
+        return -1;
+
+    return qint64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+}
+}
+
 struct CvsJob::Private {
     Private()
         : isRunning(false)
+        , isReusable(false)
+        , forwardStdout(true)
+        , outputChannelFd(-1)
+        , retention(RetainAll)
+        , retainedBytes(0)
+        , spoolFile(0)
+        , resultCache(0)
+        , resultFile(0)
+        , adaptor(0)
+        , statistics(0)
+        , compressionTuner(0)
+        , nextBatch(0)
+        , batchExitStatus(0)
+        , isCancelled(false)
+        , sshAgent(0)
+        , isWaitingForAgent(false)
     {
-        childproc = new KProcess;
+        childproc = new CvsProcess;
+        resetStatistics();
+        clock.start();
     }
     ~Private()
     {
+        closeOutputChannel();
+        delete spoolFile;
+        delete resultFile;
         delete childproc;
     }
 
-    KProcess *childproc;
+    void closeOutputChannel();
+    void retainOutput(LineSplitter &splitter, const QString &output);
+    void flushOutput();
+    void clearOutput();
+    void commitResults(bool normalExit, int exitStatus);
+    bool hasExpectedOutput(const QStringList &prefixes);
+    void resetStatistics();
+    void countOutput(const QByteArray &data, qlonglong &bytes, qlonglong &lines);
+    bool startBatch();
+
+    CvsProcess *childproc;
     QString server;
     QString rsh;
     QString directory;
     bool isRunning;
-    QStringList outputLines;
+    bool isReusable; // the non-concurrent job is never deleted
+    bool forwardStdout; // emit receivedStdout()
+    int outputChannelFd; // write end of the streaming channel
+    int retention;
+    qint64 retainedBytes;
+    LineSplitter stdoutSplitter; // incomplete lines are kept until the
+    LineSplitter stderrSplitter; // rest arrives
+    QStringList outputLines; // RetainAll
+    QContiguousCache<QString> lastLines; // RetainLastLines
+    QTemporaryFile *spoolFile; // SpoolToFile
+    QVector<qint64> spoolOffsets; // start of each line in spoolFile
+    QHash<int, QByteArray> records; // parsed output by CvsRecords::Type
     QString dbusObjectPath;
+    QString owner;
+    ResultCache *resultCache;
+    QVector<ResultCacheEntry> resultCacheEntries;
+    QTemporaryFile *resultFile; // raw standard output for the result cache
+    CvsjobAdaptor *adaptor; // relays the signals to the bus
+
+    // statistics of the last execution, times in ms relative to clock
+    JobStatistics *statistics;
+    QElapsedTimer clock; // started when the command is set up
+    QString commandName; // set by the service
+    QString command; // of the last execution
+    qint64 executeTime;
+    qint64 startTime;
+    qint64 firstByteTime;
+    qint64 exitTime;
+    qlonglong stdoutBytes;
+    qlonglong stdoutLines;
+    qlonglong stderrBytes;
+    qlonglong stderrLines;
+    qlonglong clientTime;
+    int exitStatus;
+    int compressionLevel;
+    qint64 cpuTimeAtStart;
+    qint64 cpuTime;
+
+    CompressionTuner *compressionTuner;
+    QString compressionLocation; // repository the tuner learns about
+
+    QStringList fileList; // replaces FILE_LIST_ARG
+    QStringList arguments; // of the running command, with FILE_LIST_ARG
+    QStringList batches; // joined parts of fileList
+    int nextBatch;
+    int batchExitStatus; // highest exit status of the finished batches
+    bool isCancelled;
+
+    SshAgent *sshAgent; // the job waits until it is ready
+    bool isWaitingForAgent;
 };
 
+void CvsJob::Private::closeOutputChannel()
+{
+    if (outputChannelFd < 0)
+        return;
+
+    ::close(outputChannelFd);
+    outputChannelFd = -1;
+    childproc->setStandardOutputDescriptor(-1);
+}
+
+void CvsJob::Private::retainOutput(LineSplitter &splitter, const QString &output)
+{
+    if (retention == RetainNone)
+        return;
+
+    splitter.append(output);
+
+    QStringView line;
+    switch (retention) {
+    case RetainAll:
+        while (splitter.nextLine(&line)) {
+            outputLines.append(line.toString());
+            retainedBytes += line.size() * sizeof(QChar);
+        }
+        break;
+    case RetainLastLines:
+        while (splitter.nextLine(&line)) {
+            if (lastLines.isFull())
+                retainedBytes -= lastLines.first().size() * sizeof(QChar);
+            lastLines.append(line.toString());
+            retainedBytes += line.size() * sizeof(QChar);
+        }
+        break;
+    case SpoolToFile:
+        if (!spoolFile) {
+            spoolFile = new QTemporaryFile;
+            if (!spoolFile->open()) {
+                qCDebug(log_cervisia) << "could not create spool file";
+                delete spoolFile;
+                spoolFile = 0;
+                return;
+            }
+        }
+        spoolFile->seek(spoolFile->size());
+        while (splitter.nextLine(&line)) {
+            spoolOffsets.append(spoolFile->pos());
+            spoolFile->write(line.toUtf8());
+            spoolFile->write("\n", 1);
+        }
+        retainedBytes = spoolOffsets.size() * sizeof(qint64);
+        break;
+    }
+}
+
+void CvsJob::Private::flushOutput()
+{
+    // output without a final newline
+    stdoutSplitter.finish();
+    retainOutput(stdoutSplitter, QString());
+    stderrSplitter.finish();
+    retainOutput(stderrSplitter, QString());
+}
+
+void CvsJob::Private::clearOutput()
+{
+    stdoutSplitter.clear();
+    stderrSplitter.clear();
+    records.clear();
+    outputLines.clear();
+    lastLines.clear();
+    delete spoolFile;
+    spoolFile = 0;
+    spoolOffsets.clear();
+    retainedBytes = 0;
+}
+
+void CvsJob::Private::commitResults(bool normalExit, int exitStatus)
+{
+    for (const ResultCacheEntry &entry : qAsConst(resultCacheEntries)) {
+        if (!normalExit || exitStatus > entry.maxExitStatus)
+            continue;
+
+        // the status may also stand for an error, e.g. a revision which
+        // doesn't exist or a broken connection
+        if (exitStatus > 0 && !hasExpectedOutput(entry.outputPrefixes))
+            continue;
+
+        if (entry.sourceFile.isEmpty()) {
+            if (resultFile) {
+                resultFile->close();
+                if (resultCache->insert(entry.key, resultFile->fileName()))
+                    resultFile->setAutoRemove(false);
+            }
+        } else {
+            resultCache->insertCopy(entry.key, entry.sourceFile);
+        }
+    }
+
+    resultCacheEntries.clear();
+    delete resultFile;
+    resultFile = 0;
+}
+
+bool CvsJob::Private::hasExpectedOutput(const QStringList &prefixes)
+{
+    if (stderrBytes > 0 || !resultFile || !resultFile->seek(0))
+        return false;
+
+    const QString start = QString::fromLocal8Bit(resultFile->readLine(256));
+
+    for (const QString &prefix : prefixes) {
+        if (start.startsWith(prefix))
+            return true;
+    }
+
+    return false;
+}
+
+void CvsJob::Private::resetStatistics()
+{
+    executeTime = startTime = firstByteTime = exitTime = -1;
+    stdoutBytes = stdoutLines = stderrBytes = stderrLines = 0;
+    clientTime = -1;
+    exitStatus = -1;
+    compressionLevel = -1;
+    cpuTimeAtStart = cpuTime = -1;
+}
+
+void CvsJob::Private::countOutput(const QByteArray &data, qlonglong &bytes, qlonglong &lines)
+{
+    if (firstByteTime < 0 && !data.isEmpty())
+        firstByteTime = clock.elapsed();
+
+    bytes += data.size();
+    lines += data.count('\n');
+}
+
+bool CvsJob::Private::startBatch()
+{
+    childproc->setShellCommand(commandLine(arguments, batches.at(nextBatch++)));
+    childproc->start();
+
+    return childproc->waitForStarted();
+}
+
 CvsJob::CvsJob(unsigned jobNum)
     : QObject()
     , d(new Private)
 {
-    (void)new CvsjobAdaptor(this);
+    d->adaptor = new CvsjobAdaptor(this);
     QDBusConnection dbus = QDBusConnection::sessionBus();
     d->dbusObjectPath = "/CvsJob" + QString::number(jobNum);
     qCDebug(log_cervisia) << "dbusObjectPath:" << d->dbusObjectPath;
@@ -62,9 +397,10 @@ CvsJob::CvsJob(const QString &objId)
     : QObject()
     , d(new Private)
 {
-    (void)new CvsjobAdaptor(this);
+    d->adaptor = new CvsjobAdaptor(this);
     // TODO register it with good name
     d->dbusObjectPath = '/' + objId;
+    d->isReusable = true;
     qCDebug(log_cervisia) << "dbusObjectPath:" << d->dbusObjectPath;
     QDBusConnection::sessionBus().registerObject(d->dbusObjectPath, this);
 }
@@ -79,9 +415,58 @@ QString CvsJob::dbusObjectPath() const
     return d->dbusObjectPath;
 }
 
+void CvsJob::setOwner(const QString &owner)
+{
+    d->owner = owner;
+}
+
+QString CvsJob::owner() const
+{
+    return d->owner;
+}
+
+void CvsJob::stopSignalRelay()
+{
+    // the adaptor relays each signal of the job with a connection
+    disconnect(this, 0, d->adaptor, 0);
+}
+
+void CvsJob::setCommandName(const QString &name)
+{
+    d->commandName = name;
+}
+
+void CvsJob::setStatistics(JobStatistics *statistics)
+{
+    d->statistics = statistics;
+}
+
+void CvsJob::setCompressionTuner(CompressionTuner *tuner, const QString &location)
+{
+    d->compressionTuner = tuner;
+    d->compressionLocation = location;
+}
+
+void CvsJob::setSshAgent(SshAgent *agent)
+{
+    d->sshAgent = agent;
+}
+
+void CvsJob::addResultCacheEntry(ResultCache *cache, const QString &key, const QString &sourceFile, int maxExitStatus, const QStringList &outputPrefixes)
+{
+    d->resultCache = cache;
+    d->resultCacheEntries.append({key, sourceFile, maxExitStatus, outputPrefixes});
+}
+
 void CvsJob::clearCvsCommand()
 {
     d->childproc->clearProgram();
+    d->fileList.clear();
+    d->commandName.clear();
+    d->forwardStdout = true;
+
+    // the reusable job is queued again
+    d->clock.restart();
 }
 
 void CvsJob::setRSH(const QString &rsh)
@@ -122,17 +507,202 @@ CvsJob &CvsJob::operator<<(const QStringList &args)
     return *this;
 }
 
+void CvsJob::addFileList(const QStringList &files)
+{
+    d->fileList = files;
+    *d->childproc << QLatin1String(FILE_LIST_ARG);
+}
+
 QString CvsJob::cvsCommand() const
 {
-    return d->childproc->program().join(QLatin1String(" "));
+    // shows the complete file list, even if it is run in batches
+    return commandLine(d->childproc->program(), CvsServiceUtils::joinFileList(d->fileList));
 }
 
 QStringList CvsJob::output() const
 {
-    return d->outputLines;
+    switch (d->retention) {
+    case RetainLastLines:
+        return outputRange(0, d->lastLines.count());
+    case SpoolToFile:
+        return outputRange(0, d->spoolOffsets.count());
+    default:
+        return d->outputLines;
+    }
+}
+
+QStringList CvsJob::outputRange(int first, int count) const
+{
+    QStringList lines;
+    if (first < 0 || count <= 0)
+        return lines;
+
+    switch (d->retention) {
+    case RetainAll:
+        return d->outputLines.mid(first, count);
+    case RetainLastLines: {
+        const int last = qMin(first + count, d->lastLines.count());
+        for (int i = first; i < last; ++i)
+            lines.append(d->lastLines.at(d->lastLines.firstIndex() + i));
+        break;
+    }
+    case SpoolToFile: {
+        if (!d->spoolFile || first >= d->spoolOffsets.count())
+            break;
+        const int last = qMin(first + count, d->spoolOffsets.count());
+        const qint64 start = d->spoolOffsets.at(first);
+        const qint64 end = last < d->spoolOffsets.count() ? d->spoolOffsets.at(last) : d->spoolFile->size();
+        d->spoolFile->seek(start);
+        const QString text = QString::fromUtf8(d->spoolFile->read(end - start));
+        lines = text.split('\n');
+        lines.removeLast(); // every spooled line is terminated by a newline
+        break;
+    }
+    default:
+        break;
+    }
+
+    return lines;
+}
+
+QByteArray CvsJob::records(int type)
+{
+    if (d->isRunning)
+        return QByteArray();
+
+    auto it = d->records.constFind(type);
+    if (it == d->records.constEnd())
+        it = d->records.insert(type, CvsRecords::parse(type, output()));
+
+    return it.value();
+}
+
+void CvsJob::setForwardStdout(bool forward)
+{
+    d->forwardStdout = forward;
+}
+
+void CvsJob::setOutputRetention(int policy, int maxLines)
+{
+    d->clearOutput();
+
+    switch (policy) {
+    case RetainNone:
+    case SpoolToFile:
+        d->retention = policy;
+        break;
+    case RetainLastLines:
+        d->retention = policy;
+        d->lastLines.setCapacity(qMax(maxLines, 1));
+        break;
+    default:
+        d->retention = RetainAll;
+        break;
+    }
+}
+
+qlonglong CvsJob::memoryUsage() const
+{
+    return d->retainedBytes;
+}
+
+void CvsJob::release()
+{
+    d->clearOutput();
+
+    if (d->isReusable)
+        return;
+
+    if (d->isRunning) {
+        connect(this, SIGNAL(jobExited(bool, int)), this, SLOT(deleteLater()));
+        cancel();
+    } else {
+        deleteLater();
+    }
+}
+
+QDBusUnixFileDescriptor CvsJob::outputChannel()
+{
+    if (d->isRunning || !(QDBusConnection::sessionBus().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing))
+        return {};
+
+    d->closeOutputChannel();
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        qCDebug(log_cervisia) << "socketpair() failed";
+        return {};
+    }
+
+    // the client only reads and the cvs client only writes
+    ::shutdown(fds[0], SHUT_WR);
+    ::shutdown(fds[1], SHUT_RD);
+
+    d->outputChannelFd = fds[1];
+    d->childproc->setStandardOutputDescriptor(d->outputChannelFd);
+
+    // QDBusUnixFileDescriptor keeps its own duplicate of the descriptor
+    const QDBusUnixFileDescriptor channel(fds[0]);
+    ::close(fds[0]);
+
+    return channel;
 }
 
 bool CvsJob::execute()
+{
+    qCDebug(log_cervisia) << "Execute cvs command:" << cvsCommand();
+
+    // only keep the output of the current command
+    d->clearOutput();
+
+    // capture the raw output for the result cache (not possible when
+    // it goes directly to the streaming channel)
+    delete d->resultFile;
+    d->resultFile = 0;
+    for (const ResultCacheEntry &entry : qAsConst(d->resultCacheEntries)) {
+        if (entry.sourceFile.isEmpty() && d->outputChannelFd < 0) {
+            d->resultFile = new QTemporaryFile(d->resultCache->directory() + QLatin1String("/XXXXXX.part"));
+            if (!d->resultFile->open()) {
+                delete d->resultFile;
+                d->resultFile = 0;
+            }
+            break;
+        }
+    }
+
+    d->resetStatistics();
+    d->command = d->commandName.isEmpty() ? QStringLiteral("other") : d->commandName;
+    d->compressionLevel = compressionLevel(cvsCommand());
+    d->executeTime = d->clock.elapsed();
+    d->cpuTimeAtStart = childrenCpuTime();
+
+    // a long file list is processed in several runs
+    d->arguments = d->childproc->program();
+    if (d->arguments.contains(QLatin1String(FILE_LIST_ARG)))
+        d->batches = CvsServiceUtils::joinFileListBatches(d->fileList, MAX_FILE_LIST_LENGTH);
+    else
+        d->batches = QStringList(QString());
+    d->nextBatch = 0;
+    d->batchExitStatus = 0;
+    d->isCancelled = false;
+
+    if (d->batches.count() > 1)
+        qCDebug(log_cervisia) << "Running in" << d->batches.count() << "batches";
+
+    d->isRunning = true;
+
+    // don't block the service while the ssh-agent is set up
+    if (d->sshAgent && !d->sshAgent->isReady()) {
+        qCDebug(log_cervisia) << "waiting for ssh-agent";
+        d->isWaitingForAgent = true;
+        connect(d->sshAgent, SIGNAL(ready()), this, SLOT(slotSshAgentReady()));
+        return true;
+    }
+
+    return startProcess();
+}
+
+bool CvsJob::startProcess()
 {
     // setup job environment to use the ssh-agent (if it is running)
     SshAgent ssh;
@@ -159,49 +729,162 @@ bool CvsJob::execute()
     connect(d->childproc, SIGNAL(readyReadStandardOutput()), SLOT(slotReceivedStdout()));
     connect(d->childproc, SIGNAL(readyReadStandardError()), SLOT(slotReceivedStderr()));
 
-    qCDebug(log_cervisia) << "Execute cvs command:" << cvsCommand();
-
-    d->isRunning = true;
     d->childproc->setOutputChannelMode(KProcess::SeparateChannels);
-    d->childproc->setShellCommand(cvsCommand());
-    d->childproc->start();
-    return d->childproc->waitForStarted();
+
+    const bool started = d->startBatch();
+    if (!started) {
+        d->isRunning = false;
+        d->closeOutputChannel();
+    }
+
+    d->startTime = d->clock.elapsed();
+
+    return started;
+}
+
+void CvsJob::abortJob()
+{
+    d->childproc->clearProgram();
+    d->fileList.clear();
+    d->batches.clear();
+    d->closeOutputChannel();
+    d->commitResults(false, -1);
+
+    d->isRunning = false;
+
+    Q_EMIT jobExited(false, -1);
+}
+
+QVariantMap CvsJob::statistics() const
+{
+    // durations between two points in time, -1 if one is missing
+    auto duration = [](qint64 from, qint64 to) -> qlonglong {
+        return (from < 0 || to < 0) ? -1 : to - from;
+    };
+
+    QVariantMap result;
+    result.insert("command", d->command);
+    result.insert("queueTime", d->executeTime);
+    result.insert("spawnTime", duration(d->executeTime, d->startTime));
+    result.insert("firstByteTime", duration(d->startTime, d->firstByteTime));
+    result.insert("runTime", duration(d->startTime, d->exitTime));
+    result.insert("cpuTime", d->cpuTime);
+    result.insert("compressionLevel", d->compressionLevel);
+    result.insert("stdoutBytes", d->stdoutBytes);
+    result.insert("stdoutLines", d->stdoutLines);
+    result.insert("stderrBytes", d->stderrBytes);
+    result.insert("stderrLines", d->stderrLines);
+    result.insert("exitStatus", d->exitStatus);
+    result.insert("clientTime", d->clientTime);
+    return result;
+}
+
+void CvsJob::reportClientTime(qlonglong msecs)
+{
+    d->clientTime = msecs;
+    if (d->statistics)
+        d->statistics->addClientTime(d->command, msecs);
+}
+
+QString CvsJob::submit()
+{
+    // execute() replaces the program with the shell invocation
+    const QString command = cvsCommand();
+    return execute() ? command : QString();
 }
 
 void CvsJob::cancel()
 {
+    if (d->isWaitingForAgent) {
+        d->isWaitingForAgent = false;
+        disconnect(d->sshAgent, SIGNAL(ready()), this, SLOT(slotSshAgentReady()));
+        abortJob();
+        return;
+    }
+
+    // don't start the remaining batches
+    d->isCancelled = true;
     d->childproc->kill();
 }
 
+void CvsJob::slotSshAgentReady()
+{
+    disconnect(d->sshAgent, SIGNAL(ready()), this, SLOT(slotSshAgentReady()));
+    d->isWaitingForAgent = false;
+
+    if (!startProcess())
+        abortJob();
+}
+
 void CvsJob::slotProcessFinished()
 {
+    bool normalExit = d->childproc->exitStatus() == QProcess::NormalExit;
+    const int exitStatus = qMax(d->childproc->exitCode(), d->batchExitStatus);
+
+    d->flushOutput();
+
+    // continue with the next batch of files
+    if (normalExit && !d->isCancelled && d->nextBatch < d->batches.count()) {
+        d->batchExitStatus = exitStatus;
+        if (d->startBatch())
+            return;
+        normalExit = false;
+    }
+
     qCDebug(log_cervisia);
     // disconnect all connections to childproc's signals
     d->childproc->disconnect();
     d->childproc->clearProgram();
+    d->fileList.clear();
+    d->batches.clear();
+
+    // the reader of the streaming channel sees end-of-file now
+    d->closeOutputChannel();
 
     d->isRunning = false;
 
-    Q_EMIT jobExited(d->childproc->exitStatus() == QProcess::NormalExit, d->childproc->exitCode());
+    d->commitResults(normalExit, exitStatus);
+
+    d->exitTime = d->clock.elapsed();
+    d->exitStatus = exitStatus;
+    const qint64 cpuTime = childrenCpuTime();
+    d->cpuTime = (d->cpuTimeAtStart < 0 || cpuTime < 0) ? -1 : cpuTime - d->cpuTimeAtStart;
+    if (d->statistics)
+        d->statistics->addJob(statistics());
+
+    // without -z the job ran with level 0, results from the cache don't count
+    if (d->compressionTuner && normalExit && exitStatus == 0 && d->command != QLatin1String("cache"))
+        d->compressionTuner->addSample(d->compressionLocation, qMax(d->compressionLevel, 0), d->stdoutBytes, d->exitTime - d->startTime, d->cpuTime);
+
+    Q_EMIT jobExited(normalExit, exitStatus);
 }
 
 void CvsJob::slotReceivedStdout()
 {
-    const QString output(QString::fromLocal8Bit(d->childproc->readAllStandardOutput()));
+    const QByteArray data = d->childproc->readAllStandardOutput();
+    d->countOutput(data, d->stdoutBytes, d->stdoutLines);
+    if (d->resultFile)
+        d->resultFile->write(data);
+
+    const QString output(QString::fromLocal8Bit(data));
 
     // accumulate output
-    d->outputLines += output.split('\n');
+    d->retainOutput(d->stdoutSplitter, output);
 
     qCDebug(log_cervisia) << "output:" << output;
-    Q_EMIT receivedStdout(output);
+    if (d->forwardStdout)
+        Q_EMIT receivedStdout(output);
 }
 
 void CvsJob::slotReceivedStderr()
 {
-    const QString output(QString::fromLocal8Bit(d->childproc->readAllStandardError()));
+    const QByteArray data = d->childproc->readAllStandardError();
+    d->countOutput(data, d->stderrBytes, d->stderrLines);
+
+    const QString output(QString::fromLocal8Bit(data));
 
     // accumulate output
-    d->outputLines += output.split('\n');
+    d->retainOutput(d->stderrSplitter, output);
 
     qCDebug(log_cervisia) << "output:" << output;
     Q_EMIT receivedStderr(output);
@@ -21,15 +21,31 @@
 #ifndef CVSJOB_H
 #define CVSJOB_H
 
+#include <QDBusUnixFileDescriptor>
 #include <QStringList>
+#include <QVariantMap>
 #include <qobject.h>
 
 class QString;
+class CompressionTuner;
+class JobStatistics;
+class ResultCache;
+class SshAgent;
 
 class Q_DECL_EXPORT CvsJob : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * How much of the output of the cvs client is kept by the job.
+     */
+    enum OutputRetention {
+        RetainAll = 0, ///< keep every line (default)
+        RetainNone = 1, ///< only forward the output via signals
+        RetainLastLines = 2, ///< keep the last N lines in a ring buffer
+        SpoolToFile = 3 ///< write the lines into a temporary file
+    };
+
     explicit CvsJob(unsigned jobNum);
     explicit CvsJob(const QString &objId);
     ~CvsJob() override;
@@ -44,9 +60,81 @@ public:
     CvsJob &operator<<(const char *arg);
     CvsJob &operator<<(const QStringList &args);
 
+    /**
+     * Appends @p files to the command line. A list which is too long for
+     * one command line is split into batches, and the command is run once
+     * for every batch, one after the other. Clients still see a single job
+     * with the output of all runs and the highest exit status.
+     */
+    void addFileList(const QStringList &files);
+
     QString dbusObjectPath() const;
+
+    /**
+     * D-Bus name of the client that created this job. The job is reaped
+     * when that client disconnects from the bus.
+     */
+    void setOwner(const QString &owner);
+    QString owner() const;
+
+    /**
+     * Stops sending the signals of the job over the bus. The clients of an
+     * in-process service connect to the job object directly.
+     */
+    void stopSignalRelay();
+
+    /**
+     * The cvs command of the job, e.g. "annotate", or "cache" if the result
+     * comes from the result cache. The statistics are collected per command.
+     * The command line isn't searched for it, because a job may run several
+     * cvs commands.
+     */
+    void setCommandName(const QString &name);
+
+    /**
+     * Stores the result of the next execution in @p cache under @p key,
+     * when the cvs client exits normally with a status of at most
+     * @p maxExitStatus. The result is the standard output of the job or,
+     * if @p sourceFile is given, the content of that file.
+     *
+     * A status above 0 is only accepted when the job wrote nothing to
+     * stderr and its standard output starts with one of @p outputPrefixes.
+     */
+    void addResultCacheEntry(ResultCache *cache,
+                             const QString &key,
+                             const QString &sourceFile = QString(),
+                             int maxExitStatus = 0,
+                             const QStringList &outputPrefixes = QStringList());
+
+    /**
+     * The statistics of every execution are added to @p statistics.
+     */
+    void setStatistics(JobStatistics *statistics);
+
+    /**
+     * The throughput of every successful execution is reported to
+     * @p tuner for the repository @p location.
+     */
+    void setCompressionTuner(CompressionTuner *tuner, const QString &location);
+
+    /**
+     * The next execution doesn't start the cvs client before @p agent is
+     * ready. Meanwhile the job is already reported as running.
+     */
+    void setSshAgent(SshAgent *agent);
+
 public Q_SLOTS: // dbus function
     bool execute();
+
+    /**
+     * Starts the job like execute() and also returns its command line,
+     * which saves clients a separate cvsCommand() call per job.
+     *
+     * @return The cvs command of the job, or an empty string if the cvs
+     *         client couldn't be started.
+     */
+    QString submit();
+
     void cancel();
     bool isRunning() const;
 
@@ -59,17 +147,104 @@ public Q_SLOTS: // dbus function
 
     QStringList output() const;
 
+    /**
+     * Returns @p count lines of the retained output starting at line
+     * @p first. Spooled output is read back from disk on demand.
+     */
+    QStringList outputRange(int first, int count) const;
+
+    /**
+     * Parses the retained output into typed records. The result is kept,
+     * so each type is only parsed once per execution.
+     *
+     * @param type one of CvsRecords::Type
+     * @return The records serialized with QDataStream, to be read with
+     *         CvsRecords::read(). Empty while the job is running.
+     */
+    QByteArray records(int type);
+
+    /**
+     * Turns receivedStdout() off for clients which only fetch records(),
+     * so the output doesn't cross the bus twice. The standard error is
+     * always sent.
+     */
+    void setForwardStdout(bool forward);
+
+    /**
+     * Sets the retention policy for the output of the cvs client.
+     *
+     * @param policy one of OutputRetention
+     * @param maxLines size of the ring buffer for RetainLastLines
+     */
+    void setOutputRetention(int policy, int maxLines);
+
+    /**
+     * @return The approximate number of bytes of memory used by the
+     *         retained output of this job.
+     */
+    qlonglong memoryUsage() const;
+
+    /**
+     * Tells the service that the client doesn't need the job anymore.
+     * A running job is cancelled and the job is deleted afterwards.
+     */
+    void release();
+
+    /**
+     * Switches the job into streaming mode. The standard output of the
+     * cvs client is written directly into the returned file descriptor
+     * instead of being sent as receivedStdout() signals and it isn't
+     * accumulated for output() either. The standard error output and
+     * the jobExited() signal are still delivered over D-Bus.
+     *
+     * Must be called before execute(). The channel is valid for one
+     * execution of the job; the reader sees end-of-file when the cvs
+     * client has exited. Note that jobExited() may arrive before all
+     * data has been read from the descriptor.
+     *
+     * The output doesn't pass through the service then, so the job can't
+     * fill the result cache and records() stays empty. That's why
+     * Cervisia's own dialogs (e.g. log and diff) don't use the channel.
+     * It is meant for other clients of the service which process the raw
+     * output of large jobs themselves.
+     *
+     * @return A descriptor to read the raw output from or an invalid
+     *         descriptor if the D-Bus connection doesn't support
+     *         passing file descriptors.
+     */
+    QDBusUnixFileDescriptor outputChannel();
+
+    /**
+     * Timings and output sizes of the last execution: "command" (the cvs
+     * command, e.g. "log"), "queueTime" (creation until execute()),
+     * "spawnTime", "firstByteTime" (start until the first output), "runTime"
+     * (start until exit), all in ms, "stdoutBytes", "stdoutLines",
+     * "stderrBytes", "stderrLines", "exitStatus" and "clientTime".
+     * Values which weren't measured are -1.
+     */
+    QVariantMap statistics() const;
+
+    /**
+     * Tells the job how long the client needed to process its output
+     * (parsing and rendering), so it can be added to the statistics.
+     */
+    void reportClientTime(qlonglong msecs);
+
 Q_SIGNALS: // dbus signal
     void jobExited(bool normalExit, int status);
     void receivedStdout(const QString &buffer);
     void receivedStderr(const QString &buffer);
 
 private Q_SLOTS:
+    void slotSshAgentReady();
     void slotProcessFinished();
     void slotReceivedStdout();
     void slotReceivedStderr();
 
 private:
+    bool startProcess();
+    void abortJob();
+
     struct Private;
     Private *d;
 };
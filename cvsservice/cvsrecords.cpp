@@ -0,0 +1,566 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "cvsrecords.h"
+
+#include <QLocale>
+#include <QStringView>
+#include <QVector>
+
+using namespace CvsRecords;
+
+static const QLatin1String LOG_SEPARATOR("----------------------------");
+static const QLatin1String LOG_END("=============================================================================");
+
+namespace
+{
+// splits at whitespace, the words are views into the line
+QVector<QStringView> words(QStringView line)
+{
+    QVector<QStringView> result;
+
+    int pos = 0;
+    const int length = line.size();
+    while (pos < length) {
+        while (pos < length && line.at(pos).isSpace())
+            ++pos;
+        const int start = pos;
+        while (pos < length && !line.at(pos).isSpace())
+            ++pos;
+        if (pos > start)
+            result.append(line.mid(start, pos - start));
+    }
+
+    return result;
+}
+
+// the first word of the text after the colon of "Label: value"
+QString valueOf(QStringView line)
+{
+    const int colon = line.indexOf(QLatin1Char(':'));
+    const QVector<QStringView> list = words(line.mid(colon + 1));
+    return list.isEmpty() ? QString() : list.first().toString();
+}
+
+// converts a magic branch number (1.1.0.2) into the branch (1.1.2)
+TagRecord tagRecord(const QString &name, QString revision)
+{
+    TagRecord tag;
+    tag.name = name;
+    tag.isBranch = false;
+
+    const int pos2 = revision.lastIndexOf(QLatin1Char('.'));
+    const int pos1 = pos2 > 0 ? revision.lastIndexOf(QLatin1Char('.'), pos2 - 1) : -1;
+    if (pos1 > 0 && QStringView(revision).mid(pos1 + 1, pos2 - pos1 - 1) == QLatin1String("0")) {
+        revision.remove(pos1 + 1, pos2 - pos1);
+        tag.isBranch = true;
+    } else if (revision.count(QLatin1Char('.')) % 2 == 0) {
+        // vendor branch, e.g. 1.1.1
+        tag.isBranch = true;
+    }
+
+    tag.revision = revision;
+    return tag;
+}
+
+QList<UpdateRecord> parseUpdate(const QStringList &lines)
+{
+    QList<UpdateRecord> records;
+
+    for (const QString &line : lines) {
+        if (line.length() < 3 || line.at(1) != QLatin1Char(' ') || !QStringView(u"UPMARC?").contains(line.at(0)))
+            continue;
+
+        UpdateRecord record;
+        record.status = line.at(0);
+        record.path = line.mid(2);
+        records.append(record);
+    }
+
+    return records;
+}
+
+QList<StatusRecord> parseStatus(const QStringList &lines)
+{
+    QList<StatusRecord> records;
+    bool inTags = false;
+
+    for (const QString &line : lines) {
+        const QStringView trimmed = QStringView(line).trimmed();
+
+        if (line.startsWith(QLatin1String("File: "))) {
+            const int statusPos = line.indexOf(QLatin1String("Status:"));
+            if (statusPos < 0)
+                continue;
+
+            StatusRecord record;
+            record.fileName = QStringView(line).mid(6, statusPos - 6).trimmed().toString();
+            if (record.fileName.startsWith(QLatin1String("no file ")))
+                record.fileName.remove(0, 8);
+            record.status = QStringView(line).mid(statusPos + 7).trimmed().toString();
+            records.append(record);
+            inTags = false;
+        } else if (records.isEmpty()) {
+            continue;
+        } else if (trimmed.startsWith(QLatin1String("Working revision:"))) {
+            records.last().workingRevision = valueOf(trimmed);
+        } else if (trimmed.startsWith(QLatin1String("Repository revision:"))) {
+            records.last().repositoryRevision = valueOf(trimmed);
+        } else if (trimmed.startsWith(QLatin1String("Sticky Tag:"))) {
+            const QString tag = valueOf(trimmed);
+            if (tag != QLatin1String("(none)"))
+                records.last().stickyTag = tag;
+        } else if (trimmed.startsWith(QLatin1String("Existing Tags:"))) {
+            inTags = true;
+        } else if (inTags && line.startsWith(QLatin1Char('\t'))) {
+            // e.g. "\tname   (revision: 1.2)" or "\tname   (branch: 1.1.2)"
+            const QVector<QStringView> list = words(line);
+            if (list.count() < 3 || !list.at(2).endsWith(QLatin1Char(')')))
+                continue;
+
+            TagRecord tag;
+            tag.name = list.at(0).toString();
+            tag.isBranch = list.at(1) == QLatin1String("(branch:");
+            tag.revision = list.at(2).chopped(1).toString();
+            records.last().tags.append(tag);
+        } else if (trimmed.isEmpty() && inTags) {
+            inTags = false;
+        }
+    }
+
+    return records;
+}
+
+QDateTime logDate(QStringView line)
+{
+    // "date: 2003/06/02 12:34:56;  author: ..." or with dashes and zone
+    const QVector<QStringView> list = words(line.mid(6, line.indexOf(QLatin1Char(';')) - 6));
+    if (list.count() < 2)
+        return {};
+
+    QString date = list.at(0).toString();
+    date.replace(QLatin1Char('/'), QLatin1Char('-'));
+
+    QDateTime dateTime = QDateTime::fromString(date + QLatin1Char('T') + list.at(1).toString(), Qt::ISODate);
+    dateTime.setTimeSpec(Qt::UTC);
+    return dateTime;
+}
+
+QString logAuthor(QStringView line)
+{
+    const int pos = line.indexOf(QLatin1String("author:"));
+    if (pos < 0)
+        return QString();
+
+    const QStringView rest = line.mid(pos + 7);
+    return rest.left(rest.indexOf(QLatin1Char(';'))).trimmed().toString();
+}
+
+// collects the records of a whole log
+class LogCollector : public LogParser
+{
+public:
+    QList<LogRecord> records;
+
+protected:
+    void revisionParsed(const LogRecord & /*file*/, const RevisionRecord &revision) override
+    {
+        m_revisions.append(revision);
+    }
+
+    void fileParsed(const LogRecord &file) override
+    {
+        records.append(file);
+        records.last().revisions = m_revisions;
+        m_revisions.clear();
+    }
+
+private:
+    QList<RevisionRecord> m_revisions;
+};
+
+QList<LogRecord> parseLog(const QStringList &lines)
+{
+    LogCollector collector;
+    for (const QString &line : lines)
+        collector.parseLine(line);
+
+    return collector.records;
+}
+
+QList<AnnotateRecord> parseAnnotate(const QStringList &lines)
+{
+    QList<AnnotateRecord> records;
+    bool inAnnotations = false;
+
+    for (const QString &line : lines) {
+        // skip the log and the header of each file
+        if (line.startsWith(QLatin1String("*****"))) {
+            inAnnotations = true;
+            continue;
+        }
+        if (!inAnnotations || line.startsWith(QLatin1String("Annotations for ")))
+            continue;
+
+        // "1.2          (joe      02-Jun-03): content"
+        const int open = line.indexOf(QLatin1Char('('));
+        const int close = open < 0 ? -1 : line.indexOf(QLatin1String("): "), open + 1);
+        if (close < 0)
+            continue;
+
+        const QVector<QStringView> authorDate = words(QStringView(line).mid(open + 1, close - open - 1));
+
+        AnnotateRecord record;
+        record.revision = QStringView(line).left(open).trimmed().toString();
+        if (!authorDate.isEmpty())
+            record.author = authorDate.first().toString();
+        if (authorDate.count() > 1) {
+            QDate date(QLocale::c().toDate(authorDate.last().toString(), QLatin1String("dd-MMM-yy")));
+            if (date.year() < 1970)
+                date = date.addYears(100);
+            record.date = date;
+        }
+        record.content = line.mid(close + 3);
+        records.append(record);
+    }
+
+    return records;
+}
+
+QList<HistoryRecord> parseHistory(const QStringList &lines)
+{
+    QList<HistoryRecord> records;
+
+    for (const QString &line : lines) {
+        const QVector<QStringView> list = words(line);
+        if (list.count() < 6 || list.at(0).size() != 1)
+            continue;
+
+        const QChar code = list.at(0).at(0);
+        const bool hasFile = code != QLatin1Char('O') && code != QLatin1Char('F') && code != QLatin1Char('E');
+        if (list.count() != (hasFile ? 10 : 8))
+            continue;
+
+        HistoryRecord record;
+        record.code = code;
+        record.dateTime = QDateTime::fromString(list.at(1).toString() + QLatin1Char('T') + list.at(2).toString(), Qt::ISODate);
+
+        // the time zone, e.g. +0200
+        const QStringView zone = list.at(3);
+        if (zone.size() == 5 && (zone.at(0) == QLatin1Char('+') || zone.at(0) == QLatin1Char('-'))) {
+            const int offset = zone.mid(1, 2).toString().toInt() * 3600 + zone.mid(3, 2).toString().toInt() * 60;
+            record.dateTime.setOffsetFromUtc(zone.at(0) == QLatin1Char('-') ? -offset : offset);
+        }
+
+        record.author = list.at(4).toString();
+        if (hasFile) {
+            record.revision = list.at(5).toString();
+            record.fileName = list.at(6).toString();
+            record.path = list.at(7).toString();
+        } else {
+            record.path = list.at(5).toString();
+        }
+        records.append(record);
+    }
+
+    return records;
+}
+
+QList<WatcherRecord> parseWatchers(const QStringList &lines)
+{
+    QList<WatcherRecord> records;
+    QString fileName;
+
+    for (const QString &line : lines) {
+        const QVector<QStringView> list = words(line);
+        if (list.isEmpty() || list.first() == QLatin1String("?"))
+            continue;
+
+        // further watchers of the same file are on the following lines
+        int first = 0;
+        if (!line.at(0).isSpace())
+            fileName = list.at(first++).toString();
+        if (first >= list.count() || fileName.isEmpty())
+            continue;
+
+        WatcherRecord record;
+        record.fileName = fileName;
+        record.watcher = list.at(first).toString();
+        record.edit = record.unedit = record.commit = false;
+        for (int i = first + 1; i < list.count(); ++i) {
+            record.edit |= list.at(i) == QLatin1String("edit");
+            record.unedit |= list.at(i) == QLatin1String("unedit");
+            record.commit |= list.at(i) == QLatin1String("commit");
+        }
+        records.append(record);
+    }
+
+    return records;
+}
+
+template<typename T>
+QByteArray serialize(const QList<T> &records)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << records;
+    return data;
+}
+}
+
+QByteArray CvsRecords::parse(int type, const QStringList &lines)
+{
+    switch (type) {
+    case Update:
+        return serialize(parseUpdate(lines));
+    case Status:
+        return serialize(parseStatus(lines));
+    case Log:
+        return serialize(parseLog(lines));
+    case Annotate:
+        return serialize(parseAnnotate(lines));
+    case History:
+        return serialize(parseHistory(lines));
+    case Watchers:
+        return serialize(parseWatchers(lines));
+    default:
+        return QByteArray();
+    }
+}
+
+CvsRecords::LogParser::LogParser()
+    : m_state(Begin)
+{
+}
+
+CvsRecords::LogParser::~LogParser()
+{
+}
+
+void CvsRecords::LogParser::parseLine(const QString &line)
+{
+    if (m_state == Separator) {
+        m_pendingLines.append(line);
+
+        // a separator only ends the comment if the revision and the date
+        // line follow, so wait for the date line
+        if (m_pendingLines.count() == 2 && line.startsWith(QLatin1String("revision ")))
+            return;
+
+        const QStringList lines = m_pendingLines;
+        m_pendingLines.clear();
+
+        if (lines.count() == 3 && lines.at(2).startsWith(QLatin1String("date: "))) {
+            revisionParsed(m_file, m_revision);
+            m_state = Revision;
+        } else {
+            // still in message
+            m_revision.comment += QLatin1Char('\n') + lines.at(0);
+            m_state = Comment;
+        }
+
+        for (int i = 1; i < lines.count(); ++i)
+            parseLine(lines.at(i));
+        return;
+    }
+
+    switch (m_state) {
+    case Begin:
+        if (line.startsWith(QLatin1String("RCS file: "))) {
+            m_file = LogRecord();
+            m_file.fileName = line.mid(10);
+            m_state = Admin;
+        }
+        break;
+    case Admin:
+        if (line.startsWith(QLatin1String("Working file: "))) {
+            m_file.fileName = line.mid(14);
+        } else if (line == QLatin1String("symbolic names:")) {
+            m_state = Tags;
+        } else if (line == LOG_SEPARATOR) {
+            m_state = Revision;
+        } else if (line == LOG_END) {
+            fileParsed(m_file);
+            m_state = Begin;
+        }
+        break;
+    case Tags:
+        if (line.startsWith(QLatin1Char('\t'))) {
+            const int colon = line.lastIndexOf(QLatin1Char(':'));
+            if (colon > 0)
+                m_file.tags.append(tagRecord(line.mid(1, colon - 1), line.mid(colon + 1).trimmed()));
+        } else {
+            m_state = Admin;
+            parseLine(line);
+        }
+        break;
+    case Revision:
+        if (line.startsWith(QLatin1String("revision "))) {
+            m_revision = RevisionRecord();
+            m_revision.revision = line.section(QLatin1Char(' '), 1, 1);
+            m_state = Author;
+        }
+        break;
+    case Author:
+        if (line.startsWith(QLatin1String("date: "))) {
+            m_revision.dateTime = logDate(line);
+            m_revision.author = logAuthor(line);
+            m_state = Branches;
+        }
+        break;
+    case Branches:
+        if (!line.startsWith(QLatin1String("branches:"))) {
+            m_revision.comment = line;
+            m_state = Comment;
+        }
+        break;
+    case Comment:
+        if (line == LOG_SEPARATOR) {
+            m_pendingLines.append(line);
+            m_state = Separator;
+        } else if (line == LOG_END) {
+            revisionParsed(m_file, m_revision);
+            fileParsed(m_file);
+            m_state = Begin;
+        } else {
+            // still in message
+            m_revision.comment += QLatin1Char('\n') + line;
+        }
+        break;
+    case Separator:;
+    }
+}
+
+void CvsRecords::LogParser::reset()
+{
+    m_state = Begin;
+    m_pendingLines.clear();
+    m_file = LogRecord();
+    m_revision = RevisionRecord();
+}
+
+void CvsRecords::LogParser::fileParsed(const LogRecord & /*file*/)
+{
+}
+
+QString CvsRecords::moduleFileName(const QString &rcsFile, const QString &module)
+{
+    QString fileName = rcsFile;
+    if (fileName.endsWith(QLatin1String(",v")))
+        fileName.chop(2);
+
+    // the RCS files are below the folder of the module in the repository
+    QString modulePrefix = module;
+    if (!modulePrefix.startsWith(QLatin1Char('/')))
+        modulePrefix.prepend(QLatin1Char('/'));
+    modulePrefix += QLatin1Char('/');
+    const int pos = fileName.indexOf(modulePrefix);
+    if (pos >= 0)
+        fileName.remove(0, pos + modulePrefix.length());
+
+    // removed files are in the Attic
+    const int attic = fileName.lastIndexOf(QLatin1String("Attic/"));
+    if (attic == 0 || (attic > 0 && fileName.at(attic - 1) == QLatin1Char('/')))
+        fileName.remove(attic, 6);
+
+    return fileName;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const UpdateRecord &record)
+{
+    return stream << record.status << record.path;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, UpdateRecord &record)
+{
+    return stream >> record.status >> record.path;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const TagRecord &record)
+{
+    return stream << record.name << record.revision << record.isBranch;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, TagRecord &record)
+{
+    return stream >> record.name >> record.revision >> record.isBranch;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const StatusRecord &record)
+{
+    return stream << record.fileName << record.status << record.workingRevision << record.repositoryRevision << record.stickyTag << record.tags;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, StatusRecord &record)
+{
+    return stream >> record.fileName >> record.status >> record.workingRevision >> record.repositoryRevision >> record.stickyTag >> record.tags;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const RevisionRecord &record)
+{
+    return stream << record.revision << record.author << record.dateTime << record.comment;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, RevisionRecord &record)
+{
+    return stream >> record.revision >> record.author >> record.dateTime >> record.comment;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const LogRecord &record)
+{
+    return stream << record.fileName << record.tags << record.revisions;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, LogRecord &record)
+{
+    return stream >> record.fileName >> record.tags >> record.revisions;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const AnnotateRecord &record)
+{
+    return stream << record.revision << record.author << record.date << record.content;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, AnnotateRecord &record)
+{
+    return stream >> record.revision >> record.author >> record.date >> record.content;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const HistoryRecord &record)
+{
+    return stream << record.code << record.dateTime << record.author << record.revision << record.fileName << record.path;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, HistoryRecord &record)
+{
+    return stream >> record.code >> record.dateTime >> record.author >> record.revision >> record.fileName >> record.path;
+}
+
+QDataStream &CvsRecords::operator<<(QDataStream &stream, const WatcherRecord &record)
+{
+    return stream << record.fileName << record.watcher << record.edit << record.unedit << record.commit;
+}
+
+QDataStream &CvsRecords::operator>>(QDataStream &stream, WatcherRecord &record)
+{
+    return stream >> record.fileName >> record.watcher >> record.edit >> record.unedit >> record.commit;
+}
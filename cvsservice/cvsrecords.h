@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef CVSRECORDS_H
+#define CVSRECORDS_H
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Typed results of cvs commands. The output of a job is parsed once in
+ * the service (CvsJob::records()) and the records are transferred as a
+ * QDataStream serialized list, so the clients don't need to parse the
+ * text of cvs themselves.
+ */
+namespace CvsRecords
+{
+enum Type {
+    Update = 1, // UpdateRecord, also for simulated updates
+    Status, // StatusRecord
+    Log, // LogRecord, also for rlog
+    Annotate, // AnnotateRecord
+    History, // HistoryRecord
+    Watchers // WatcherRecord
+};
+
+struct UpdateRecord {
+    QChar status; // U, P, M, A, R, C or ?
+    QString path;
+};
+
+struct TagRecord {
+    QString name;
+    QString revision; // the branch number for branches, e.g. 1.1.2
+    bool isBranch;
+};
+
+struct StatusRecord {
+    QString fileName;
+    QString status; // e.g. Up-to-date
+    QString workingRevision;
+    QString repositoryRevision;
+    QString stickyTag; // empty if none
+    QList<TagRecord> tags; // only with status -v
+};
+
+struct RevisionRecord {
+    QString revision;
+    QString author;
+    QDateTime dateTime; // UTC
+    QString comment;
+};
+
+struct LogRecord {
+    QString fileName; // working file, or the RCS file for rlog
+    QList<TagRecord> tags;
+    QList<RevisionRecord> revisions;
+};
+
+struct AnnotateRecord {
+    QString revision;
+    QString author;
+    QDate date;
+    QString content;
+};
+
+struct HistoryRecord {
+    QChar code; // e.g. O for checkout, M for commit
+    QDateTime dateTime;
+    QString author;
+    QString revision; // empty for checkout, release and export
+    QString fileName; // empty for checkout, release and export
+    QString path;
+};
+
+struct WatcherRecord {
+    QString fileName;
+    QString watcher;
+    bool edit;
+    bool unedit;
+    bool commit;
+};
+
+/**
+ * Parses the output @p lines of a job.
+ *
+ * @param type one of Type
+ * @return The serialized list of records. Empty for an unknown type.
+ */
+QByteArray parse(int type, const QStringList &lines);
+
+/**
+ * Parses the output of log or rlog line by line, e.g. while it arrives.
+ * Only the file and the revision which are being read are kept, so even
+ * the log of a large module needs little memory. The dates are in UTC.
+ */
+class LogParser
+{
+public:
+    LogParser();
+    virtual ~LogParser();
+
+    /**
+     * Parses the next line of the output.
+     */
+    void parseLine(const QString &line);
+
+    /**
+     * Forgets the file which is being read, e.g. after a cancelled job.
+     */
+    void reset();
+
+protected:
+    /**
+     * Called for each revision once its comment is complete.
+     *
+     * @param file the name and the tags of the file, without revisions
+     */
+    virtual void revisionParsed(const LogRecord &file, const RevisionRecord &revision) = 0;
+
+    /**
+     * Called at the end of the log of @p file, after its last revision.
+     */
+    virtual void fileParsed(const LogRecord &file);
+
+private:
+    enum State { Begin, Admin, Tags, Revision, Author, Branches, Comment, Separator };
+
+    State m_state;
+    QStringList m_pendingLines; // separator within a comment and the lines after it
+    LogRecord m_file;
+    RevisionRecord m_revision;
+};
+
+/**
+ * @param rcsFile the RCS file of a revision reported by rlog
+ * @param module the folder of the module in the repository
+ *
+ * @return The working file of @p rcsFile relative to @p module, e.g.
+ *         "dir/file.cpp" for "/cvsroot/module/dir/Attic/file.cpp,v".
+ */
+QString moduleFileName(const QString &rcsFile, const QString &module);
+
+/**
+ * Deserializes the records returned by parse().
+ */
+template<typename T>
+QList<T> read(const QByteArray &data)
+{
+    QList<T> records;
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> records;
+    return records;
+}
+
+QDataStream &operator<<(QDataStream &stream, const UpdateRecord &record);
+QDataStream &operator>>(QDataStream &stream, UpdateRecord &record);
+QDataStream &operator<<(QDataStream &stream, const TagRecord &record);
+QDataStream &operator>>(QDataStream &stream, TagRecord &record);
+QDataStream &operator<<(QDataStream &stream, const StatusRecord &record);
+QDataStream &operator>>(QDataStream &stream, StatusRecord &record);
+QDataStream &operator<<(QDataStream &stream, const RevisionRecord &record);
+QDataStream &operator>>(QDataStream &stream, RevisionRecord &record);
+QDataStream &operator<<(QDataStream &stream, const LogRecord &record);
+QDataStream &operator>>(QDataStream &stream, LogRecord &record);
+QDataStream &operator<<(QDataStream &stream, const AnnotateRecord &record);
+QDataStream &operator>>(QDataStream &stream, AnnotateRecord &record);
+QDataStream &operator<<(QDataStream &stream, const HistoryRecord &record);
+QDataStream &operator>>(QDataStream &stream, HistoryRecord &record);
+QDataStream &operator<<(QDataStream &stream, const WatcherRecord &record);
+QDataStream &operator>>(QDataStream &stream, WatcherRecord &record);
+}
+
+#endif
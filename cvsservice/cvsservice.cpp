@@ -22,7 +22,13 @@
 #include "../debug.h"
 
 #include <QApplication>
+#include <QDBusConnectionInterface>
+#include <QDBusServiceWatcher>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QHash>
+#include <QTimer>
 #include <qstring.h>
 
 #include <KDBusService>
@@ -32,11 +38,14 @@
 #include <kmessagebox.h>
 #include <kshell.h>
 
+#include "compressiontuner.h"
 #include "cvsjob.h"
 #include "cvsloginjob.h"
 #include "cvsserviceadaptor.h"
 #include "cvsserviceutils.h"
+#include "jobstatistics.h"
 #include "repository.h"
+#include "resultcache.h"
 #include "sshagent.h"
 #include <cvsjobadaptor.h>
 #include <kconfiggroup.h>
@@ -46,11 +55,22 @@ static const char REDIRECT_STDERR[] = "2>&1";
 
 enum WatchEvents { None = 0, All = 1, Commits = 2, Edits = 4, Unedits = 8 };
 
+// jobs of a client that left the bus are kept for this time (in seconds),
+// so that scripts which use one connection per call still work
+static const int ORPHANED_JOB_TIMEOUT = 300;
+
 struct CvsService::Private {
     Private()
-        : singleCvsJob(0)
+        : q(0)
+        , singleCvsJob(0)
         , lastJobId(0)
         , repository(0)
+        , clientWatcher(0)
+        , reapTimer(0)
+        , mode(CvsService::Standalone)
+        , statistics(0)
+        , sshAgent(0)
+        , dbusService(0)
     {
     }
     ~Private()
@@ -59,6 +79,7 @@ struct CvsService::Private {
         delete singleCvsJob;
     }
 
+    CvsService *q;
     CvsJob *singleCvsJob; // non-concurrent cvs job, like update or commit
     QHash<int, CvsJob *> cvsJobs; // concurrent cvs jobs, like diff or annotate
     QHash<int, CvsLoginJob *> loginJobs;
@@ -66,45 +87,92 @@ struct CvsService::Private {
 
     Repository *repository;
 
-    CvsJob *createCvsJob();
-    QDBusObjectPath setupNonConcurrentJob(Repository *repo = 0);
+    QDBusServiceWatcher *clientWatcher; // watches the owners of the jobs
+    QHash<CvsJob *, QDateTime> orphanedJobs; // jobs whose owner left the bus
+    QTimer *reapTimer;
+
+    CvsService::Mode mode;
+
+    ResultCache resultCache; // results of immutable requests
+    CompressionTuner compressionTuner; // learns the -z level of remote repositories
+    JobStatistics *statistics; // timings of the finished jobs
+    SshAgent *sshAgent;
+    KDBusService *dbusService; // 0 in-process
+    QString client; // the service quits when this client leaves the bus
+
+    CvsJob *newCvsJob(const char *command);
+    CvsJob *createCvsJob(const char *command);
+    void reapOrphanedJobs();
+    QDBusObjectPath setupNonConcurrentJob(const char *command, Repository *repo = 0);
+    SshAgent *sshAgentFor(const Repository *repo) const;
+    QString resultCacheKey(const QString &fileName, const QStringList &request);
+    QString downloadRevisionCommand(CvsJob *job, const QString &fileName, const QString &revision, const QString &outputFile);
 
     bool hasWorkingCopy();
     bool hasRunningJob();
 };
 
-CvsService::CvsService()
+CvsService::CvsService(Mode mode)
     : d(new Private)
 {
+    d->q = this;
+    d->mode = mode;
+
     (void)new CvsserviceAdaptor(this);
     QDBusConnection::sessionBus().registerObject("/CvsService", this);
 
+    // release the jobs of clients which have left the bus
+    d->clientWatcher = new QDBusServiceWatcher(this);
+    d->clientWatcher->setConnection(QDBusConnection::sessionBus());
+    d->clientWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(d->clientWatcher, SIGNAL(serviceUnregistered(QString)), this, SLOT(slotClientUnregistered(QString)));
+
+    d->reapTimer = new QTimer(this);
+    d->reapTimer->setInterval(60 * 1000);
+    connect(d->reapTimer, SIGNAL(timeout()), this, SLOT(slotReapOrphanedJobs()));
+
     // create non-concurrent cvs job
     d->singleCvsJob = new CvsJob(SINGLE_JOB_ID);
+    if (mode == InProcess)
+        d->singleCvsJob->stopSignalRelay();
+
+    // collect timings of all jobs
+    d->statistics = new JobStatistics(this);
+    d->singleCvsJob->setStatistics(d->statistics);
+
+    d->sshAgent = new SshAgent(this);
 
     // create repository manager
     d->repository = new Repository();
+    d->repository->setCompressionTuner(&d->compressionTuner);
+    d->repository->setSshAgent(d->sshAgent);
+
+    KConfigGroup cs(CvsServiceUtils::serviceConfig(), "General");
+    d->resultCache.setEnabled(cs.readEntry("UseResultCache", true));
+    d->resultCache.setMaximumSize(qint64(cs.readEntry("ResultCacheSize", 64)) * 1024 * 1024);
 
-    KConfigGroup cs(KSharedConfig::openConfig(), "General");
     if (cs.readEntry("UseSshAgent", false)) {
-        // use the existing or start a new ssh-agent
-        SshAgent ssh;
-        // TODO CL do we need the return value?
-        // bool res = ssh.querySshAgent();
-        ssh.querySshAgent();
+        // use the existing or start a new ssh-agent, jobs which need
+        // it wait until it is ready
+        d->sshAgent->querySshAgent();
     }
 
-    new KDBusService(KDBusService::Multiple, this);
+    // in-process the objects are only reachable through the base
+    // service of the client's connection
+    if (mode == Standalone)
+        d->dbusService = new KDBusService(KDBusService::Multiple, this);
 }
 
 CvsService::~CvsService()
 {
     // kill the ssh-agent (when we started it)
-    SshAgent ssh;
-    ssh.killSshAgent();
+    d->sshAgent->killSshAgent();
 
-    qDeleteAll(d->cvsJobs);
+    // the jobs remove themselves from cvsJobs when they are destroyed
+    const QList<CvsJob *> jobs = d->cvsJobs.values();
     d->cvsJobs.clear();
+    d->orphanedJobs.clear();
+    qDeleteAll(jobs);
 
     qDeleteAll(d->loginJobs);
     d->loginJobs.clear();
@@ -126,9 +194,10 @@ QDBusObjectPath CvsService::add(const QStringList &files, bool isBinary)
     if (isBinary)
         *d->singleCvsJob << "-kb";
 
-    *d->singleCvsJob << CvsServiceUtils::joinFileList(files) << REDIRECT_STDERR;
+    d->singleCvsJob->addFileList(files);
+    *d->singleCvsJob << REDIRECT_STDERR;
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("add");
 }
 
 QDBusObjectPath CvsService::addWatch(const QStringList &files, int events)
@@ -150,9 +219,9 @@ QDBusObjectPath CvsService::addWatch(const QStringList &files, int events)
             *d->singleCvsJob << "-a unedit";
     }
 
-    *d->singleCvsJob << CvsServiceUtils::joinFileList(files);
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("watch");
 }
 
 QDBusObjectPath CvsService::annotate(const QString &fileName, const QString &revision)
@@ -161,7 +230,21 @@ QDBusObjectPath CvsService::annotate(const QString &fileName, const QString &rev
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("annotate");
+
+    // the annotations of a numeric revision never change (the log only
+    // gains newer revisions, which the annotations don't refer to)
+    if (ResultCache::isNumericRevision(revision)) {
+        const QString cacheKey = d->resultCacheKey(fileName, QStringList() << "annotate" << revision);
+        const QString cachedResult = d->resultCache.lookup(cacheKey);
+        if (!cachedResult.isEmpty()) {
+            job->setCommandName(QStringLiteral("cache"));
+            *job << "cat" << KShell::quoteArg(cachedResult);
+            return QDBusObjectPath(job->dbusObjectPath());
+        }
+        if (!cacheKey.isEmpty())
+            job->addResultCacheEntry(&d->resultCache, cacheKey);
+    }
 
     // assemble the command line
     // (cvs log [FILE] && cvs annotate [-r rev] [FILE])
@@ -201,7 +284,7 @@ QDBusObjectPath CvsService::checkout(const QString &workingDir, const QString &r
 
     *d->singleCvsJob << module;
 
-    return d->setupNonConcurrentJob(&repo);
+    return d->setupNonConcurrentJob("checkout", &repo);
 }
 
 QDBusObjectPath CvsService::checkout(const QString &workingDir,
@@ -238,7 +321,7 @@ QDBusObjectPath CvsService::checkout(const QString &workingDir,
 
     *d->singleCvsJob << module;
 
-    return d->setupNonConcurrentJob(&repo);
+    return d->setupNonConcurrentJob("checkout", &repo);
 }
 
 QDBusObjectPath CvsService::checkout(const QString &workingDir,
@@ -279,7 +362,7 @@ QDBusObjectPath CvsService::checkout(const QString &workingDir,
 
     *d->singleCvsJob << module;
 
-    return d->setupNonConcurrentJob(&repo);
+    return d->setupNonConcurrentJob("checkout", &repo);
 }
 
 QDBusObjectPath CvsService::commit(const QStringList &files, const QString &commitMessage, bool recursive)
@@ -297,10 +380,12 @@ QDBusObjectPath CvsService::commit(const QStringList &files, const QString &comm
     if (!recursive)
         *d->singleCvsJob << "-l";
 
-    *d->singleCvsJob << "-m" << KShell::quoteArg(commitMessage) << CvsServiceUtils::joinFileList(files) << REDIRECT_STDERR;
+    *d->singleCvsJob << "-m" << KShell::quoteArg(commitMessage);
+    d->singleCvsJob->addFileList(files);
+    *d->singleCvsJob << REDIRECT_STDERR;
 
     qCDebug(log_cervisia) << "end";
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("commit");
 }
 
 QDBusObjectPath CvsService::createRepository(const QString &repository)
@@ -314,7 +399,7 @@ QDBusObjectPath CvsService::createRepository(const QString &repository)
 
     *d->singleCvsJob << "mkdir -p" << KShell::quoteArg(repository) << "&&" << d->repository->cvsClient() << "-d" << KShell::quoteArg(repository) << "init";
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("init");
 }
 
 QDBusObjectPath CvsService::createTag(const QStringList &files, const QString &tag, bool branch, bool force)
@@ -334,9 +419,10 @@ QDBusObjectPath CvsService::createTag(const QStringList &files, const QString &t
     if (force)
         *d->singleCvsJob << "-F";
 
-    *d->singleCvsJob << KShell::quoteArg(tag) << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << KShell::quoteArg(tag);
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("tag");
 }
 
 QDBusObjectPath CvsService::deleteTag(const QStringList &files, const QString &tag, bool branch, bool force)
@@ -357,9 +443,10 @@ QDBusObjectPath CvsService::deleteTag(const QStringList &files, const QString &t
     if (force)
         *d->singleCvsJob << "-F";
 
-    *d->singleCvsJob << KShell::quoteArg(tag) << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << KShell::quoteArg(tag);
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("tag");
 }
 
 QDBusObjectPath CvsService::downloadCvsIgnoreFile(const QString &repository, const QString &outputFile)
@@ -367,7 +454,7 @@ QDBusObjectPath CvsService::downloadCvsIgnoreFile(const QString &repository, con
     Repository repo(repository);
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("checkout");
 
     // assemble the command line
     // cvs -d [REPOSITORY] -q checkout -p CVSROOT/cvsignore > [OUTPUTFILE]
@@ -382,17 +469,13 @@ QDBusObjectPath CvsService::downloadRevision(const QString &fileName, const QStr
     if (!d->hasWorkingCopy())
         return {};
 
-    // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    // create a cvs job, downloadRevisionCommand() names it after the cvs
+    // command unless the revision comes from the result cache
+    CvsJob *job = d->createCvsJob("cache");
 
     // assemble the command line
     // cvs update -p -r [REV] [FILE] > [OUTPUTFILE]
-    *job << d->repository->cvsClient() << "update -p";
-
-    if (!revision.isEmpty())
-        *job << "-r" << KShell::quoteArg(revision);
-
-    *job << KShell::quoteArg(fileName) << ">" << KShell::quoteArg(outputFile);
+    *job << d->downloadRevisionCommand(job, fileName, revision, outputFile);
 
     // return a reference to the cvs job
     return QDBusObjectPath(job->dbusObjectPath());
@@ -404,16 +487,14 @@ CvsService::downloadRevision(const QString &fileName, const QString &revA, const
     if (!d->hasWorkingCopy())
         return {};
 
-    // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    // create a cvs job, downloadRevisionCommand() names it after the cvs
+    // command unless the revision comes from the result cache
+    CvsJob *job = d->createCvsJob("cache");
 
     // assemble the command line
-    // cvs update -p -r [REVA] [FILE] > [OUTPUTFILEA] ;
+    // cvs update -p -r [REVA] [FILE] > [OUTPUTFILEA] &&
     // cvs update -p -r [REVB] [FILE] > [OUTPUTFILEB]
-    *job << d->repository->cvsClient() << "update -p"
-         << "-r" << KShell::quoteArg(revA) << KShell::quoteArg(fileName) << ">" << KShell::quoteArg(outputFileA) << ";" << d->repository->cvsClient()
-         << "update -p"
-         << "-r" << KShell::quoteArg(revB) << KShell::quoteArg(fileName) << ">" << KShell::quoteArg(outputFileB);
+    *job << d->downloadRevisionCommand(job, fileName, revA, outputFileA) << "&&" << d->downloadRevisionCommand(job, fileName, revB, outputFileB);
 
     // return a reference to the cvs job
     return QDBusObjectPath(job->dbusObjectPath());
@@ -432,7 +513,22 @@ QDBusObjectPath CvsService::diff(const QString &fileName, const QString &revA, c
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("diff");
+
+    // the diff between two numeric revisions never changes
+    if (ResultCache::isNumericRevision(revA) && ResultCache::isNumericRevision(revB)) {
+        const QString cacheKey = d->resultCacheKey(fileName, QStringList() << "diff" << diffOptions << format << revA << revB);
+        const QString cachedResult = d->resultCache.lookup(cacheKey);
+        if (!cachedResult.isEmpty()) {
+            job->setCommandName(QStringLiteral("cache"));
+            *job << "cat" << KShell::quoteArg(cachedResult);
+            return QDBusObjectPath(job->dbusObjectPath());
+        }
+        // cvs diff exits with 1 when the revisions differ, but also on
+        // errors, so only a real diff is kept
+        if (!cacheKey.isEmpty())
+            job->addResultCacheEntry(&d->resultCache, cacheKey, QString(), 1, QStringList() << "Index:" << "===" << "diff");
+    }
 
     // assemble the command line
     // cvs diff [DIFFOPTIONS] [FORMAT] [-r REVA] {-r REVB] [FILE]
@@ -459,9 +555,10 @@ QDBusObjectPath CvsService::edit(const QStringList &files)
     // cvs edit [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << d->repository->cvsClient() << "edit" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << d->repository->cvsClient() << "edit";
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("edit");
 }
 
 QDBusObjectPath CvsService::editors(const QStringList &files)
@@ -473,9 +570,10 @@ QDBusObjectPath CvsService::editors(const QStringList &files)
     // cvs editors [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << d->repository->cvsClient() << "editors" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << d->repository->cvsClient() << "editors";
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("editors");
 }
 
 QDBusObjectPath CvsService::history()
@@ -484,7 +582,7 @@ QDBusObjectPath CvsService::history()
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("history");
 
     // assemble the command line
     // cvs history -e -a
@@ -531,7 +629,7 @@ QDBusObjectPath CvsService::import(const QString &workingDir,
 
     *d->singleCvsJob << module << vendorTag << releaseTag;
 
-    return d->setupNonConcurrentJob(&repo);
+    return d->setupNonConcurrentJob("import", &repo);
 }
 
 QDBusObjectPath CvsService::lock(const QStringList &files)
@@ -543,9 +641,10 @@ QDBusObjectPath CvsService::lock(const QStringList &files)
     // cvs admin -l [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << d->repository->cvsClient() << "admin -l" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << d->repository->cvsClient() << "admin -l";
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("admin");
 }
 
 QDBusObjectPath CvsService::log(const QString &fileName)
@@ -554,7 +653,7 @@ QDBusObjectPath CvsService::log(const QString &fileName)
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("log");
 
     // assemble the command line
     // cvs log [FILE]
@@ -564,6 +663,38 @@ QDBusObjectPath CvsService::log(const QString &fileName)
     return QDBusObjectPath(job->dbusObjectPath());
 }
 
+QDBusObjectPath CvsService::logHeader(const QString &fileName)
+{
+    if (!d->hasWorkingCopy())
+        return {};
+
+    // create a cvs job
+    CvsJob *job = d->createCvsJob("log");
+
+    // assemble the command line
+    // cvs log -h [FILE]
+    *job << d->repository->cvsClient() << "log -h" << KShell::quoteArg(fileName);
+
+    // return a reference to the cvs job
+    return QDBusObjectPath(job->dbusObjectPath());
+}
+
+QDBusObjectPath CvsService::logSince(const QString &fileName, const QString &date)
+{
+    if (!d->hasWorkingCopy())
+        return {};
+
+    // create a cvs job
+    CvsJob *job = d->createCvsJob("log");
+
+    // assemble the command line
+    // cvs log -d ">=DATE" [FILE]
+    *job << d->repository->cvsClient() << "log -d" << KShell::quoteArg(">=" + date) << KShell::quoteArg(fileName);
+
+    // return a reference to the cvs job
+    return QDBusObjectPath(job->dbusObjectPath());
+}
+
 QDBusObjectPath CvsService::login(const QString &repository)
 {
     if (repository.isEmpty())
@@ -597,10 +728,7 @@ QDBusObjectPath CvsService::logout(const QString &repository)
     Repository repo(repository);
 
     // create a cvs job
-    ++(d->lastJobId);
-
-    auto job = new CvsJob(d->lastJobId);
-    d->cvsJobs.insert(d->lastJobId, job);
+    CvsJob *job = d->newCvsJob("logout");
 
     job->setRSH(repo.rsh());
     job->setServer(repo.server());
@@ -625,7 +753,7 @@ QDBusObjectPath CvsService::makePatch(const QString &diffOptions, const QString
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("diff");
 
     // assemble the command line
     // cvs diff [DIFFOPTIONS] [FORMAT] -R 2>/dev/null
@@ -641,10 +769,7 @@ QDBusObjectPath CvsService::moduleList(const QString &repository)
     Repository repo(repository);
 
     // create a cvs job
-    ++(d->lastJobId);
-
-    auto job = new CvsJob(d->lastJobId);
-    d->cvsJobs.insert(d->lastJobId, job);
+    CvsJob *job = d->newCvsJob("checkout");
 
     job->setRSH(repo.rsh());
     job->setServer(repo.server());
@@ -672,9 +797,10 @@ QDBusObjectPath CvsService::remove(const QStringList &files, bool recursive)
     if (!recursive)
         *d->singleCvsJob << "-l";
 
-    *d->singleCvsJob << CvsServiceUtils::joinFileList(files) << REDIRECT_STDERR;
+    d->singleCvsJob->addFileList(files);
+    *d->singleCvsJob << REDIRECT_STDERR;
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("remove");
 }
 
 QDBusObjectPath CvsService::removeWatch(const QStringList &files, int events)
@@ -696,9 +822,9 @@ QDBusObjectPath CvsService::removeWatch(const QStringList &files, int events)
             *d->singleCvsJob << "-a unedit";
     }
 
-    *d->singleCvsJob << CvsServiceUtils::joinFileList(files);
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("watch");
 }
 
 QDBusObjectPath CvsService::rlog(const QString &repository, const QString &module, bool recursive)
@@ -706,10 +832,7 @@ QDBusObjectPath CvsService::rlog(const QString &repository, const QString &modul
     Repository repo(repository);
 
     // create a cvs job
-    ++(d->lastJobId);
-
-    auto job = new CvsJob(d->lastJobId);
-    d->cvsJobs.insert(d->lastJobId, job);
+    CvsJob *job = d->newCvsJob("rlog");
 
     job->setRSH(repo.rsh());
     job->setServer(repo.server());
@@ -727,6 +850,43 @@ QDBusObjectPath CvsService::rlog(const QString &repository, const QString &modul
     return QDBusObjectPath(job->dbusObjectPath());
 }
 
+QDBusObjectPath CvsService::rlogHeader(const QString &repository, const QString &module)
+{
+    Repository repo(repository);
+
+    // create a cvs job
+    CvsJob *job = d->newCvsJob("rlog");
+
+    job->setRSH(repo.rsh());
+    job->setServer(repo.server());
+
+    // assemble the command line
+    // cvs -d [REPOSITORY] rlog -h [MODULE]
+    *job << repo.cvsClient() << "-d" << repository << "rlog -h" << module;
+
+    // return a reference to the cvs job
+    return QDBusObjectPath(job->dbusObjectPath());
+}
+
+QDBusObjectPath CvsService::rlogSince(const QString &repository, const QString &module, const QString &date)
+{
+    Repository repo(repository);
+
+    // create a cvs job
+    CvsJob *job = d->newCvsJob("rlog");
+
+    job->setRSH(repo.rsh());
+    job->setServer(repo.server());
+
+    // assemble the command line
+    // cvs -d [REPOSITORY] rlog -d ">=DATE" [MODULE]
+    *job << repo.cvsClient() << "-d" << repository << "rlog"
+         << "-d" << KShell::quoteArg(">=" + date) << module;
+
+    // return a reference to the cvs job
+    return QDBusObjectPath(job->dbusObjectPath());
+}
+
 QDBusObjectPath CvsService::simulateUpdate(const QStringList &files, bool recursive, bool createDirs, bool pruneDirs)
 {
     if (!d->hasWorkingCopy() || d->hasRunningJob())
@@ -747,9 +907,10 @@ QDBusObjectPath CvsService::simulateUpdate(const QStringList &files, bool recurs
     if (pruneDirs)
         *d->singleCvsJob << "-P";
 
-    *d->singleCvsJob << CvsServiceUtils::joinFileList(files) << REDIRECT_STDERR;
+    d->singleCvsJob->addFileList(files);
+    *d->singleCvsJob << REDIRECT_STDERR;
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("update");
 }
 
 QDBusObjectPath CvsService::status(const QStringList &files, bool recursive, bool tagInfo)
@@ -758,7 +919,7 @@ QDBusObjectPath CvsService::status(const QStringList &files, bool recursive, boo
         return {};
 
     // create a cvs job
-    CvsJob *job = d->createCvsJob();
+    CvsJob *job = d->createCvsJob("status");
 
     // assemble the command line
     // cvs status [-l] [-v] [FILES]
@@ -770,7 +931,7 @@ QDBusObjectPath CvsService::status(const QStringList &files, bool recursive, boo
     if (tagInfo)
         *job << "-v";
 
-    *job << CvsServiceUtils::joinFileList(files);
+    job->addFileList(files);
 
     // return a reference to the cvs job
     return QDBusObjectPath(job->dbusObjectPath());
@@ -785,9 +946,10 @@ QDBusObjectPath CvsService::unedit(const QStringList &files)
     // echo y | cvs unedit [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << "echo y |" << d->repository->cvsClient() << "unedit" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << "echo y |" << d->repository->cvsClient() << "unedit";
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("unedit");
 }
 
 QDBusObjectPath CvsService::unlock(const QStringList &files)
@@ -799,9 +961,10 @@ QDBusObjectPath CvsService::unlock(const QStringList &files)
     // cvs admin -u [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << d->repository->cvsClient() << "admin -u" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << d->repository->cvsClient() << "admin -u";
+    d->singleCvsJob->addFileList(files);
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("admin");
 }
 
 QDBusObjectPath CvsService::update(const QStringList &files, bool recursive, bool createDirs, bool pruneDirs, const QString &extraOpt)
@@ -824,9 +987,11 @@ QDBusObjectPath CvsService::update(const QStringList &files, bool recursive, boo
     if (pruneDirs)
         *d->singleCvsJob << "-P";
 
-    *d->singleCvsJob << extraOpt << CvsServiceUtils::joinFileList(files) << REDIRECT_STDERR;
+    *d->singleCvsJob << extraOpt;
+    d->singleCvsJob->addFileList(files);
+    *d->singleCvsJob << REDIRECT_STDERR;
 
-    return d->setupNonConcurrentJob();
+    return d->setupNonConcurrentJob("update");
 }
 
 QDBusObjectPath CvsService::watchers(const QStringList &files)
@@ -838,44 +1003,224 @@ QDBusObjectPath CvsService::watchers(const QStringList &files)
     // cvs watchers [FILES]
     d->singleCvsJob->clearCvsCommand();
 
-    *d->singleCvsJob << d->repository->cvsClient() << "watchers" << CvsServiceUtils::joinFileList(files);
+    *d->singleCvsJob << d->repository->cvsClient() << "watchers";
+    d->singleCvsJob->addFileList(files);
+
+    return d->setupNonConcurrentJob("watchers");
+}
+
+qlonglong CvsService::memoryUsage() const
+{
+    qlonglong result = d->singleCvsJob->memoryUsage();
+    for (const CvsJob *job : qAsConst(d->cvsJobs))
+        result += job->memoryUsage();
+
+    return result;
+}
+
+int CvsService::jobCount() const
+{
+    return d->cvsJobs.count();
+}
+
+void CvsService::setResultCacheEnabled(bool enabled)
+{
+    d->resultCache.setEnabled(enabled);
+}
+
+void CvsService::clearResultCache()
+{
+    d->resultCache.clear();
+}
+
+void CvsService::announce(const QString &client, const QString &startupId)
+{
+    if (!d->dbusService)
+        return;
+
+    // the client may have gone while we were starting up; this runs
+    // before the event loop, so the quit has to be queued
+    d->client = client;
+    if (!QDBusConnection::sessionBus().interface()->isServiceRegistered(client)) {
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
+    d->clientWatcher->addWatchedService(client);
 
-    return d->setupNonConcurrentJob();
+    Q_EMIT serviceStarted(startupId, d->dbusService->serviceName());
 }
 
 void CvsService::quit()
 {
-    qApp->quit();
+    // never terminate the application we are embedded in
+    if (d->mode == Standalone)
+        qApp->quit();
+}
+
+void CvsService::slotJobDestroyed(QObject *job)
+{
+    for (auto it = d->cvsJobs.begin(); it != d->cvsJobs.end(); ++it) {
+        if (it.value() == job) {
+            d->cvsJobs.erase(it);
+            break;
+        }
+    }
+
+    d->orphanedJobs.remove(static_cast<CvsJob *>(job));
+}
+
+void CvsService::slotClientUnregistered(const QString &service)
+{
+    qCDebug(log_cervisia) << "client left the bus:" << service;
+
+    d->clientWatcher->removeWatchedService(service);
+
+    // the service was started for this client only
+    if (service == d->client) {
+        quit();
+        return;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (CvsJob *job : qAsConst(d->cvsJobs)) {
+        if (job->owner() == service)
+            d->orphanedJobs.insert(job, now);
+    }
+
+    if (!d->orphanedJobs.isEmpty())
+        d->reapTimer->start();
 }
 
-CvsJob *CvsService::Private::createCvsJob()
+void CvsService::slotReapOrphanedJobs()
+{
+    d->reapOrphanedJobs();
+}
+
+CvsJob *CvsService::Private::newCvsJob(const char *command)
 {
     ++lastJobId;
 
-    // create a cvs job
     auto job = new CvsJob(lastJobId);
+    job->setCommandName(QLatin1String(command));
+    job->setStatistics(statistics);
     cvsJobs.insert(lastJobId, job);
+    QObject::connect(job, SIGNAL(destroyed(QObject *)), q, SLOT(slotJobDestroyed(QObject *)));
+
+    // only the client in our process uses the job, it connects directly
+    if (mode == InProcess)
+        job->stopSignalRelay();
+
+    // remember the client, so that we can clean up when it leaves the bus
+    if (q->calledFromDBus()) {
+        const QString owner = q->message().service();
+        job->setOwner(owner);
+        if (!clientWatcher->watchedServices().contains(owner))
+            clientWatcher->addWatchedService(owner);
+    }
+
+    return job;
+}
+
+void CvsService::Private::reapOrphanedJobs()
+{
+    const QDateTime limit = QDateTime::currentDateTimeUtc().addSecs(-ORPHANED_JOB_TIMEOUT);
+
+    for (auto it = orphanedJobs.begin(); it != orphanedJobs.end();) {
+        CvsJob *job = it.key();
+        if (!job->isRunning() && it.value() < limit) {
+            qCDebug(log_cervisia) << "reaping orphaned job" << job->dbusObjectPath();
+            it = orphanedJobs.erase(it);
+            job->release();
+        } else {
+            ++it;
+        }
+    }
+
+    if (orphanedJobs.isEmpty())
+        reapTimer->stop();
+}
+
+CvsJob *CvsService::Private::createCvsJob(const char *command)
+{
+    // create a cvs job
+    CvsJob *job = newCvsJob(command);
 
     job->setRSH(repository->rsh());
     job->setServer(repository->server());
     job->setDirectory(repository->workingCopy());
+    job->setCompressionTuner(repository->compressionTuner(), repository->location());
+    job->setSshAgent(sshAgentFor(repository));
 
     return job;
 }
 
-QDBusObjectPath CvsService::Private::setupNonConcurrentJob(Repository *repo)
+QDBusObjectPath CvsService::Private::setupNonConcurrentJob(const char *command, Repository *repo)
 {
     // no explicit repository provided?
     if (!repo)
         repo = repository;
 
+    singleCvsJob->setCommandName(QLatin1String(command));
     singleCvsJob->setRSH(repo->rsh());
     singleCvsJob->setServer(repo->server());
     singleCvsJob->setDirectory(repo->workingCopy());
+    singleCvsJob->setCompressionTuner(repo->compressionTuner(), repo->location());
+    singleCvsJob->setSshAgent(sshAgentFor(repo));
 
     return QDBusObjectPath(singleCvsJob->dbusObjectPath());
 }
 
+SshAgent *CvsService::Private::sshAgentFor(const Repository *repo) const
+{
+    // only jobs which connect via ssh have to wait for the agent
+    if (repo->location().contains(":ext:", Qt::CaseInsensitive))
+        return sshAgent;
+
+    return 0;
+}
+
+QString CvsService::Private::resultCacheKey(const QString &fileName, const QStringList &request)
+{
+    // no key means no caching
+    if (!resultCache.isEnabled())
+        return QString();
+
+    // identify the file by its place in the repository, as working
+    // copies of the same module share the results
+    const QFileInfo fi(QDir(repository->workingCopy()), fileName);
+
+    QFile file(fi.absolutePath() + QLatin1String("/CVS/Repository"));
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    const QString module = QString::fromLocal8Bit(file.readLine()).trimmed();
+    if (module.isEmpty())
+        return QString();
+
+    return ResultCache::key(QStringList() << repository->location() << module << fi.fileName() << request);
+}
+
+QString CvsService::Private::downloadRevisionCommand(CvsJob *job, const QString &fileName, const QString &revision, const QString &outputFile)
+{
+    // the content of a numeric revision never changes
+    if (ResultCache::isNumericRevision(revision)) {
+        const QString cacheKey = resultCacheKey(fileName, QStringList() << "update -p" << revision);
+        const QString cachedResult = resultCache.lookup(cacheKey);
+        if (!cachedResult.isEmpty())
+            return QLatin1String("cp ") + KShell::quoteArg(cachedResult) + QLatin1Char(' ') + KShell::quoteArg(outputFile);
+        if (!cacheKey.isEmpty())
+            job->addResultCacheEntry(&resultCache, cacheKey, outputFile);
+    }
+
+    job->setCommandName(QStringLiteral("update"));
+
+    QString command = repository->cvsClient() + QLatin1String(" update -p");
+    if (!revision.isEmpty())
+        command += QLatin1String(" -r ") + KShell::quoteArg(revision);
+
+    return command + QLatin1Char(' ') + KShell::quoteArg(fileName) + QLatin1String(" > ") + KShell::quoteArg(outputFile);
+}
+
 bool CvsService::Private::hasWorkingCopy()
 {
     if (repository->workingCopy().isEmpty()) {
@@ -21,20 +21,36 @@
 #ifndef CVSSERVICE_H
 #define CVSSERVICE_H
 
+#include <QDBusContext>
 #include <QDBusObjectPath>
 #include <qobject.h>
 #include <qstringlist.h>
 
 class QString;
 
-class Q_DECL_EXPORT CvsService : public QObject
+class Q_DECL_EXPORT CvsService : public QObject, protected QDBusContext
 {
     Q_OBJECT
 
 public:
-    CvsService();
+    enum Mode {
+        Standalone, ///< runs as the cvsservice5 process
+        InProcess ///< runs inside the process of the client (see CervisiaPart)
+    };
+
+    explicit CvsService(Mode mode = Standalone);
     ~CvsService() override;
 
+    /**
+     * Tells @p client, which started the service, under which name the
+     * service is registered on the bus. The service quits when the client
+     * leaves the bus.
+     *
+     * @param client The base service of the client.
+     * @param startupId The id the client passed on the command line.
+     */
+    void announce(const QString &client, const QString &startupId);
+
 public Q_SLOTS:
     /**
      * Adds new files to an existing project. The files don't actually
@@ -237,6 +253,29 @@ public Q_SLOTS:
      */
     QDBusObjectPath log(const QString &fileName);
 
+    /**
+     * Shows only the header of the log of a file, i.e. the symbolic names
+     * and the number of revisions, but no revisions (cvs log -h).
+     *
+     * @param fileName the name of the file to show the header for
+     *
+     * @return A DCOP reference to the cvs job or in case of failure a
+     *         null reference.
+     */
+    QDBusObjectPath logHeader(const QString &fileName);
+
+    /**
+     * Shows log messages for the revisions of a file which were committed
+     * at or after @p date.
+     *
+     * @param fileName the name of the file to show log messages for
+     * @param date a date cvs understands, e.g. "2010-05-31 12:00:00 UTC"
+     *
+     * @return A DCOP reference to the cvs job or in case of failure a
+     *         null reference.
+     */
+    QDBusObjectPath logSince(const QString &fileName, const QString &date);
+
     /**
      * @param repository
      *
@@ -291,6 +330,29 @@ public Q_SLOTS:
      */
     QDBusObjectPath rlog(const QString &repository, const QString &module, bool recursive);
 
+    /**
+     * Shows only the headers of the logs of the files in @p module
+     * (recursively), i.e. their symbolic names but no log messages. This
+     * is the cheapest way to learn all tags and branches of a module.
+     *
+     * @return A DCOP reference to the cvs job or in case of failure a
+     *         null reference.
+     */
+    QDBusObjectPath rlogHeader(const QString &repository, const QString &module);
+
+    /**
+     * Shows the log messages of the revisions in @p module (recursively)
+     * which were committed at or after @p date. The revisions before are
+     * left out, so a client which keeps the log only needs to ask for the
+     * new ones.
+     *
+     * @param date a date cvs understands, e.g. "2010-05-31 12:00:00 UTC"
+     *
+     * @return A DCOP reference to the cvs job or in case of failure a
+     *         null reference.
+     */
+    QDBusObjectPath rlogSince(const QString &repository, const QString &module, const QString &date);
+
     /**
      * Shows a summary of what's been done locally, without changing the
      * working copy. (cvs -n update)
@@ -348,11 +410,46 @@ public Q_SLOTS:
      */
     QDBusObjectPath watchers(const QStringList &files);
 
+    /**
+     * @return The approximate number of bytes of memory used by the
+     *         retained output of all jobs of this service.
+     */
+    qlonglong memoryUsage() const;
+
+    /**
+     * @return The number of cvs jobs currently held by the service.
+     */
+    int jobCount() const;
+
+    /**
+     * Switches the cache for immutable results (e.g. the diff between two
+     * numeric revisions) on or off. When it is off, every request is sent
+     * to the server.
+     */
+    void setResultCacheEnabled(bool enabled);
+
+    /**
+     * Removes all entries from the result cache.
+     */
+    void clearResultCache();
+
     /**
      * Quits the service.
      */
     void quit();
 
+Q_SIGNALS:
+    /**
+     * Emitted by announce(). The client matches @p startupId against the
+     * id it started the service with.
+     */
+    void serviceStarted(const QString &startupId, const QString &serviceName);
+
+private Q_SLOTS:
+    void slotJobDestroyed(QObject *job);
+    void slotClientUnregistered(const QString &service);
+    void slotReapOrphanedJobs();
+
 private:
     struct Private;
     Private *d;
@@ -41,3 +41,35 @@ QString CvsServiceUtils::joinFileList(const QStringList &files)
 
     return result;
 }
+
+QStringList CvsServiceUtils::joinFileListBatches(const QStringList &files, int maxLength)
+{
+    QStringList batches;
+    QString batch;
+    int batchLength = 0;
+
+    for (const QString &file : files) {
+        const QString arg = KShell::quoteArg(file);
+        const int length = arg.toLocal8Bit().size() + 1;
+
+        if (!batch.isEmpty() && batchLength + length > maxLength) {
+            batches.append(batch);
+            batch.clear();
+            batchLength = 0;
+        }
+
+        if (!batch.isEmpty())
+            batch += ' ';
+        batch += arg;
+        batchLength += length;
+    }
+
+    batches.append(batch);
+
+    return batches;
+}
+
+KSharedConfig::Ptr CvsServiceUtils::serviceConfig()
+{
+    return KSharedConfig::openConfig(QStringLiteral("cvsservicerc"));
+}
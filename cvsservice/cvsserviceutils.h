@@ -21,6 +21,7 @@
 #ifndef CVSSERVICE_UTILS_H
 #define CVSSERVICE_UTILS_H
 
+#include <KSharedConfig>
 #include <QStringList>
 class QString;
 
@@ -32,6 +33,20 @@ namespace CvsServiceUtils
  * each name properly for usage with QProcess.
  */
 QString joinFileList(const QStringList &files);
+
+/**
+ * Like joinFileList(), but splits the list into batches whose joined
+ * length (in the local 8-bit encoding) doesn't exceed @p maxLength,
+ * unless a single name is longer. Always returns at least one batch.
+ */
+QStringList joinFileListBatches(const QStringList &files, int maxLength);
+
+/**
+ * Returns the configuration shared with the settings dialogs of Cervisia.
+ * It is opened by name, so that the service reads the same file whether
+ * it runs in its own process or inside the part.
+ */
+KSharedConfig::Ptr serviceConfig();
 }
 
 #endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "jobstatistics.h"
+
+#include <QDBusConnection>
+#include <QHash>
+#include <QMap>
+#include <QVector>
+
+#include <algorithm>
+
+#include <jobstatisticsadaptor.h>
+
+// only the most recent samples of each value are kept
+static const int MAX_SAMPLES = 256;
+
+// the values of CvsJob::statistics() which are aggregated
+static const char *const SAMPLED_VALUES[] =
+    {"queueTime", "spawnTime", "firstByteTime", "runTime", "cpuTime", "compressionLevel", "stdoutBytes", "stdoutLines", "stderrBytes", "stderrLines"};
+
+namespace
+{
+struct CommandStatistics {
+    CommandStatistics()
+        : count(0)
+    {
+    }
+
+    void add(const QString &name, qlonglong value)
+    {
+        QVector<qlonglong> &values = samples[name];
+        if (values.size() >= MAX_SAMPLES)
+            values.remove(0);
+        values.append(value);
+    }
+
+    int count;
+    QMap<QString, QVector<qlonglong>> samples;
+};
+
+qlonglong percentile(const QVector<qlonglong> &sorted, int p)
+{
+    // nearest-rank method
+    const int rank = (p * sorted.size() + 99) / 100;
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+}
+
+struct JobStatistics::Private {
+    QHash<QString, CommandStatistics> commands;
+};
+
+JobStatistics::JobStatistics(QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    (void)new JobstatisticsAdaptor(this);
+    QDBusConnection::sessionBus().registerObject("/JobStatistics", this);
+}
+
+JobStatistics::~JobStatistics()
+{
+    delete d;
+}
+
+void JobStatistics::addJob(const QVariantMap &statistics)
+{
+    CommandStatistics &command = d->commands[statistics.value("command").toString()];
+    ++command.count;
+
+    for (const char *name : SAMPLED_VALUES) {
+        const QVariant value = statistics.value(name);
+        // e.g. no first byte when the job had no output
+        if (value.isValid() && value.toLongLong() >= 0)
+            command.add(name, value.toLongLong());
+    }
+}
+
+void JobStatistics::addClientTime(const QString &command, qlonglong msecs)
+{
+    d->commands[command].add("clientTime", msecs);
+}
+
+QStringList JobStatistics::commands() const
+{
+    QStringList result = d->commands.keys();
+    result.sort();
+    return result;
+}
+
+QVariantMap JobStatistics::summary(const QString &command) const
+{
+    QVariantMap result;
+
+    const auto it = d->commands.constFind(command);
+    if (it == d->commands.constEnd())
+        return result;
+
+    result.insert("count", it->count);
+
+    for (auto sample = it->samples.constBegin(); sample != it->samples.constEnd(); ++sample) {
+        QVector<qlonglong> sorted = sample.value();
+        if (sorted.isEmpty())
+            continue;
+        std::sort(sorted.begin(), sorted.end());
+
+        result.insert(sample.key() + ".p50", percentile(sorted, 50));
+        result.insert(sample.key() + ".p90", percentile(sorted, 90));
+        result.insert(sample.key() + ".p99", percentile(sorted, 99));
+    }
+
+    return result;
+}
+
+void JobStatistics::reset()
+{
+    d->commands.clear();
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef JOBSTATISTICS_H
+#define JOBSTATISTICS_H
+
+#include <QStringList>
+#include <QVariantMap>
+#include <qobject.h>
+
+/**
+ * Collects the timings of the finished cvs jobs of the service, grouped by
+ * cvs command, and provides percentiles of them over D-Bus.
+ */
+class Q_DECL_EXPORT JobStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JobStatistics(QObject *parent = nullptr);
+    ~JobStatistics() override;
+
+    /**
+     * Adds the statistics of a finished job (see CvsJob::statistics()).
+     */
+    void addJob(const QVariantMap &statistics);
+
+    /**
+     * Adds the time the client needed to process the output of a job.
+     */
+    void addClientTime(const QString &command, qlonglong msecs);
+
+public Q_SLOTS: // dbus function
+    /**
+     * @return The cvs commands for which statistics exist.
+     */
+    QStringList commands() const;
+
+    /**
+     * Returns the number of jobs ("count") and for every measured value
+     * (e.g. "spawnTime") its 50th, 90th and 99th percentile under the
+     * keys "spawnTime.p50", "spawnTime.p90" and "spawnTime.p99".
+     */
+    QVariantMap summary(const QString &command) const;
+
+    void reset();
+
+private:
+    struct Private;
+    Private *d;
+};
+
+#endif
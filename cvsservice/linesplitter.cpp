@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "linesplitter.h"
+
+LineSplitter::LineSplitter()
+    : m_pos(0)
+    , m_searchPos(0)
+    , m_isFinished(false)
+{
+}
+
+void LineSplitter::append(const QString &chunk)
+{
+    // drop the consumed text when it's at least half of the buffer, so
+    // each character is moved at most once on average
+    if (m_pos > 0 && m_pos >= m_buffer.size() - m_pos) {
+        m_buffer.remove(0, m_pos);
+        m_searchPos -= m_pos;
+        m_pos = 0;
+    }
+
+    m_buffer += chunk;
+    m_isFinished = false;
+}
+
+void LineSplitter::finish()
+{
+    m_isFinished = true;
+}
+
+bool LineSplitter::nextLine(QStringView *line)
+{
+    const int newline = m_buffer.indexOf(QLatin1Char('\n'), m_searchPos);
+    if (newline < 0) {
+        // remember that the rest doesn't contain a newline
+        m_searchPos = m_buffer.size();
+
+        if (!m_isFinished || m_pos >= m_buffer.size())
+            return false;
+
+        *line = QStringView(m_buffer).mid(m_pos);
+        m_pos = m_searchPos;
+        return true;
+    }
+
+    *line = QStringView(m_buffer).mid(m_pos, newline - m_pos);
+    m_pos = m_searchPos = newline + 1;
+    return true;
+}
+
+void LineSplitter::clear()
+{
+    m_buffer.clear();
+    m_pos = m_searchPos = 0;
+    m_isFinished = false;
+}
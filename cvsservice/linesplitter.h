@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef LINESPLITTER_H
+#define LINESPLITTER_H
+
+#include <QString>
+#include <QStringView>
+
+/**
+ * Splits text which arrives in chunks into lines.
+ *
+ * The chunks are appended to one buffer and nextLine() returns views into
+ * it, so nothing is copied per line unless the caller converts the view
+ * to a QString. The consumed part of the buffer is only dropped when it
+ * makes up the larger half, which keeps the cost of splitting linear in
+ * the size of the text.
+ *
+ * A line spanning several chunks is returned once it is complete; lines
+ * are returned without the terminating newline. Only the newline ends a
+ * line, a carriage return before it is kept.
+ */
+class LineSplitter
+{
+public:
+    LineSplitter();
+
+    /**
+     * Adds the next chunk of text. Invalidates the views returned so far.
+     */
+    void append(const QString &chunk);
+
+    /**
+     * Marks the end of the text. A remaining incomplete line is returned
+     * by the next call of nextLine().
+     */
+    void finish();
+
+    /**
+     * Gets the next complete line.
+     *
+     * @return false if there is no complete line (yet).
+     */
+    bool nextLine(QStringView *line);
+
+    /**
+     * @return true if there is text which isn't returned as line yet.
+     */
+    bool hasPendingText() const
+    {
+        return m_pos < m_buffer.size();
+    }
+
+    void clear();
+
+private:
+    QString m_buffer;
+    int m_pos; // start of the first line not returned yet
+    int m_searchPos; // where the search for the next newline continues
+    bool m_isFinished;
+};
+
+#endif
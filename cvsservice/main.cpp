@@ -19,6 +19,7 @@
  */
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 #include <KLocalizedString>
 #include <kaboutdata.h>
@@ -45,10 +46,24 @@ int main(int argc, char **argv)
 
     KAboutData::setApplicationData(about);
 
+    QCommandLineParser parser;
+    about.setupCommandLine(&parser);
+
+    parser.addOption(QCommandLineOption(QLatin1String("client"), i18n("D-Bus name of the client that started the service."), QLatin1String("name")));
+    parser.addOption(QCommandLineOption(QLatin1String("startup-id"), i18n("Id to announce the service name with."), QLatin1String("id")));
+
+    parser.process(app);
+    about.processCommandLine(&parser);
+
     // Don't quit if password dialog for login is closed
     app.setQuitOnLastWindowClosed(false);
 
     CvsService service;
 
+    // tell the client which started us our name on the bus
+    const QString client = parser.value(QLatin1String("client"));
+    if (!client.isEmpty())
+        service.announce(client, parser.value(QLatin1String("startup-id")));
+
     return app.exec();
 }
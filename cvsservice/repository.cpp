@@ -31,12 +31,19 @@
 #include <kdirwatch.h>
 #include <ksharedconfig.h>
 
+#include "compressiontuner.h"
+#include "cvsserviceutils.h"
 #include "sshagent.h"
 #include <repositoryadaptor.h>
 
 struct Repository::Private {
     Private()
         : compressionLevel(0)
+        , adaptiveCompression(false)
+        , minCompressionLevel(0)
+        , maxCompressionLevel(9)
+        , compressionTuner(0)
+        , sshAgent(0)
     {
     }
 
@@ -49,8 +56,14 @@ struct Repository::Private {
     QString rsh;
     QString server;
     int compressionLevel;
+    bool adaptiveCompression;
+    int minCompressionLevel;
+    int maxCompressionLevel;
     bool retrieveCvsignoreFile;
 
+    CompressionTuner *compressionTuner;
+    SshAgent *sshAgent;
+
     void readConfig();
     void readGeneralConfig();
 };
@@ -95,6 +108,24 @@ Repository::~Repository()
     delete d;
 }
 
+void Repository::setCompressionTuner(CompressionTuner *tuner)
+{
+    d->compressionTuner = tuner;
+}
+
+CompressionTuner *Repository::compressionTuner() const
+{
+    if (d->adaptiveCompression && CompressionTuner::isRemote(d->location))
+        return d->compressionTuner;
+
+    return 0;
+}
+
+void Repository::setSshAgent(SshAgent *agent)
+{
+    d->sshAgent = agent;
+}
+
 QString Repository::cvsClient() const
 {
     QString client(d->client);
@@ -102,9 +133,13 @@ QString Repository::cvsClient() const
     // suppress reading of the '.cvsrc' file
     client += " -f";
 
+    int compressionLevel = d->compressionLevel;
+    if (CompressionTuner *tuner = compressionTuner())
+        compressionLevel = tuner->level(d->location, compressionLevel, d->minCompressionLevel, d->maxCompressionLevel);
+
     // we don't need the command line option if there is no compression level set
-    if (d->compressionLevel > 0) {
-        client += " -z" + QString::number(d->compressionLevel) + ' ';
+    if (compressionLevel > 0) {
+        client += " -z" + QString::number(compressionLevel) + ' ';
     }
 
     return client;
@@ -147,12 +182,10 @@ bool Repository::setWorkingCopy(const QString &dirName)
     }
     rootFile.close();
 
-    // add identities (ssh-add) to ssh-agent
-    // TODO CL make sure this is called only once
-    if (d->location.contains(":ext:", Qt::CaseInsensitive)) {
-        SshAgent ssh;
-        ssh.addSshIdentities();
-    }
+    // add identities (ssh-add) to ssh-agent, this happens in the background
+    // while the client scans the working copy
+    if (d->sshAgent && d->location.contains(":ext:", Qt::CaseInsensitive))
+        d->sshAgent->addSshIdentities();
 
     QDir::setCurrent(path);
     d->readConfig();
@@ -179,7 +212,7 @@ void Repository::slotConfigDirty(const QString &fileName)
 {
     if (fileName == d->configFileName) {
         // reread the configuration data from disk
-        KSharedConfig::openConfig()->reparseConfiguration();
+        CvsServiceUtils::serviceConfig()->reparseConfiguration();
         d->readConfig();
     }
 }
@@ -187,13 +220,13 @@ void Repository::slotConfigDirty(const QString &fileName)
 void Repository::Private::readGeneralConfig()
 {
     // get path to cvs client program
-    KConfigGroup cg(KSharedConfig::openConfig(), "General");
+    KConfigGroup cg(CvsServiceUtils::serviceConfig(), "General");
     client = cg.readPathEntry("CVSPath", "cvs");
 }
 
 void Repository::Private::readConfig()
 {
-    KSharedConfig::Ptr config = KSharedConfig::openConfig();
+    KSharedConfig::Ptr config = CvsServiceUtils::serviceConfig();
 
     // Sometimes the location can be unequal to the entry in the CVS/Root.
     //
@@ -229,11 +262,16 @@ void Repository::Private::readConfig()
     compressionLevel = group.readEntry("Compression", -1);
 
     // use default global compression level instead?
+    KConfigGroup cs(config, "General");
     if (compressionLevel < 0) {
-        KConfigGroup cs(config, "General");
         compressionLevel = cs.readEntry("Compression", 0);
     }
 
+    // let the service choose the level within the given bounds?
+    adaptiveCompression = group.readEntry("AdaptiveCompression", cs.readEntry("AdaptiveCompression", false));
+    minCompressionLevel = group.readEntry("MinCompression", cs.readEntry("MinCompression", 0));
+    maxCompressionLevel = group.readEntry("MaxCompression", cs.readEntry("MaxCompression", 9));
+
     // get remote shell client to access the remote repository
     rsh = group.readPathEntry("rsh", QString());
 
@@ -24,6 +24,8 @@
 #include <qobject.h>
 
 class QString;
+class CompressionTuner;
+class SshAgent;
 
 /**
  * Represents a local or remote cvs repository with
@@ -37,6 +39,24 @@ public:
     explicit Repository(const QString &repository);
     ~Repository() override;
 
+    /**
+     * Lets @p tuner choose the compression level of repositories for
+     * which adaptive compression is enabled.
+     */
+    void setCompressionTuner(CompressionTuner *tuner);
+
+    /**
+     * @return The tuner when it chooses the compression level of the
+     *         current repository, otherwise 0.
+     */
+    CompressionTuner *compressionTuner() const;
+
+    /**
+     * @p agent loads the identities when a working copy with :ext: access
+     * is opened.
+     */
+    void setSshAgent(SshAgent *agent);
+
 public Q_SLOTS:
     /**
      * cvs command (including the user-specified path) with the options
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "resultcache.h"
+
+#include "../debug.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+
+#include <algorithm>
+
+// files which are still being written have this suffix
+static const char PARTIAL_SUFFIX[] = ".part";
+
+ResultCache::ResultCache()
+    : m_maximumSize(64 * 1024 * 1024)
+    , m_size(-1)
+    , m_enabled(true)
+{
+    // shared by the cvsservice process and the in-process service
+    m_directory = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/results");
+    QDir().mkpath(m_directory);
+}
+
+void ResultCache::setMaximumSize(qint64 bytes)
+{
+    m_maximumSize = bytes;
+    if (m_size > m_maximumSize)
+        evict();
+}
+
+bool ResultCache::isNumericRevision(const QString &revision)
+{
+    const QStringList numbers = revision.split('.');
+
+    // branch numbers (odd count or magic branch x.y.0.z) move
+    if (numbers.count() < 2 || numbers.count() % 2 != 0)
+        return false;
+
+    for (const QString &number : numbers) {
+        bool ok = false;
+        number.toUInt(&ok);
+        if (!ok)
+            return false;
+    }
+
+    return numbers.at(numbers.count() - 2) != QLatin1String("0");
+}
+
+QString ResultCache::key(const QStringList &request)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &part : request) {
+        hash.addData(part.toUtf8());
+        // separate the parts, so that ("ab", "c") != ("a", "bc")
+        hash.addData("\0", 1);
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString ResultCache::lookup(const QString &key)
+{
+    if (!m_enabled || key.isEmpty())
+        return QString();
+
+    const QString path = entryPath(key);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    // the modification time is the time of the last use
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    qCDebug(log_cervisia) << "result cache hit:" << key;
+    return path;
+}
+
+bool ResultCache::insert(const QString &key, const QString &fileName)
+{
+    if (!m_enabled || key.isEmpty())
+        return false;
+
+    const QString path = entryPath(key);
+    QFile::remove(path);
+    if (!QFile::rename(fileName, path))
+        return false;
+
+    added(path);
+    return true;
+}
+
+bool ResultCache::insertCopy(const QString &key, const QString &fileName)
+{
+    if (!m_enabled || key.isEmpty())
+        return false;
+
+    // copy to a partial file first, so that other service instances
+    // never see an incomplete entry
+    QTemporaryFile partial(m_directory + QLatin1String("/XXXXXX") + QLatin1String(PARTIAL_SUFFIX));
+    QFile source(fileName);
+    if (!partial.open() || !source.open(QIODevice::ReadOnly))
+        return false;
+
+    while (!source.atEnd()) {
+        const QByteArray data = source.read(64 * 1024);
+        if (data.isEmpty() || partial.write(data) != data.size())
+            return false;
+    }
+    partial.close();
+
+    if (!insert(key, partial.fileName()))
+        return false;
+
+    partial.setAutoRemove(false);
+    return true;
+}
+
+void ResultCache::clear()
+{
+    QDir dir(m_directory);
+    const QStringList entries = dir.entryList(QDir::Files);
+    for (const QString &entry : entries) {
+        if (!entry.endsWith(QLatin1String(PARTIAL_SUFFIX)))
+            dir.remove(entry);
+    }
+
+    m_size = 0;
+}
+
+QString ResultCache::entryPath(const QString &key) const
+{
+    return m_directory + QLatin1Char('/') + key;
+}
+
+void ResultCache::added(const QString &path)
+{
+    // the size of the cache directory is only determined when needed
+    if (m_size < 0)
+        evict();
+    else
+        m_size += QFileInfo(path).size();
+
+    if (m_size > m_maximumSize)
+        evict();
+}
+
+void ResultCache::evict()
+{
+    // other service instances use the same directory, so rescan it
+    QDir dir(m_directory);
+    QFileInfoList entries = dir.entryInfoList(QDir::Files);
+
+    m_size = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->fileName().endsWith(QLatin1String(PARTIAL_SUFFIX))) {
+            it = entries.erase(it);
+        } else {
+            m_size += it->size();
+            ++it;
+        }
+    }
+
+    if (m_size <= m_maximumSize)
+        return;
+
+    // remove the least recently used entries
+    std::sort(entries.begin(), entries.end(), [](const QFileInfo &a, const QFileInfo &b) {
+        return a.lastModified() < b.lastModified();
+    });
+
+    for (const QFileInfo &entry : qAsConst(entries)) {
+        if (m_size <= m_maximumSize)
+            break;
+
+        if (dir.remove(entry.fileName()))
+            m_size -= entry.size();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <qstring.h>
+#include <qstringlist.h>
+
+/**
+ * Persistent cache for the output of cvs commands which never changes,
+ * e.g. the diff between two numeric revisions. Each entry is a file in
+ * the cache directory, named after the hash of the request. The cache is
+ * shared by all service instances and bounded in size; the least recently
+ * used entries are removed first.
+ */
+class ResultCache
+{
+public:
+    ResultCache();
+
+    bool isEnabled() const
+    {
+        return m_enabled;
+    }
+    void setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    void setMaximumSize(qint64 bytes);
+
+    QString directory() const
+    {
+        return m_directory;
+    }
+
+    /**
+     * @return true if @p revision is a numeric revision like 1.2.4.1.
+     *         Tags and branch names can move, so their results must not
+     *         be cached.
+     */
+    static bool isNumericRevision(const QString &revision);
+
+    /**
+     * Builds the key of an entry from the parts of the request (repository,
+     * file, command, options and revisions).
+     */
+    static QString key(const QStringList &request);
+
+    /**
+     * @return The path of the entry for @p key or a null string if there is
+     *         none. The entry is marked as recently used.
+     */
+    QString lookup(const QString &key);
+
+    /**
+     * Moves the file @p fileName into the cache as entry for @p key.
+     */
+    bool insert(const QString &key, const QString &fileName);
+
+    /**
+     * Copies the file @p fileName into the cache as entry for @p key.
+     */
+    bool insertCopy(const QString &key, const QString &fileName);
+
+    void clear();
+
+private:
+    QString entryPath(const QString &key) const;
+    void added(const QString &path);
+    void evict();
+
+    QString m_directory;
+    qint64 m_maximumSize;
+    qint64 m_size; // -1 until the directory was scanned
+    bool m_enabled;
+};
+
+#endif
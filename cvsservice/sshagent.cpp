@@ -23,18 +23,27 @@
 
 #include <kprocess.h>
 #include <qregexp.h>
+#include <qtimer.h>
 
 #include <csignal>
 
+// time (in ms) after which ssh-add is stopped
+static const int IDENTITIES_TIMEOUT = 5 * 60 * 1000;
+
 // initialize static member variables
 bool SshAgent::m_isRunning = false;
 bool SshAgent::m_isOurAgent = false;
+bool SshAgent::m_isStarting = false;
+bool SshAgent::m_identitiesRequested = false;
+bool SshAgent::m_isAddingIdentities = false;
+bool SshAgent::m_identitiesAdded = false;
 QString SshAgent::m_authSock;
 QString SshAgent::m_pid;
 
 SshAgent::SshAgent(QObject *parent)
     : QObject(parent)
     , m_agentProcess(0)
+    , m_addProcess(0)
 {
 }
 
@@ -44,7 +53,7 @@ bool SshAgent::querySshAgent()
 {
     qCDebug(log_cervisia) << "ENTER";
 
-    if (m_isRunning)
+    if (m_isRunning || m_isStarting)
         return true;
 
     // Did the user already start a ssh-agent process?
@@ -66,37 +75,34 @@ bool SshAgent::querySshAgent()
         qCDebug(log_cervisia) << "start ssh-agent";
 
         m_isOurAgent = true;
-        m_isRunning = startSshAgent();
+        m_isStarting = startSshAgent();
     }
 
-    return m_isRunning;
+    return m_isRunning || m_isStarting;
 }
 
-bool SshAgent::addSshIdentities()
+void SshAgent::addSshIdentities()
 {
     qCDebug(log_cervisia) << "ENTER";
 
-    if (!m_isRunning || !m_isOurAgent)
-        return false;
-
-    // add identities to ssh-agent
-    KProcess proc;
-
-    proc.setEnv("SSH_AGENT_PID", m_pid);
-    proc.setEnv("SSH_AUTH_SOCK", m_authSock);
-    proc.setEnv("SSH_ASKPASS", "cvsaskpass");
-
-    proc << "ssh-add";
+    if (m_identitiesAdded || m_isAddingIdentities || m_identitiesRequested)
+        return;
 
-    proc.start();
+    // the agent isn't there yet
+    if (m_isStarting && m_isOurAgent) {
+        m_identitiesRequested = true;
+        return;
+    }
 
-    // wait for process to finish
-    // TODO CL use timeout?
-    proc.waitForFinished();
+    if (!m_isRunning || !m_isOurAgent)
+        return;
 
-    qCDebug(log_cervisia) << "added identities";
+    startSshAdd();
+}
 
-    return (proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0);
+bool SshAgent::isReady() const
+{
+    return !m_isStarting && !m_identitiesRequested && !m_isAddingIdentities;
 }
 
 void SshAgent::killSshAgent()
@@ -121,7 +127,11 @@ void SshAgent::slotProcessFinished()
     QRegExp bashPidRx("SSH_AGENT_PID=(\\d*).*");
     QRegExp bashSockRx("SSH_AUTH_SOCK=(.*\\.\\d*);.*");
 
-    foreach (const QString &line, m_outputLines) {
+    m_output.finish();
+
+    QStringView view;
+    while (m_output.nextLine(&view)) {
+        const QString line = view.toString();
         if (m_pid.isEmpty()) {
             if (line.contains(cshPidRx)) {
                 m_pid = cshPidRx.cap(1);
@@ -148,13 +158,45 @@ void SshAgent::slotProcessFinished()
     }
 
     qCDebug(log_cervisia) << "pid=" << m_pid << ", socket=" << m_authSock;
+
+    m_isStarting = false;
+    m_isRunning = m_agentProcess->exitStatus() == QProcess::NormalExit && m_agentProcess->exitCode() == 0 && !m_pid.isEmpty();
+
+    m_agentProcess->deleteLater();
+    m_agentProcess = 0;
+
+    if (m_identitiesRequested) {
+        m_identitiesRequested = false;
+        if (m_isRunning) {
+            startSshAdd();
+            return;
+        }
+    }
+
+    Q_EMIT ready();
+}
+
+void SshAgent::slotIdentitiesAdded()
+{
+    qCDebug(log_cervisia) << "added identities, exit code =" << m_addProcess->exitCode();
+
+    m_isAddingIdentities = false;
+
+    // when ssh-add failed or was killed after the timeout, the next job
+    // which needs the agent asks for the passphrase again
+    m_identitiesAdded = m_addProcess->exitStatus() == QProcess::NormalExit && m_addProcess->exitCode() == 0;
+
+    m_addProcess->deleteLater();
+    m_addProcess = 0;
+
+    Q_EMIT ready();
 }
 
 void SshAgent::slotReceivedOutput()
 {
     const QString output(QString::fromLocal8Bit(m_agentProcess->readAllStandardOutput()));
 
-    m_outputLines += output.split('\n');
+    m_output.append(output);
 
     qCDebug(log_cervisia) << "output=" << output;
 }
@@ -172,9 +214,42 @@ bool SshAgent::startSshAgent()
     m_agentProcess->setProgram(QLatin1String("ssh-agent"));
     m_agentProcess->start();
 
-    // wait for process to finish
-    // TODO CL use timeout?
-    m_agentProcess->waitForFinished();
+    // the agent forks and the started process exits, slotProcessFinished()
+    // then reads the environment from its output
+    if (!m_agentProcess->waitForStarted()) {
+        delete m_agentProcess;
+        m_agentProcess = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void SshAgent::startSshAdd()
+{
+    qCDebug(log_cervisia) << "ENTER";
+
+    m_addProcess = new KProcess(this);
+
+    m_addProcess->setEnv("SSH_AGENT_PID", m_pid);
+    m_addProcess->setEnv("SSH_AUTH_SOCK", m_authSock);
+    m_addProcess->setEnv("SSH_ASKPASS", "cvsaskpass");
+
+    *m_addProcess << "ssh-add";
+
+    connect(m_addProcess, SIGNAL(finished(int, QProcess::ExitStatus)), SLOT(slotIdentitiesAdded()));
+
+    m_addProcess->start();
+
+    if (!m_addProcess->waitForStarted()) {
+        delete m_addProcess;
+        m_addProcess = 0;
+        Q_EMIT ready();
+        return;
+    }
+
+    m_isAddingIdentities = true;
 
-    return (m_agentProcess->exitStatus() == QProcess::NormalExit && m_agentProcess->exitCode() == 0);
+    // don't keep the jobs waiting forever, when nobody enters the passphrase
+    QTimer::singleShot(IDENTITIES_TIMEOUT, m_addProcess, SLOT(kill()));
 }
@@ -25,8 +25,15 @@
 #include <qstring.h>
 #include <qstringlist.h>
 
+#include "linesplitter.h"
+
 class KProcess;
 
+/**
+ * Finds a running ssh-agent or starts a new one and adds the identities
+ * to it. Both happen in the background; the state is shared by all
+ * instances, but only the instance which does the work emits ready().
+ */
 class SshAgent : public QObject
 {
     Q_OBJECT
@@ -35,10 +42,26 @@ public:
     explicit SshAgent(QObject *parent = nullptr);
     ~SshAgent() override;
 
+    /**
+     * Uses the ssh-agent of the session or starts a new one.
+     *
+     * @return false if no agent exists and none could be started.
+     */
     bool querySshAgent();
-    bool addSshIdentities();
+
+    /**
+     * Runs ssh-add for the agent we started. This is only done once,
+     * later calls do nothing.
+     */
+    void addSshIdentities();
+
     void killSshAgent();
 
+    /**
+     * @return false while the agent is started or identities are added.
+     */
+    bool isReady() const;
+
     bool isRunning() const
     {
         return m_isRunning;
@@ -52,19 +75,32 @@ public:
         return m_authSock;
     }
 
+Q_SIGNALS:
+    /**
+     * Emitted when isReady() becomes true.
+     */
+    void ready();
+
 private Q_SLOTS:
     void slotProcessFinished();
     void slotReceivedOutput();
+    void slotIdentitiesAdded();
 
 private:
     bool startSshAgent();
+    void startSshAdd();
 
-    QStringList m_outputLines;
+    LineSplitter m_output;
 
     KProcess *m_agentProcess;
+    KProcess *m_addProcess;
 
     static bool m_isRunning;
     static bool m_isOurAgent;
+    static bool m_isStarting;
+    static bool m_identitiesRequested; // ssh-add runs when the agent was started
+    static bool m_isAddingIdentities;
+    static bool m_identitiesAdded;
     static QString m_authSock;
     static QString m_pid;
 };
@@ -57,6 +57,9 @@
 DiffDialog::DiffDialog(KConfig &cfg, QWidget *parent, bool modal)
     : QDialog(parent)
     , partConfig(cfg)
+    , m_inHeader(true)
+    , m_linenoA(0)
+    , m_linenoB(0)
 {
     markeditem = -1;
     setModal(modal);
@@ -232,9 +235,6 @@ public:
 
 bool DiffDialog::parseCvsDiff(OrgKdeCervisia5CvsserviceCvsserviceInterface *service, const QString &fileName, const QString &revA, const QString &revB)
 {
-    QStringList linesA, linesB;
-    int linenoA, linenoB;
-
     setWindowTitle(i18n("CVS Diff: %1", fileName));
     revlabel1->setText(revA.isEmpty() ? i18n("Repository:") : i18n("Revision ") + revA + ':');
     revlabel2->setText(revB.isEmpty() ? i18n("Working dir:") : i18n("Revision ") + revB + ':');
@@ -260,51 +260,20 @@ bool DiffDialog::parseCvsDiff(OrgKdeCervisia5CvsserviceCvsserviceInterface *serv
     if (!job.isValid())
         return false;
 
+    m_inHeader = true;
+    m_linenoA = m_linenoB = 0;
+    m_linesA.clear();
+    m_linesB.clear();
+
+    // the hunks are shown while the output arrives
     ProgressDialog dlg(this, "Diff", service->service(), job, "diff", i18n("CVS Diff"));
+    dlg.setStreaming(true);
+    connect(&dlg, SIGNAL(receivedLine(QString)), this, SLOT(parseDiffLine(QString)));
     if (!dlg.execute())
         return false;
 
-    // remember diff output for "save as" action
-    m_diffOutput = dlg.getOutput();
-
-    QString line;
-    while (dlg.getLine(line) && !line.startsWith("+++"))
-        ;
-
-    linenoA = linenoB = 0;
-    while (dlg.getLine(line)) {
-        // line contains diff region?
-        if (line.startsWith(QLatin1String("@@"))) {
-            interpretRegion(line, &linenoA, &linenoB);
-            diff1->addLine(line, DiffView::Separator);
-            diff2->addLine(line, DiffView::Separator);
-            continue;
-        }
-
-        if (line.length() < 1)
-            continue;
-
-        QChar marker = line[0];
-        line.remove(0, 1);
-
-        if (marker == '-')
-            linesA.append(line);
-        else if (marker == '+')
-            linesB.append(line);
-        else {
-            if (!linesA.isEmpty() || !linesB.isEmpty()) {
-                newDiffHunk(linenoA, linenoB, linesA, linesB);
-
-                linesA.clear();
-                linesB.clear();
-            }
-            diff1->addLine(line, DiffView::Unchanged, ++linenoA);
-            diff2->addLine(line, DiffView::Unchanged, ++linenoB);
-        }
-    }
-
-    if (!linesA.isEmpty() || !linesB.isEmpty())
-        newDiffHunk(linenoA, linenoB, linesA, linesB);
+    if (!m_linesA.isEmpty() || !m_linesB.isEmpty())
+        newDiffHunk(m_linenoA, m_linenoB, m_linesA, m_linesB);
 
     // sets the right size as there is no more auto resize in QComboBox
     itemscombo->adjustSize();
@@ -314,6 +283,46 @@ bool DiffDialog::parseCvsDiff(OrgKdeCervisia5CvsserviceCvsserviceInterface *serv
     return true;
 }
 
+void DiffDialog::parseDiffLine(const QString &line)
+{
+    // remember diff output for "save as" action
+    m_diffOutput.append(line);
+
+    if (m_inHeader) {
+        m_inHeader = !line.startsWith("+++");
+        return;
+    }
+
+    // line contains diff region?
+    if (line.startsWith(QLatin1String("@@"))) {
+        interpretRegion(line, &m_linenoA, &m_linenoB);
+        diff1->addLine(line, DiffView::Separator);
+        diff2->addLine(line, DiffView::Separator);
+        return;
+    }
+
+    if (line.length() < 1)
+        return;
+
+    const QChar marker = line[0];
+    const QString text = line.mid(1);
+
+    if (marker == '-')
+        m_linesA.append(text);
+    else if (marker == '+')
+        m_linesB.append(text);
+    else {
+        if (!m_linesA.isEmpty() || !m_linesB.isEmpty()) {
+            newDiffHunk(m_linenoA, m_linenoB, m_linesA, m_linesB);
+
+            m_linesA.clear();
+            m_linesB.clear();
+        }
+        diff1->addLine(text, DiffView::Unchanged, ++m_linenoA);
+        diff2->addLine(text, DiffView::Unchanged, ++m_linenoB);
+    }
+}
+
 void DiffDialog::newDiffHunk(int &linenoA, int &linenoB, const QStringList &linesA, const QStringList &linesB)
 {
     auto item = new DiffItem;
@@ -53,6 +53,7 @@ private Q_SLOTS:
     void forwClicked();
     void saveAsClicked();
     void slotHelp();
+    void parseDiffLine(const QString &line);
 
 private:
     void newDiffHunk(int &linenoA, int &linenoB, const QStringList &linesA, const QStringList &linesB);
@@ -74,6 +75,11 @@ private:
     int markeditem;
     KConfig &partConfig;
     QStringList m_diffOutput;
+
+    // state of the parser of the cvs diff output
+    bool m_inHeader; // before the "+++" line
+    int m_linenoA, m_linenoB;
+    QStringList m_linesA, m_linesB; // lines of the current hunk
 };
 
 #endif
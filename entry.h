@@ -23,6 +23,7 @@
 #include <qstring.h>
 
 #include "entry_status.h"
+#include "revision.h"
 
 namespace Cervisia
 {
@@ -56,7 +57,7 @@ struct Entry {
     /**
      * The revision of this entry.
      */
-    QString m_revision;
+    Revision m_revision;
 
     /**
      * The modification date/time of this entry (in user's local time).
@@ -282,93 +282,96 @@ bool HistoryDialog::parseHistory(OrgKdeCervisia5CvsserviceCvsserviceInterface *c
     if (!job.isValid())
         return false;
 
+    // the events are shown while the output arrives
     ProgressDialog dlg(this, "History", cvsService->service(), job, "history", i18n("CVS History"));
+    dlg.setStreaming(true);
+    connect(&dlg, SIGNAL(receivedLine(QString)), this, SLOT(parseHistoryLine(QString)));
     if (!dlg.execute())
         return false;
 
-    QString line;
-    while (dlg.getLine(line)) {
-        const QStringList list(splitLine(line));
-        const int listSize(list.size());
-        if (listSize < 6)
-            continue;
-
-        QString cmd = list[0];
-        if (cmd.length() != 1)
-            continue;
-
-        int ncol;
-        int cmd_code = cmd[0].toLatin1();
-        switch (cmd_code) {
-        case 'O':
-        case 'F':
-        case 'E':
-            ncol = 8;
-            break;
-        default:
-            ncol = 10;
-            break;
-        }
+    return true;
+}
 
-        if (ncol != (int)list.count())
-            continue;
-
-        QString event;
-        switch (cmd_code) {
-        case 'O':
-            event = i18n("Checkout ");
-            break;
-        case 'T':
-            event = i18n("Tag ");
-            break;
-        case 'F':
-            event = i18n("Release ");
-            break;
-        case 'W':
-            event = i18n("Update, Deleted ");
-            break;
-        case 'U':
-            event = i18n("Update, Copied ");
-            break;
-        case 'G':
-            event = i18n("Update, Merged ");
-            break;
-        case 'C':
-            event = i18n("Update, Conflict ");
-            break;
-        case 'P':
-            event = i18n("Update, Patched ");
-            break;
-        case 'M':
-            event = i18n("Commit, Modified ");
-            break;
-        case 'A':
-            event = i18n("Commit, Added ");
-            break;
-        case 'R':
-            event = i18n("Commit, Removed ");
-            break;
-        default:
-            event = i18n("Unknown ");
-        }
+void HistoryDialog::parseHistoryLine(const QString &line)
+{
+    const QStringList list(splitLine(line));
+    const int listSize(list.size());
+    if (listSize < 6)
+        return;
 
-        const QDateTime date(parseDate(list[1], list[2], list[3]));
-
-        auto item = new HistoryItem(listview, date);
-        item->setText(HistoryItem::Event, event);
-        item->setText(HistoryItem::Author, list[4]);
-        if (ncol == 10) {
-            item->setText(HistoryItem::Revision, list[5]);
-            if (listSize >= 8) {
-                item->setText(HistoryItem::File, list[6]);
-                item->setText(HistoryItem::Path, list[7]);
-            }
-        } else {
-            item->setText(HistoryItem::Path, list[5]);
-        }
+    QString cmd = list[0];
+    if (cmd.length() != 1)
+        return;
+
+    int ncol;
+    int cmd_code = cmd[0].toLatin1();
+    switch (cmd_code) {
+    case 'O':
+    case 'F':
+    case 'E':
+        ncol = 8;
+        break;
+    default:
+        ncol = 10;
+        break;
     }
 
-    return true;
+    if (ncol != (int)list.count())
+        return;
+
+    QString event;
+    switch (cmd_code) {
+    case 'O':
+        event = i18n("Checkout ");
+        break;
+    case 'T':
+        event = i18n("Tag ");
+        break;
+    case 'F':
+        event = i18n("Release ");
+        break;
+    case 'W':
+        event = i18n("Update, Deleted ");
+        break;
+    case 'U':
+        event = i18n("Update, Copied ");
+        break;
+    case 'G':
+        event = i18n("Update, Merged ");
+        break;
+    case 'C':
+        event = i18n("Update, Conflict ");
+        break;
+    case 'P':
+        event = i18n("Update, Patched ");
+        break;
+    case 'M':
+        event = i18n("Commit, Modified ");
+        break;
+    case 'A':
+        event = i18n("Commit, Added ");
+        break;
+    case 'R':
+        event = i18n("Commit, Removed ");
+        break;
+    default:
+        event = i18n("Unknown ");
+    }
+
+    const QDateTime date(parseDate(list[1], list[2], list[3]));
+
+    auto item = new HistoryItem(listview, date);
+    item->setText(HistoryItem::Event, event);
+    item->setText(HistoryItem::Author, list[4]);
+    if (ncol == 10) {
+        item->setText(HistoryItem::Revision, list[5]);
+        if (listSize >= 8) {
+            item->setText(HistoryItem::File, list[6]);
+            item->setText(HistoryItem::Path, list[7]);
+        }
+    } else {
+        item->setText(HistoryItem::Path, list[5]);
+    }
 }
 
 // Local Variables:
@@ -42,6 +42,7 @@ private Q_SLOTS:
     void slotHelp();
     void choiceChanged();
     void toggled(bool b);
+    void parseHistoryLine(const QString &line);
 
 private:
     QTreeWidget *listview;
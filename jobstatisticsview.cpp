@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "jobstatisticsview.h"
+
+#include <QContextMenuEvent>
+#include <QHeaderView>
+#include <QMenu>
+#include <QTimer>
+
+#include <KLocalizedString>
+
+#include "jobstatisticsinterface.h"
+
+// interval (in ms) in which a visible view is refreshed
+static const int REFRESH_INTERVAL = 2000;
+
+// the values shown in the columns after "Command" and "Jobs"
+static const char *const COLUMN_VALUES[] = {"queueTime", "spawnTime", "firstByteTime", "runTime", "clientTime", "stdoutLines", "compressionLevel"};
+
+JobStatisticsView::JobStatisticsView(const QString &appId, QWidget *parent)
+    : QTreeWidget(parent)
+{
+    m_statistics = new OrgKdeCervisia5CvsserviceJobstatisticsInterface(appId, "/JobStatistics", QDBusConnection::sessionBus(), this);
+
+    setRootIsDecorated(false);
+    setAllColumnsShowFocus(true);
+    setHeaderLabels(QStringList() << i18n("Command") << i18n("Jobs") << i18n("Queue (ms)") << i18n("Spawn (ms)") << i18n("First Byte (ms)")
+                                  << i18n("Run (ms)") << i18n("Client (ms)") << i18n("Output Lines")
+                                  << i18n("Compression"));
+    header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    setWhatsThis(
+        i18n("Timings of the cvs jobs per command as 50th / 90th / 99th "
+             "percentile. Client is the time Cervisia needed to process "
+             "the output of a job."));
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(REFRESH_INTERVAL);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+JobStatisticsView::~JobStatisticsView()
+{
+}
+
+void JobStatisticsView::refresh()
+{
+    QDBusReply<QStringList> commands = m_statistics->commands();
+    if (!commands.isValid())
+        return;
+
+    clear();
+
+    foreach (const QString &command, commands.value()) {
+        QDBusReply<QVariantMap> reply = m_statistics->summary(command);
+        if (!reply.isValid())
+            continue;
+
+        const QVariantMap summary = reply.value();
+
+        auto item = new QTreeWidgetItem(this);
+        item->setText(0, command);
+        item->setText(1, summary.value("count").toString());
+
+        int column = 2;
+        for (const char *name : COLUMN_VALUES) {
+            const QString key(name);
+            if (summary.contains(key + ".p50")) {
+                item->setText(column,
+                              QString("%1 / %2 / %3")
+                                  .arg(summary.value(key + ".p50").toLongLong())
+                                  .arg(summary.value(key + ".p90").toLongLong())
+                                  .arg(summary.value(key + ".p99").toLongLong()));
+                item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+            }
+            ++column;
+        }
+    }
+}
+
+void JobStatisticsView::reset()
+{
+    m_statistics->reset();
+    clear();
+}
+
+void JobStatisticsView::showEvent(QShowEvent *event)
+{
+    QTreeWidget::showEvent(event);
+
+    refresh();
+    m_refreshTimer->start();
+}
+
+void JobStatisticsView::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+
+    QTreeWidget::hideEvent(event);
+}
+
+void JobStatisticsView::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu;
+    menu.addAction(i18n("Refresh"), this, SLOT(refresh()));
+    menu.addAction(i18n("Reset"), this, SLOT(reset()));
+    menu.exec(event->globalPos());
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
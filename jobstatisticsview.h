@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef JOBSTATISTICSVIEW_H
+#define JOBSTATISTICSVIEW_H
+
+#include <QTreeWidget>
+
+class QTimer;
+class OrgKdeCervisia5CvsserviceJobstatisticsInterface;
+
+/**
+ * Shows the percentiles of the job timings collected by the cvs service,
+ * one row per cvs command. The view is refreshed while it is visible.
+ */
+class JobStatisticsView : public QTreeWidget
+{
+    Q_OBJECT
+
+public:
+    explicit JobStatisticsView(const QString &appId, QWidget *parent = nullptr);
+    ~JobStatisticsView() override;
+
+public Q_SLOTS:
+    void refresh();
+    void reset();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    OrgKdeCervisia5CvsserviceJobstatisticsInterface *m_statistics;
+    QTimer *m_refreshTimer;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,349 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "logcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+#include "cvsservice/cvsrecords.h"
+#include "debug.h"
+
+// identifies the cache files and their layout
+static const quint32 CACHE_MAGIC = 0x43564c47;
+static const quint32 CACHE_VERSION = 1;
+
+// cached logs which weren't used for this many days are removed
+static const int CACHE_MAX_AGE = 90;
+
+static const char SEPARATOR[] = "----------------------------";
+static const char END_OF_FILE[] = "=============================================================================";
+
+namespace
+{
+// collects the tags and the revisions of the log of one file
+class FileLog : public CvsRecords::LogParser
+{
+public:
+    FileLog()
+        : complete(false)
+    {
+    }
+
+    CvsRecords::LogRecord file; // revisions newest first
+    bool complete; // the end of the log was read
+
+protected:
+    void revisionParsed(const CvsRecords::LogRecord & /*file*/, const CvsRecords::RevisionRecord &revision) override
+    {
+        file.revisions.append(revision);
+    }
+
+    void fileParsed(const CvsRecords::LogRecord &parsed) override
+    {
+        file.fileName = parsed.fileName;
+        file.tags = parsed.tags;
+        complete = true;
+    }
+};
+
+bool parseLog(const QStringList &lines, CvsRecords::LogRecord *log)
+{
+    FileLog parser;
+    for (const QString &line : lines)
+        parser.parseLine(line);
+
+    *log = parser.file;
+    return parser.complete;
+}
+
+// "total revisions: 12;	selected revisions: 12"
+int totalRevisions(const QStringList &header)
+{
+    for (const QString &line : header) {
+        if (line.startsWith(QLatin1String("total revisions:"))) {
+            bool ok = false;
+            const int count = line.section(';', 0, 0).section(':', 1).trimmed().toInt(&ok);
+            return ok ? count : -1;
+        }
+    }
+
+    return -1;
+}
+
+bool sameTags(const QList<CvsRecords::TagRecord> &tags1, const QList<CvsRecords::TagRecord> &tags2)
+{
+    return std::equal(tags1.begin(),
+                      tags1.end(),
+                      tags2.begin(),
+                      tags2.end(),
+                      [](const CvsRecords::TagRecord &tag1, const CvsRecords::TagRecord &tag2) {
+                          return tag1.name == tag2.name && tag1.revision == tag2.revision && tag1.isBranch == tag2.isBranch;
+                      });
+}
+
+// the tag as cvs log shows it, e.g. with 1.2.0.4 for the branch 1.2.4
+QString tagLine(const CvsRecords::TagRecord &tag)
+{
+    QString revision = tag.revision;
+
+    // vendor branches have odd numbers and no magic branch number
+    const int pos = revision.lastIndexOf(QLatin1Char('.'));
+    if (tag.isBranch && pos > 0 && QStringView(revision).mid(pos + 1).toInt() % 2 == 0)
+        revision.insert(pos, QLatin1String(".0"));
+
+    return QLatin1Char('\t') + tag.name + QLatin1String(": ") + revision;
+}
+
+// removes the logs which weren't used for CACHE_MAX_AGE days, once per session
+void pruneCache(const QString &path)
+{
+    static bool pruned = false;
+    if (pruned)
+        return;
+    pruned = true;
+
+    const QDateTime limit = QDateTime::currentDateTimeUtc().addDays(-CACHE_MAX_AGE);
+    const QFileInfoList files = QDir(path).entryInfoList(QStringList(QLatin1String("*.log")), QDir::Files);
+    for (const QFileInfo &fi : files) {
+        if (fi.lastModified() < limit)
+            QFile::remove(fi.absoluteFilePath());
+    }
+}
+}
+
+struct LogCache::Private {
+    Private()
+        : total(-1)
+        , modified(false)
+    {
+    }
+
+    QString cacheFileName; // empty if the file can't be cached
+
+    CvsRecords::LogRecord log; // revisions newest first
+    int total; // number of revisions according to the header
+    bool modified; // since it was loaded or saved
+
+    FileLog parser; // of addLine()
+};
+
+LogCache::LogCache(const QString &repository, const QString &module, const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    if (repository.isEmpty() || module.isEmpty())
+        return;
+
+    // identify the file by its place in the repository, as working
+    // copies of the same module share the log
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &part : {repository, module, fileName}) {
+        hash.addData(part.toUtf8());
+        // separate the parts, so that ("ab", "c") != ("a", "bc")
+        hash.addData("\0", 1);
+    }
+
+    d->cacheFileName = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/logs/")
+        + QString::fromLatin1(hash.result().toHex()) + QLatin1String(".log");
+}
+
+LogCache::~LogCache()
+{
+    delete d;
+}
+
+bool LogCache::load()
+{
+    clear();
+
+    if (d->cacheFileName.isEmpty())
+        return false;
+
+    QFile file(d->cacheFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+        return false;
+
+    stream >> d->log;
+    if (stream.status() != QDataStream::Ok || d->log.revisions.isEmpty()) {
+        clear();
+        return false;
+    }
+
+    // pruneCache() keeps the logs which are used
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+
+    return true;
+}
+
+bool LogCache::setHeader(const QStringList &header)
+{
+    CvsRecords::LogRecord parsed;
+    if (!parseLog(header, &parsed))
+        return false;
+
+    d->total = totalRevisions(header);
+    if (d->total < d->log.revisions.count())
+        return false;
+
+    if (!sameTags(parsed.tags, d->log.tags)) {
+        d->log.tags = parsed.tags;
+        d->modified = true;
+    }
+
+    return true;
+}
+
+bool LogCache::isComplete() const
+{
+    return d->log.revisions.count() == d->total;
+}
+
+QDateTime LogCache::updateStart() const
+{
+    // the revisions of the newest second may be incomplete, so they are
+    // read again
+    QDateTime newest;
+    for (const CvsRecords::RevisionRecord &revision : qAsConst(d->log.revisions)) {
+        if (revision.dateTime.isValid() && (!newest.isValid() || revision.dateTime > newest))
+            newest = revision.dateTime;
+    }
+
+    return newest;
+}
+
+bool LogCache::merge(const QStringList &log)
+{
+    CvsRecords::LogRecord parsed;
+    if (!parseLog(log, &parsed))
+        return false;
+
+    QSet<QString> known;
+    for (const CvsRecords::RevisionRecord &revision : qAsConst(d->log.revisions))
+        known.insert(revision.revision);
+
+    QList<CvsRecords::RevisionRecord> newRevisions;
+    for (const CvsRecords::RevisionRecord &revision : qAsConst(parsed.revisions)) {
+        if (!known.contains(revision.revision))
+            newRevisions.append(revision);
+    }
+
+    // e.g. a revision with a wrong date
+    if (d->log.revisions.count() + newRevisions.count() != d->total)
+        return false;
+
+    d->log.revisions = newRevisions + d->log.revisions;
+    d->modified = true;
+    qCDebug(log_cervisia) << "log cache:" << newRevisions.count() << "new revisions of" << d->log.fileName;
+
+    return true;
+}
+
+int LogCache::revisionCount() const
+{
+    return d->log.revisions.count();
+}
+
+QStringList LogCache::lines() const
+{
+    QStringList result;
+    result.append(QLatin1String("Working file: ") + d->log.fileName);
+    result.append(QLatin1String("symbolic names:"));
+    for (const CvsRecords::TagRecord &tag : qAsConst(d->log.tags))
+        result.append(tagLine(tag));
+    result.append(QString::fromLatin1("total revisions: %1;\tselected revisions: %1").arg(d->log.revisions.count()));
+    result.append(QLatin1String("description:"));
+
+    for (const CvsRecords::RevisionRecord &revision : qAsConst(d->log.revisions)) {
+        result.append(QLatin1String(SEPARATOR));
+        result.append(QLatin1String("revision ") + revision.revision);
+        result.append(QLatin1String("date: ") + revision.dateTime.toUTC().toString(QLatin1String("yyyy/MM/dd hh:mm:ss"))
+                      + QLatin1String(";  author: ") + revision.author + QLatin1Char(';'));
+        result += revision.comment.split(QLatin1Char('\n'));
+    }
+    result.append(QLatin1String(END_OF_FILE));
+
+    return result;
+}
+
+void LogCache::clear()
+{
+    d->log = CvsRecords::LogRecord();
+    d->total = -1;
+    d->modified = false;
+    d->parser = FileLog();
+}
+
+bool LogCache::save()
+{
+    if (!d->modified)
+        return true;
+
+    if (d->cacheFileName.isEmpty() || d->log.revisions.isEmpty())
+        return false;
+
+    QDir().mkpath(QFileInfo(d->cacheFileName).absolutePath());
+
+    QSaveFile file(d->cacheFileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << CACHE_MAGIC << CACHE_VERSION << d->log;
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        return false;
+
+    d->modified = false;
+    pruneCache(QFileInfo(d->cacheFileName).absolutePath());
+
+    return true;
+}
+
+void LogCache::addLine(const QString &line)
+{
+    d->parser.parseLine(line);
+
+    // only a complete log is kept
+    if (d->parser.complete) {
+        d->log = d->parser.file;
+        d->modified = true;
+        d->parser = FileLog();
+    }
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
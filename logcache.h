@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGCACHE_H
+#define LOGCACHE_H
+
+#include <QDateTime>
+#include <QObject>
+#include <QStringList>
+
+/**
+ * Keeps the log of a file on disk, so that it doesn't have to be read
+ * completely each time the log dialog is opened. The log is kept as the
+ * tags and the revisions parsed by CvsRecords::LogParser.
+ *
+ * A refresh first asks for the header only (cvs log -h), which has the
+ * current tags and the number of revisions, see setHeader(). Only if there
+ * are new revisions, the ones committed since updateStart() are read
+ * (cvs log -d) and passed to merge().
+ */
+class LogCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param module the folder of the file in the repository, as in
+     *        CVS/Repository
+     * @param fileName the name of the file without its folder
+     */
+    LogCache(const QString &repository, const QString &module, const QString &fileName, QObject *parent = nullptr);
+    ~LogCache() override;
+
+    /**
+     * Reads the cached log of the file.
+     *
+     * @return false if there is none
+     */
+    bool load();
+
+    /**
+     * Takes the tags and the number of revisions from the output of
+     * cvs log -h.
+     *
+     * @return false if the cache can't be brought up to date, e.g. because
+     *         revisions were removed
+     */
+    bool setHeader(const QStringList &header);
+
+    /**
+     * @return true if the cache has all revisions reported by the header.
+     */
+    bool isComplete() const;
+
+    /**
+     * @return The time from which on cvs log has to report the revisions
+     *         that are missing in the cache, or an invalid time if there are
+     *         no revisions.
+     */
+    QDateTime updateStart() const;
+
+    /**
+     * Adds the revisions of @p log, the output of cvs log -d, which are
+     * missing in the cache.
+     *
+     * @return false if the revisions still don't match the header, e.g.
+     *         because of a revision with a wrong date
+     */
+    bool merge(const QStringList &log);
+
+    /**
+     * @return The number of revisions in the cache.
+     */
+    int revisionCount() const;
+
+    /**
+     * @return The log in the format of cvs log.
+     */
+    QStringList lines() const;
+
+    /**
+     * Forgets the log, so that it can be filled with addLine().
+     */
+    void clear();
+
+    /**
+     * Writes the log to the cache if it was changed.
+     *
+     * @return false if it couldn't be written
+     */
+    bool save();
+
+public Q_SLOTS:
+    /**
+     * Adds a line of the output of cvs log.
+     */
+    void addLine(const QString &line);
+
+private:
+    struct Private;
+    Private *d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -24,6 +24,7 @@
 #include <KTextEdit>
 #include <QTabWidget>
 #include <QUrl>
+#include <QDir>
 #include <qfile.h>
 #include <qfileinfo.h>
 #include <qlabel.h>
@@ -41,29 +42,51 @@
 #include <kconfiggroup.h>
 #include <kfinddialog.h>
 #include <kmessagebox.h>
-#include <ktreewidgetsearchline.h>
 
 #include <KGuiItem>
 #include <QDialogButtonBox>
+#include <QCheckBox>
 #include <QFileDialog>
+#include <QLineEdit>
 #include <QPushButton>
 #include <QVBoxLayout>
 
 #include "annotatecontroller.h"
 #include "annotatedialog.h"
+#include "changesetdialog.h"
 #include "cvsserviceinterface.h"
 #include "debug.h"
 #include "diffdialog.h"
+#include "logcache.h"
 #include "loglist.h"
+#include "logmodel.h"
 #include "logplainview.h"
 #include "logtree.h"
 #include "misc.h"
 #include "patchoptiondialog.h"
 #include "progressdialog.h"
+#include "repositoryinterface.h"
+#include "revisionprefetcher.h"
+
+// runs a job for a part of the log and waits for its output
+static bool runLog(QWidget *parent, OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, const QDBusReply<QDBusObjectPath> &job, QStringList *output)
+{
+    if (!job.isValid())
+        return false;
+
+    ProgressDialog dlg(parent, "Logging", cvsService->service(), job, "log", i18n("CVS Log"));
+    if (!dlg.execute() || dlg.wasCancelled())
+        return false;
+
+    *output = dlg.getOutput();
+    return true;
+}
 
 LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     : QDialog(parent)
+    , parseState(Begin)
     , cvsService(0)
+    , prefetcher(0)
     , partConfig(cfg)
 {
     auto mainLayout = new QVBoxLayout;
@@ -72,33 +95,55 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     splitter = new QSplitter(Qt::Vertical, this);
     mainLayout->addWidget(splitter);
 
+    model = new LogModel(this);
+
     tree = new LogTreeView(this);
     connect(tree, SIGNAL(revisionClicked(QString, bool)), this, SLOT(revisionSelected(QString, bool)));
 
-    auto listWidget = new QWidget(this);
-    auto listLayout = new QVBoxLayout(listWidget);
-    auto searchLayout = new QHBoxLayout();
-    listLayout->addLayout(searchLayout);
-
-    list = new LogListView(partConfig, listWidget);
-    listLayout->addWidget(list, 1);
-
-    auto searchLine = new KTreeWidgetSearchLine(listWidget, list);
-    auto searchLabel = new QLabel(i18n("Search:"), listWidget);
-    searchLabel->setBuddy(searchLine);
-    searchLayout->addWidget(searchLabel);
-    searchLayout->addWidget(searchLine, 1);
-
+    list = new LogListView(partConfig, model, this);
     connect(list, SIGNAL(revisionClicked(QString, bool)), this, SLOT(revisionSelected(QString, bool)));
 
-    plain = new LogPlainView(this);
+    plain = new LogPlainView(model, this);
     connect(plain, SIGNAL(revisionClicked(QString, bool)), this, SLOT(revisionSelected(QString, bool)));
 
+    auto viewWidget = new QWidget;
+    auto viewLayout = new QVBoxLayout(viewWidget);
+    viewLayout->setContentsMargins(0, 0, 0, 0);
+    auto filterLayout = new QHBoxLayout();
+    viewLayout->addLayout(filterLayout);
+
+    filterEdit = new QLineEdit(viewWidget);
+    filterEdit->setClearButtonEnabled(true);
+    filterEdit->setPlaceholderText(i18n("e.g. author:name after:2010-01 -typo"));
+    filterEdit->setWhatsThis(
+        i18n("Shows only the revisions which match all terms. A term "
+             "matches words of the comments, authors and tags, or the "
+             "fields author:, tag:, comment:, after:, before: and date: "
+             "with a date like 2010, 2010-05 or 2010-05-31. Terms can be "
+             "combined with OR, negated with - or NOT and grouped with "
+             "parentheses."));
+    connect(filterEdit, &QLineEdit::textChanged, this, &LogDialog::applyFilter);
+    auto filterLabel = new QLabel(i18n("F&ilter:"), viewWidget);
+    filterLabel->setBuddy(filterEdit);
+    filterLayout->addWidget(filterLabel);
+    filterLayout->addWidget(filterEdit, 1);
+
+    taggedBox = new QCheckBox(i18n("Only ta&gged"), viewWidget);
+    connect(taggedBox, &QCheckBox::toggled, this, &LogDialog::applyFilter);
+    filterLayout->addWidget(taggedBox);
+    mineBox = new QCheckBox(i18n("Only &mine"), viewWidget);
+    connect(mineBox, &QCheckBox::toggled, this, &LogDialog::applyFilter);
+    filterLayout->addWidget(mineBox);
+
+    filterStatus = new QLabel(viewWidget);
+    filterLayout->addWidget(filterStatus);
+
     tabWidget = new QTabWidget;
     tabWidget->addTab(tree, i18n("&Tree"));
-    tabWidget->addTab(listWidget, i18n("&List"));
+    tabWidget->addTab(list, i18n("&List"));
     tabWidget->addTab(plain, i18n("CVS &Output"));
-    splitter->addWidget(tabWidget);
+    viewLayout->addWidget(tabWidget, 1);
+    splitter->addWidget(viewWidget);
     splitter->setStretchFactor(0, 1);
 
     connect(tabWidget, &QTabWidget::currentChanged, this, &LogDialog::tabChanged);
@@ -106,7 +151,8 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     tree->setWhatsThis(
         i18n("Choose revision A by clicking with the left "
              "mouse button,\nrevision B by clicking with "
-             "the middle mouse button."));
+             "the middle mouse button.\nZoom with Ctrl and the "
+             "mouse wheel or the context menu."));
 
     auto mainWidget = new QWidget;
     splitter->addWidget(mainWidget);
@@ -194,11 +240,15 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     user3Button = new QPushButton;
     buttonBox->addButton(user3Button, QDialogButtonBox::ActionRole);
 
+    user4Button = new QPushButton;
+    buttonBox->addButton(user4Button, QDialogButtonBox::ActionRole);
+
     connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
 
     KGuiItem::assign(user1Button, KGuiItem(i18n("&Annotate A")));
     KGuiItem::assign(user2Button, KGuiItem(i18n("&Diff")));
     KGuiItem::assign(user3Button, KGuiItem(i18n("&Find")));
+    KGuiItem::assign(user4Button, KGuiItem(i18n("C&hangeset A")));
     user3Button->setVisible(false);
 
     // initially make the version info widget as small as possible
@@ -207,7 +257,9 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     revbox[0]->setWhatsThis(
         i18n("This revision is used when you click "
              "Annotate.\nIt is also used as the first "
-             "item of a Diff operation."));
+             "item of a Diff operation.\nChangeset A shows the "
+             "revisions of the other files which were committed "
+             "together with it."));
 
     revbox[1]->setWhatsThis(
         i18n("This revision is used as the second "
@@ -219,6 +271,7 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
     connect(user1Button, SIGNAL(clicked()), this, SLOT(annotateClicked()));
     connect(user2Button, SIGNAL(clicked()), this, SLOT(diffClicked()));
     connect(user3Button, SIGNAL(clicked()), this, SLOT(findClicked()));
+    connect(user4Button, SIGNAL(clicked()), this, SLOT(changesetClicked()));
 
     connect(buttonBox->button(QDialogButtonBox::Apply), SIGNAL(clicked()), this, SLOT(slotPatch()));
     connect(buttonBox, &QDialogButtonBox::helpRequested, this, &LogDialog::slotHelp);
@@ -244,7 +297,6 @@ LogDialog::LogDialog(KConfig &cfg, QWidget *parent)
 
 LogDialog::~LogDialog()
 {
-    qDeleteAll(items);
     qDeleteAll(tags);
 
     KConfigGroup cg(&partConfig, "LogDialog");
@@ -257,142 +309,45 @@ LogDialog::~LogDialog()
 
 bool LogDialog::parseCvsLog(OrgKdeCervisia5CvsserviceCvsserviceInterface *service, const QString &fileName)
 {
-    QString rev;
-
-    Cervisia::LogInfo logInfo;
-
-    enum { Begin, Tags, Admin, Revision, Author, Branches, Comment, Finished } state;
-
     // remember DBUS reference and file name for diff or annotate
     cvsService = service;
     filename = fileName;
 
     setWindowTitle(i18n("CVS Log: %1", filename));
 
-    QDBusReply<QDBusObjectPath> job = cvsService->log(filename);
-    if (!job.isValid())
-        return false;
-
-    ProgressDialog dlg(this, "Logging", cvsService->service(), job, "log", i18n("CVS Log"));
-    if (!dlg.execute())
-        return false;
-
-    // process cvs log output
-    state = Begin;
-    QString line;
-    while (dlg.getLine(line)) {
-        switch (state) {
-        case Begin:
-            if (line == "symbolic names:")
-                state = Tags;
-            break;
-        case Tags:
-            if (line[0] == '\t') {
-                const QStringList strlist(splitLine(line, ':'));
-                rev = strlist[1].simplified();
-                const QString tag(strlist[0].simplified());
-                QString branchpoint;
-                int pos1, pos2;
-                if ((pos2 = rev.lastIndexOf('.')) > 0 && (pos1 = rev.lastIndexOf('.', pos2 - 1)) > 0 && rev.mid(pos1 + 1, pos2 - pos1 - 1) == "0") {
-                    // For a branch tag 2.10.0.6, we want:
-                    // branchpoint = "2.10"
-                    // rev = "2.10.6"
-                    branchpoint = rev.left(pos1);
-                    rev.remove(pos1 + 1, pos2 - pos1);
-                }
-                if (rev != "1.1.1") {
-                    auto taginfo = new LogDialogTagInfo;
-                    taginfo->rev = rev;
-                    taginfo->tag = tag;
-                    taginfo->branchpoint = branchpoint;
-                    tags.append(taginfo);
-                }
-            } else {
-                state = Admin;
-            }
-            break;
-        case Admin:
-            if (line == "----------------------------") {
-                state = Revision;
-            }
-            break;
-        case Revision:
-            if (line.startsWith(QLatin1String("revision "))) {
-                logInfo.m_revision = rev = line.section(' ', 1, 1);
-                state = Author;
-            }
-            break;
-        case Author: {
-            if (line.startsWith(QLatin1String("date: "))) {
-                QStringList strList = line.split(';');
-
-                // convert date into ISO format (YYYY-MM-DDTHH:MM:SS)
-                int len = strList[0].length();
-                QString dateTimeStr = strList[0].right(len - 6); // remove 'date: '
-                dateTimeStr.replace('/', '-');
-
-                QString date = dateTimeStr.section(' ', 0, 0);
-                QString time = dateTimeStr.section(' ', 1, 1);
-                logInfo.m_dateTime.setTime_t(QDateTime::fromString(date + 'T' + time, Qt::ISODate).toTime_t());
-
-                logInfo.m_author = strList[1].section(':', 1, 1).trimmed();
-
-                state = Branches;
-            }
-        } break;
-        case Branches:
-            if (!line.startsWith(QLatin1String("branches:"))) {
-                logInfo.m_comment = line;
-                state = Comment;
-            }
-            break;
-        case Comment:
-            if (line == "----------------------------") {
-                QStringList lines = dlg.getOutput();
-                if ((lines.count() >= 2) && // at least revision and date line must follow
-                    lines[0].startsWith(QLatin1String("revision ")) && lines[1].startsWith(QLatin1String("date: "))) {
-                    state = Revision;
-                }
-            } else if (line == "=============================================================================") {
-                state = Finished;
-            }
-            if (state == Comment) // still in message
-                logInfo.m_comment += '\n' + line;
-            else {
-                // Create tagcomment
-                QString branchrev;
-                int pos1, pos2;
-                // 1.60.x.y => revision belongs to branch 1.60.0.x
-                if ((pos2 = rev.lastIndexOf('.')) > 0 && (pos1 = rev.lastIndexOf('.', pos2 - 1)) > 0)
-                    branchrev = rev.left(pos2);
-
-                // Build Cervisia::TagInfo for logInfo
-                foreach (LogDialogTagInfo *tagInfo, tags) {
-                    if (rev == tagInfo->rev) {
-                        // This never matches branch tags...
-                        logInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::Tag));
-                    }
-                    if (rev == tagInfo->branchpoint) {
-                        logInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::Branch));
-                    }
-                    if (branchrev == tagInfo->rev) {
-                        // ... and this never matches ordinary tags :-)
-                        logInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::OnBranch));
-                    }
-                }
-
-                plain->addRevision(logInfo);
-                tree->addRevision(logInfo);
-                list->addRevision(logInfo);
-
-                items.append(new Cervisia::LogInfo(logInfo));
-
-                // reset for next entry
-                logInfo = Cervisia::LogInfo();
-            }
-            break;
-        case Finished:;
-        }
+    parseState = Begin;
+    parsedInfo = Cervisia::LogInfo();
+    pendingLines.clear();
+
+    // only the new revisions are read if the log is cached
+    OrgKdeCervisia5RepositoryInterface cvsRepository(cvsService->service(), "/CvsRepository", QDBusConnection::sessionBus());
+    const QFileInfo fi(QDir(cvsRepository.workingCopy()), filename);
+    QFile file(fi.absolutePath() + QLatin1String("/CVS/Repository"));
+    const QString module = file.open(QIODevice::ReadOnly) ? QString::fromLocal8Bit(file.readLine()).trimmed() : QString();
+
+    LogCache cache(cvsRepository.location(), module, fi.fileName());
+    if (cache.load() && refreshLogCache(&cache)) {
+        foreach (const QString &line, cache.lines())
+            parseLogLine(line);
+        cache.save();
+    } else {
+        cache.clear();
+
+        QDBusReply<QDBusObjectPath> job = cvsService->log(filename);
+        if (!job.isValid())
+            return false;
+
+        // the revisions are shown while the output arrives
+        ProgressDialog dlg(this, "Logging", cvsService->service(), job, "log", i18n("CVS Log"));
+        dlg.setStreaming(true);
+        connect(&dlg, SIGNAL(receivedLine(QString)), this, SLOT(parseLogLine(QString)));
+        connect(&dlg, SIGNAL(receivedLine(QString)), &cache, SLOT(addLine(QString)));
+        if (!dlg.execute())
+            return false;
+
+        // a part of the log isn't worth keeping
+        if (!dlg.wasCancelled())
+            cache.save();
     }
 
     tagcombo[0]->addItem(QString());
@@ -407,14 +362,192 @@ bool LogDialog::parseCvsLog(OrgKdeCervisia5CvsserviceCvsserviceInterface *servic
 
     plain->scrollToTop();
 
-    tree->collectConnections();
-    tree->recomputeCellSizes();
+    tree->layoutRevisions();
+
+    // the filter may have been changed while the log arrived
+    applyFilter();
+
+    // warm the result cache of the service for the newest revision
+    QStringList revisions;
+    for (int row = 0; row < model->rowCount(); ++row)
+        revisions.append(model->revision(row)->m_revision.toString());
+
+    prefetcher = new RevisionPrefetcher(cvsService, filename, partConfig, this);
+    prefetcher->setRevisions(revisions);
+    if (!revisions.isEmpty())
+        prefetcher->prefetch(revisions.first());
 
     return true; // successful
 }
 
 //--------------------------------------------------------------------------------
 
+bool LogDialog::refreshLogCache(LogCache *cache)
+{
+    // the header has the current tags and the number of revisions
+    QStringList header;
+    if (!runLog(this, cvsService, cvsService->logHeader(filename), &header) || !cache->setHeader(header))
+        return false;
+
+    if (cache->isComplete())
+        return true;
+
+    const QString date = cache->updateStart().toString(QLatin1String("yyyy-MM-dd HH:mm:ss")) + QLatin1String(" UTC");
+    QStringList log;
+    return runLog(this, cvsService, cvsService->logSince(filename, date), &log) && cache->merge(log);
+}
+
+//--------------------------------------------------------------------------------
+
+void LogDialog::parseLogLine(const QString &line)
+{
+    if (parseState == Separator) {
+        pendingLines.append(line);
+
+        // a separator only ends the comment if the revision and the date
+        // line follow, so wait for the date line
+        if (pendingLines.count() == 2 && line.startsWith(QLatin1String("revision ")))
+            return;
+
+        const QStringList lines = pendingLines;
+        pendingLines.clear();
+
+        if (lines.count() == 3 && lines[2].startsWith(QLatin1String("date: "))) {
+            finishRevision();
+            parseState = Revision;
+        } else {
+            // still in message
+            parsedInfo.m_comment += '\n' + lines[0];
+            parseState = Comment;
+        }
+
+        for (int i = 1; i < lines.count(); ++i)
+            parseLogLine(lines[i]);
+        return;
+    }
+
+    switch (parseState) {
+    case Begin:
+        if (line == "symbolic names:")
+            parseState = Tags;
+        break;
+    case Tags:
+        if (line[0] == '\t') {
+            static const Cervisia::Revision vendorBranch(QStringLiteral("1.1.1"));
+
+            const QStringList strlist(splitLine(line, ':'));
+            Cervisia::Revision rev(strlist[1].simplified());
+            const QString tag(strlist[0].simplified());
+            Cervisia::Revision branchpoint;
+            if (rev.isMagicBranch()) {
+                // For a branch tag 2.10.0.6, we want:
+                // branchpoint = "2.10"
+                // rev = "2.10.6"
+                branchpoint = rev.branchpoint();
+                rev = rev.branch();
+            }
+            if (rev != vendorBranch) {
+                auto taginfo = new LogDialogTagInfo;
+                taginfo->rev = rev.toString();
+                taginfo->tag = tag;
+                taginfo->branchpoint = branchpoint.toString();
+                tags.append(taginfo);
+
+                tagsByRevision[rev].append(taginfo);
+                if (!branchpoint.isNull())
+                    tagsByBranchpoint[branchpoint].append(taginfo);
+            }
+        } else {
+            parseState = Admin;
+        }
+        break;
+    case Admin:
+        if (line == "----------------------------") {
+            parseState = Revision;
+        }
+        break;
+    case Revision:
+        if (line.startsWith(QLatin1String("revision "))) {
+            // e.g. "revision 1.2\tlocked by: user;"
+            parsedInfo.m_revision = Cervisia::Revision(line.section(' ', 1, 1).section('\t', 0, 0));
+            parseState = Author;
+        }
+        break;
+    case Author: {
+        if (line.startsWith(QLatin1String("date: "))) {
+            QStringList strList = line.split(';');
+
+            // convert date into ISO format (YYYY-MM-DDTHH:MM:SS)
+            int len = strList[0].length();
+            QString dateTimeStr = strList[0].right(len - 6); // remove 'date: '
+            dateTimeStr.replace('/', '-');
+
+            QString date = dateTimeStr.section(' ', 0, 0);
+            QString time = dateTimeStr.section(' ', 1, 1);
+            parsedInfo.m_dateTime.setTime_t(QDateTime::fromString(date + 'T' + time, Qt::ISODate).toTime_t());
+
+            parsedInfo.m_author = strList[1].section(':', 1, 1).trimmed();
+
+            parseState = Branches;
+        }
+    } break;
+    case Branches:
+        if (!line.startsWith(QLatin1String("branches:"))) {
+            parsedInfo.m_comment = line;
+            parseState = Comment;
+        }
+        break;
+    case Comment:
+        if (line == "----------------------------") {
+            pendingLines.append(line);
+            parseState = Separator;
+        } else if (line == "=============================================================================") {
+            finishRevision();
+            parseState = Finished;
+        } else {
+            // still in message
+            parsedInfo.m_comment += '\n' + line;
+        }
+        break;
+    case Separator:
+    case Finished:;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void LogDialog::finishRevision()
+{
+    const Cervisia::Revision &rev = parsedInfo.m_revision;
+
+    // Create tagcomment
+    // 1.60.x.y => revision belongs to branch 1.60.0.x
+    const Cervisia::Revision branchrev(rev.branch());
+
+    // Build Cervisia::TagInfo for logInfo. The names are implicitly shared
+    // with the symbolic names, so they aren't copied for each revision.
+
+    // The revision never matches branch tags...
+    foreach (const LogDialogTagInfo *tagInfo, tagsByRevision.value(rev))
+        parsedInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::Tag));
+    foreach (const LogDialogTagInfo *tagInfo, tagsByBranchpoint.value(rev))
+        parsedInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::Branch));
+    // ... and the branch never matches ordinary tags :-)
+    if (!branchrev.isNull()) {
+        foreach (const LogDialogTagInfo *tagInfo, tagsByRevision.value(branchrev))
+            parsedInfo.m_tags.push_back(Cervisia::TagInfo(tagInfo->tag, Cervisia::TagInfo::OnBranch));
+    }
+
+    // the list and the plain view show the model
+    tree->addRevision(parsedInfo);
+    model->addRevision(parsedInfo);
+
+    // reset for next entry
+    parsedInfo = Cervisia::LogInfo();
+}
+
+//--------------------------------------------------------------------------------
+
 void LogDialog::slotOk()
 {
     // make sure that the user selected a revision
@@ -534,28 +667,49 @@ void LogDialog::annotateClicked()
     ctl.showDialog(filename, selectionA);
 }
 
+void LogDialog::changesetClicked()
+{
+    if (selectionA.isEmpty())
+        return;
+
+    // Non-modal dialog
+    auto l = new ChangesetDialog(partConfig);
+    if (l->showChangeset(cvsService, filename, selectionA))
+        l->show();
+    else
+        delete l;
+}
+
 void LogDialog::revisionSelected(QString rev, bool rmb)
 {
-    foreach (Cervisia::LogInfo *logInfo, items)
-        if (logInfo->m_revision == rev) {
-            if (rmb)
-                selectionB = rev;
-            else
-                selectionA = rev;
-
-            revbox[rmb ? 1 : 0]->setText(rev);
-            authorbox[rmb ? 1 : 0]->setText(logInfo->m_author);
-            datebox[rmb ? 1 : 0]->setText(logInfo->dateTimeToString());
-            commentbox[rmb ? 1 : 0]->setPlainText(logInfo->m_comment);
-            tagsbox[rmb ? 1 : 0]->setPlainText(logInfo->tagsToString());
-
-            tree->setSelectedPair(selectionA, selectionB);
-            list->setSelectedPair(selectionA, selectionB);
-
-            updateButtons();
-            return;
-        }
-    qCDebug(log_cervisia) << "Internal error: Revision not found " << rev << ".";
+    const int row = model->findRevision(rev);
+    if (row < 0) {
+        qCDebug(log_cervisia) << "Internal error: Revision not found " << rev << ".";
+        return;
+    }
+
+    const Cervisia::LogInfo *logInfo = model->revision(row);
+
+    if (rmb)
+        selectionB = rev;
+    else
+        selectionA = rev;
+
+    revbox[rmb ? 1 : 0]->setText(rev);
+    authorbox[rmb ? 1 : 0]->setText(logInfo->m_author);
+    datebox[rmb ? 1 : 0]->setText(logInfo->dateTimeToString());
+    commentbox[rmb ? 1 : 0]->setPlainText(logInfo->m_comment);
+    tagsbox[rmb ? 1 : 0]->setPlainText(logInfo->tagsToString());
+
+    tree->setSelectedPair(selectionA, selectionB);
+    list->setSelectedPair(selectionA, selectionB);
+
+    // revision A is used for annotate, view and as the
+    // newer side of a diff against its predecessor
+    if (!rmb && prefetcher)
+        prefetcher->prefetch(rev);
+
+    updateButtons();
 }
 
 void LogDialog::tagSelected(LogDialogTagInfo *tag, bool rmb)
@@ -572,6 +726,7 @@ void LogDialog::updateButtons()
     if (selectionA.isEmpty() && selectionB.isEmpty()) {
         user1Button->setEnabled(true);
         user2Button->setEnabled(false);
+        user4Button->setEnabled(false);
         okButton->setEnabled(false); // view
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false); // create patch
     }
@@ -579,6 +734,7 @@ void LogDialog::updateButtons()
     else if (!selectionA.isEmpty() && !selectionB.isEmpty()) {
         user1Button->setEnabled(true);
         user2Button->setEnabled(true);
+        user4Button->setEnabled(true);
         okButton->setEnabled(true); // view A
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true); // create patch
     }
@@ -586,6 +742,7 @@ void LogDialog::updateButtons()
     else {
         user1Button->setEnabled(true);
         user2Button->setEnabled(true);
+        user4Button->setEnabled(!selectionA.isEmpty());
         okButton->setEnabled(true); // view
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true); // create patch
     }
@@ -603,6 +760,36 @@ void LogDialog::tagBSelected(int n)
         tagSelected(tags.at(n - 1), true);
 }
 
+void LogDialog::applyFilter()
+{
+    const QString text(filterEdit->text().trimmed());
+
+    QBitArray matches;
+    if (!text.isEmpty() || taggedBox->isChecked() || mineBox->isChecked()) {
+        QString query('(' + text + ')');
+        if (taggedBox->isChecked())
+            query += QLatin1String(" is:tagged");
+        if (mineBox->isChecked())
+            query += QLatin1String(" is:mine");
+
+        QString errorMessage;
+        matches = model->logIndex().query(query, &errorMessage);
+        if (matches.isNull()) {
+            // keep the last result while the query is typed
+            filterStatus->setText(errorMessage);
+            return;
+        }
+
+        filterStatus->setText(i18np("1 of %2 revisions", "%1 of %2 revisions", matches.count(true), matches.size()));
+    } else {
+        filterStatus->clear();
+    }
+
+    tree->setMatches(matches);
+    list->setMatches(matches);
+    plain->setMatches(matches);
+}
+
 void LogDialog::tabChanged(int index)
 {
     bool isPlainView = (tabWidget->widget(index) == plain);
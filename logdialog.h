@@ -24,13 +24,19 @@
 
 #include "loginfo.h"
 
+#include <qhash.h>
 #include <qlist.h>
 
+class LogCache;
 class LogListView;
+class LogModel;
 class LogTreeView;
 class LogPlainView;
+class RevisionPrefetcher;
 
 class KComboBox;
+class QCheckBox;
+class QLineEdit;
 class QLabel;
 class QSplitter;
 class QTabWidget;
@@ -68,35 +74,54 @@ private Q_SLOTS:
     void findClicked();
     void diffClicked();
     void annotateClicked();
+    void changesetClicked();
     void revisionSelected(QString rev, bool rmb);
     void tagASelected(int n);
     void tagBSelected(int n);
     void tabChanged(int index);
+    void parseLogLine(const QString &line);
+    void applyFilter();
 
 private:
+    enum ParseState { Begin, Tags, Admin, Revision, Author, Branches, Comment, Separator, Finished };
+
+    void finishRevision();
     void tagSelected(LogDialogTagInfo *tag, bool rmb);
     void updateButtons();
+    bool refreshLogCache(LogCache *cache);
+
+    // state of the parser of the cvs log output
+    ParseState parseState;
+    Cervisia::LogInfo parsedInfo; // revision which is parsed
+    QStringList pendingLines; // separator within a comment and the lines after it
 
     QSplitter *splitter;
     QString filename;
-    QList<Cervisia::LogInfo *> items;
     QList<LogDialogTagInfo *> tags;
+    QHash<Cervisia::Revision, QList<LogDialogTagInfo *>> tagsByRevision; // also by branch, e.g. 1.2.2
+    QHash<Cervisia::Revision, QList<LogDialogTagInfo *>> tagsByBranchpoint;
     QString selectionA;
     QString selectionB;
+    LogModel *model; // the parsed revisions
     LogTreeView *tree;
     LogListView *list;
     LogPlainView *plain;
     QTabWidget *tabWidget;
+    QLineEdit *filterEdit;
+    QCheckBox *taggedBox;
+    QCheckBox *mineBox;
+    QLabel *filterStatus;
     QLabel *revbox[2];
     QLabel *authorbox[2];
     QLabel *datebox[2];
     KTextEdit *commentbox[2];
     KTextEdit *tagsbox[2];
     KComboBox *tagcombo[2];
-    QPushButton *user1Button, *user2Button, *user3Button, *okButton;
+    QPushButton *user1Button, *user2Button, *user3Button, *user4Button, *okButton;
     QDialogButtonBox *buttonBox;
 
     OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    RevisionPrefetcher *prefetcher;
     KConfig &partConfig;
 };
 
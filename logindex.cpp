@@ -0,0 +1,346 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "logindex.h"
+
+#include <QDateTime>
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+#include <KLocalizedString>
+#include <KUser>
+
+#include <algorithm>
+#include <limits>
+
+#include "loginfo.h"
+
+namespace
+{
+// rows of the revisions in ascending order
+using Postings = QVector<int>;
+
+struct Query {
+    QStringList tokens;
+    int pos;
+    QString error;
+
+    bool atEnd() const
+    {
+        return pos >= tokens.count();
+    }
+
+    QString peek() const
+    {
+        return atEnd() ? QString() : tokens.at(pos);
+    }
+};
+
+QStringList words(const QString &text)
+{
+    QStringList result;
+
+    int start = -1;
+    for (int i = 0; i <= text.length(); ++i) {
+        const bool isWordChar = i < text.length() && text.at(i).isLetterOrNumber();
+        if (isWordChar && start < 0) {
+            start = i;
+        } else if (!isWordChar && start >= 0) {
+            result.append(text.mid(start, i - start).toLower());
+            start = -1;
+        }
+    }
+
+    return result;
+}
+
+QStringList tokenize(const QString &query)
+{
+    QStringList tokens;
+    QString token;
+    bool quoted = false;
+
+    foreach (const QChar c, query) {
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (c.isSpace() || c == '(' || c == ')')) {
+            if (!token.isEmpty())
+                tokens.append(token);
+            token.clear();
+            if (!c.isSpace())
+                tokens.append(QString(c));
+        } else {
+            token += c;
+        }
+    }
+    if (!token.isEmpty())
+        tokens.append(token);
+
+    return tokens;
+}
+
+void addPosting(Postings &postings, int row)
+{
+    // a word can appear more than once in a comment
+    if (postings.isEmpty() || postings.last() != row)
+        postings.append(row);
+}
+
+// the period [from, to) of yyyy, yyyy-MM or yyyy-MM-dd
+bool parseDate(const QString &text, qint64 *from, qint64 *to)
+{
+    QDate begin, end;
+    if ((begin = QDate::fromString(text, QLatin1String("yyyy-MM-dd"))).isValid())
+        end = begin.addDays(1);
+    else if ((begin = QDate::fromString(text, QLatin1String("yyyy-MM"))).isValid())
+        end = begin.addMonths(1);
+    else if ((begin = QDate::fromString(text, QLatin1String("yyyy"))).isValid())
+        end = begin.addYears(1);
+    else
+        return false;
+
+    *from = begin.startOfDay().toMSecsSinceEpoch();
+    *to = end.startOfDay().toMSecsSinceEpoch();
+    return true;
+}
+}
+
+struct LogIndex::Private {
+    Private()
+        : count(0)
+        , datesSorted(true)
+    {
+    }
+
+    QMap<QString, Postings> words; // of the comments
+    QMap<QString, Postings> authors;
+    QMap<QString, Postings> tags;
+    QBitArray tagged;
+    int count;
+
+    // sorted before the first date query after new revisions were added
+    mutable QVector<QPair<qint64, int>> dates;
+    mutable bool datesSorted;
+
+    QBitArray prefixMatch(const QMap<QString, Postings> &map, const QString &prefix) const;
+    QBitArray textMatch(const QString &text) const;
+    QBitArray dateMatch(qint64 from, qint64 to) const;
+
+    QBitArray parseOr(Query &query) const;
+    QBitArray parseAnd(Query &query) const;
+    QBitArray parseUnary(Query &query) const;
+    QBitArray parseTerm(Query &query, const QString &term) const;
+};
+
+QBitArray LogIndex::Private::prefixMatch(const QMap<QString, Postings> &map, const QString &prefix) const
+{
+    QBitArray result(count);
+
+    for (auto it = map.lowerBound(prefix); it != map.constEnd() && it.key().startsWith(prefix); ++it) {
+        foreach (int row, it.value())
+            result.setBit(row);
+    }
+
+    return result;
+}
+
+QBitArray LogIndex::Private::textMatch(const QString &text) const
+{
+    const QStringList textWords(::words(text));
+    if (textWords.isEmpty())
+        return QBitArray(count);
+
+    QBitArray result(count, true);
+    foreach (const QString &word, textWords)
+        result &= prefixMatch(words, word);
+
+    return result;
+}
+
+QBitArray LogIndex::Private::dateMatch(qint64 from, qint64 to) const
+{
+    if (!datesSorted) {
+        std::sort(dates.begin(), dates.end());
+        datesSorted = true;
+    }
+
+    QBitArray result(count);
+
+    auto it = std::lower_bound(dates.constBegin(), dates.constEnd(), qMakePair(from, -1));
+    for (; it != dates.constEnd() && it->first < to; ++it)
+        result.setBit(it->second);
+
+    return result;
+}
+
+QBitArray LogIndex::Private::parseOr(Query &query) const
+{
+    QBitArray result(parseAnd(query));
+
+    while (query.error.isEmpty() && query.peek() == QLatin1String("OR")) {
+        ++query.pos;
+        result |= parseAnd(query);
+    }
+
+    return result;
+}
+
+QBitArray LogIndex::Private::parseAnd(Query &query) const
+{
+    QBitArray result(count, true);
+
+    while (query.error.isEmpty() && !query.atEnd() && query.peek() != QLatin1String(")") && query.peek() != QLatin1String("OR"))
+        result &= parseUnary(query);
+
+    return result;
+}
+
+QBitArray LogIndex::Private::parseUnary(Query &query) const
+{
+    const QString token(query.tokens.at(query.pos++));
+
+    if (token == QLatin1String("NOT")) {
+        if (query.atEnd()) {
+            query.error = i18n("NOT without a term");
+            return QBitArray(count);
+        }
+        return ~parseUnary(query);
+    }
+
+    if (token == QLatin1String("(")) {
+        const QBitArray result(parseOr(query));
+        if (query.error.isEmpty() && query.peek() != QLatin1String(")"))
+            query.error = i18n("Missing )");
+        ++query.pos;
+        return result;
+    }
+
+    if (token.length() > 1 && token.startsWith('-'))
+        return ~parseTerm(query, token.mid(1));
+
+    return parseTerm(query, token);
+}
+
+QBitArray LogIndex::Private::parseTerm(Query &query, const QString &term) const
+{
+    const int colon = term.indexOf(':');
+    if (colon <= 0) {
+        const QString name(term.toLower());
+        return textMatch(term) | prefixMatch(authors, name) | prefixMatch(tags, name);
+    }
+
+    const QString field(term.left(colon).toLower());
+    const QString value(term.mid(colon + 1));
+
+    if (field == QLatin1String("author"))
+        return prefixMatch(authors, value.toLower());
+    if (field == QLatin1String("tag"))
+        return prefixMatch(tags, value.toLower());
+    if (field == QLatin1String("comment"))
+        return textMatch(value);
+
+    if (field == QLatin1String("after") || field == QLatin1String("before") || field == QLatin1String("date")) {
+        qint64 from, to;
+        if (!parseDate(value, &from, &to)) {
+            query.error = i18n("Invalid date: %1", value);
+            return QBitArray(count);
+        }
+
+        if (field == QLatin1String("after"))
+            return dateMatch(from, std::numeric_limits<qint64>::max());
+        if (field == QLatin1String("before"))
+            return dateMatch(std::numeric_limits<qint64>::min(), from);
+        return dateMatch(from, to);
+    }
+
+    if (field == QLatin1String("is")) {
+        if (value == QLatin1String("tagged"))
+            return tagged;
+        if (value == QLatin1String("mine")) {
+            QBitArray result(count);
+            foreach (int row, authors.value(KUser().loginName().toLower()))
+                result.setBit(row);
+            return result;
+        }
+        query.error = i18n("Unknown condition: %1", term);
+        return QBitArray(count);
+    }
+
+    query.error = i18n("Unknown field: %1", field);
+    return QBitArray(count);
+}
+
+LogIndex::LogIndex()
+    : d(new Private)
+{
+}
+
+LogIndex::~LogIndex()
+{
+    delete d;
+}
+
+void LogIndex::addRevision(const Cervisia::LogInfo &logInfo)
+{
+    const int row = d->count++;
+
+    foreach (const QString &word, ::words(logInfo.m_comment))
+        addPosting(d->words[word], row);
+
+    addPosting(d->authors[logInfo.m_author.toLower()], row);
+
+    d->tagged.resize(d->count);
+    for (Cervisia::LogInfo::TTagInfoSeq::const_iterator it = logInfo.m_tags.begin(); it != logInfo.m_tags.end(); ++it) {
+        addPosting(d->tags[(*it).m_name.toLower()], row);
+        if ((*it).m_type == Cervisia::TagInfo::Tag)
+            d->tagged.setBit(row);
+    }
+
+    d->dates.append(qMakePair(logInfo.m_dateTime.toMSecsSinceEpoch(), row));
+    d->datesSorted = false;
+}
+
+int LogIndex::count() const
+{
+    return d->count;
+}
+
+QBitArray LogIndex::query(const QString &query, QString *errorMessage) const
+{
+    Query q;
+    q.tokens = tokenize(query);
+    q.pos = 0;
+
+    QBitArray result(d->parseOr(q));
+    if (q.error.isEmpty() && !q.atEnd())
+        q.error = i18n("Unexpected %1", q.peek());
+
+    if (!q.error.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = q.error;
+        return QBitArray();
+    }
+
+    return result;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
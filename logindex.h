@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include <QBitArray>
+#include <QString>
+
+namespace Cervisia
+{
+struct LogInfo;
+}
+
+/**
+ * Inverted index over the comments, authors, tags and dates of the
+ * revisions of a log. It is filled while the log is parsed and answers
+ * the queries of the filter of the log dialog.
+ *
+ * All terms of a query must match. Terms can be combined with OR, negated
+ * with a leading - or NOT and grouped with parentheses. A term without a
+ * field matches the words of the comments, the authors and the tags:
+ *
+ *   author:NAME  tag:NAME  comment:WORDS  is:tagged  is:mine
+ *   after:DATE  before:DATE  date:DATE
+ *
+ * Words and names match case insensitive as prefixes. A DATE is given as
+ * yyyy, yyyy-MM or yyyy-MM-dd. date: matches the whole year, month or day,
+ * after: everything from its beginning and before: everything before it.
+ */
+class LogIndex
+{
+public:
+    LogIndex();
+    ~LogIndex();
+
+    /**
+     * Adds the next revision of the log.
+     */
+    void addRevision(const Cervisia::LogInfo &logInfo);
+
+    int count() const;
+
+    /**
+     * @return A bit for each revision in the order of the log which is set
+     *         when the revision matches @p query. When the query is
+     *         invalid, a null array is returned and @p errorMessage is set.
+     */
+    QBitArray query(const QString &query, QString *errorMessage = 0) const;
+
+private:
+    struct Private;
+    Private *d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
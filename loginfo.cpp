@@ -64,7 +64,7 @@ QString TagInfo::typeToString() const
 QString LogInfo::createToolTipText(bool showTime) const
 {
     QString text(QLatin1String("<nobr><b>"));
-    text += m_revision.toHtmlEscaped();
+    text += m_revision.toString();
     text += QLatin1String("</b>&nbsp;&nbsp;");
     text += m_author.toHtmlEscaped();
     text += QLatin1String("&nbsp;&nbsp;<b>");
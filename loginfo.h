@@ -19,10 +19,12 @@
 #ifndef CERVISIA_LOGINFO_H
 #define CERVISIA_LOGINFO_H
 
-#include <QList>
+#include <QVector>
 #include <qdatetime.h>
 #include <qstring.h>
 
+#include "revision.h"
+
 namespace Cervisia
 {
 
@@ -83,7 +85,7 @@ struct TagInfo {
  * convenience methods.
  */
 struct LogInfo {
-    using TTagInfoSeq = QList<TagInfo>;
+    using TTagInfoSeq = QVector<TagInfo>;
 
     /**
      * @param showTime show commit time in tooltip.
@@ -119,7 +121,7 @@ struct LogInfo {
     /**
      * The revision of this entry.
      */
-    QString m_revision;
+    Revision m_revision;
 
     /**
      * The author who committed.
@@ -23,87 +23,31 @@
 #include <qnamespace.h>
 
 #include <QHeaderView>
+#include <QItemSelection>
 
 #include <KConfig>
 #include <KConfigGroup>
-#include <klocalizedstring.h>
 
 #include "loginfo.h"
-#include "misc.h"
+#include "logmodel.h"
 #include "tooltip.h"
 
-class LogListViewItem : public QTreeWidgetItem
-{
-public:
-    enum { Revision, Author, Date, Branch, Comment, Tags };
-
-    LogListViewItem(QTreeWidget *list, const Cervisia::LogInfo &logInfo);
-
-    bool operator<(const QTreeWidgetItem &other) const override;
-
-private:
-    static QString truncateLine(const QString &s);
-
-    Cervisia::LogInfo m_logInfo;
-    friend class LogListView;
-};
-
-LogListViewItem::LogListViewItem(QTreeWidget *list, const Cervisia::LogInfo &logInfo)
-    : QTreeWidgetItem(list)
-    , m_logInfo(logInfo)
-{
-    setText(Revision, logInfo.m_revision);
-    setText(Author, logInfo.m_author);
-    setText(Date, logInfo.dateTimeToString());
-    setText(Comment, truncateLine(logInfo.m_comment));
-
-    for (Cervisia::LogInfo::TTagInfoSeq::const_iterator it = logInfo.m_tags.begin(); it != logInfo.m_tags.end(); ++it) {
-        const Cervisia::TagInfo &tagInfo(*it);
-
-        if (tagInfo.m_type == Cervisia::TagInfo::OnBranch) {
-            setText(Branch, tagInfo.m_name);
-        }
-    }
-
-    setText(Tags, logInfo.tagsToString(Cervisia::TagInfo::Tag, Cervisia::LogInfo::NoTagType, QLatin1String(", ")));
-}
-
-QString LogListViewItem::truncateLine(const QString &s)
-{
-    int pos;
-
-    QString res = s.simplified();
-    if ((pos = res.indexOf('\n')) != -1)
-        res = res.left(pos) + "...";
-
-    return res;
-}
-
-bool LogListViewItem::operator<(const QTreeWidgetItem &other) const
-{
-    const auto &item = static_cast<const LogListViewItem &>(other);
-
-    switch (treeWidget()->sortColumn()) {
-    case Revision:
-        return ::compareRevisions(m_logInfo.m_revision, item.m_logInfo.m_revision) == -1;
-    case Date:
-        return ::compare(m_logInfo.m_dateTime, item.m_logInfo.m_dateTime) == -1;
-    }
-
-    return QTreeWidgetItem::operator<(other);
-}
-
-LogListView::LogListView(KConfig &cfg, QWidget *parent)
-    : QTreeWidget(parent)
+LogListView::LogListView(KConfig &cfg, LogModel *model, QWidget *parent)
+    : QTreeView(parent)
     , partConfig(cfg)
+    , m_model(model)
 {
+    m_sortModel = new LogSortModel(this);
+    m_sortModel->setSourceModel(model);
+    setModel(m_sortModel);
+
     setAllColumnsShowFocus(true);
     header()->setSortIndicatorShown(true);
     setSelectionMode(QAbstractItemView::NoSelection);
     setRootIsDecorated(false);
+    setUniformRowHeights(true);
     setSortingEnabled(true);
-    sortByColumn(LogListViewItem::Revision, Qt::DescendingOrder);
-    setHeaderLabels(QStringList() << i18n("Revision") << i18n("Author") << i18n("Date") << i18n("Branch") << i18n("Comment") << i18n("Tags"));
+    sortByColumn(LogModel::RevisionColumn, Qt::DescendingOrder);
 
     auto toolTip = new Cervisia::ToolTip(viewport());
 
@@ -118,28 +62,53 @@ LogListView::~LogListView()
     partConfig.group("LogList view").writeEntry("Columns", header()->saveState());
 }
 
-void LogListView::addRevision(const Cervisia::LogInfo &logInfo)
+void LogListView::setSelectedPair(const QString &selectionA, const QString &selectionB)
 {
-    (void)new LogListViewItem(this, logInfo);
+    m_selectionA = selectionA;
+    m_selectionB = selectionB;
+
+    updateSelection();
 }
 
-void LogListView::setSelectedPair(const QString &selectionA, const QString &selectionB)
+void LogListView::setMatches(const QBitArray &matches)
 {
-    for (int j = 0; j < topLevelItemCount(); j++) {
-        auto i = static_cast<LogListViewItem *>(topLevelItem(j));
-        i->setSelected(selectionA == i->text(LogListViewItem::Revision) || selectionB == i->text(LogListViewItem::Revision));
+    m_sortModel->setMatches(matches);
+
+    // the selection of hidden revisions is lost
+    updateSelection();
+}
+
+void LogListView::updateSelection()
+{
+    QItemSelection selection;
+
+    foreach (const QString &revision, QStringList() << m_selectionA << m_selectionB) {
+        const int row = m_model->findRevision(revision);
+        if (row < 0)
+            continue;
+
+        const QModelIndex index(m_sortModel->mapFromSource(m_model->index(row, 0)));
+        if (index.isValid())
+            selection.select(index, index.sibling(index.row(), LogModel::ColumnCount - 1));
     }
+
+    selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+}
+
+QString LogListView::revisionAt(const QModelIndex &index) const
+{
+    return m_model->revision(m_sortModel->mapToSource(index).row())->m_revision.toString();
 }
 
 void LogListView::mousePressEvent(QMouseEvent *e)
 {
     // Retrieve selected item
-    const LogListViewItem *selItem = static_cast<LogListViewItem *>(itemAt(e->pos()));
-    if (!selItem)
+    const QModelIndex index(indexAt(e->pos()));
+    if (!index.isValid())
         return;
 
     // Retrieve revision
-    const QString revision = selItem->text(LogListViewItem::Revision);
+    const QString revision = revisionAt(index);
 
     if (e->button() == Qt::LeftButton) {
         // If the control key was pressed, then we change revision B not A
@@ -155,13 +124,12 @@ void LogListView::keyPressEvent(QKeyEvent *e)
 {
     switch (e->key()) {
     case Qt::Key_A:
-        if (currentItem())
-            Q_EMIT revisionClicked(currentItem()->text(LogListViewItem::Revision), false);
-        break;
+        if (currentIndex().isValid())
+            Q_EMIT revisionClicked(revisionAt(currentIndex()), false);
         break;
     case Qt::Key_B:
-        if (currentItem())
-            Q_EMIT revisionClicked(currentItem()->text(LogListViewItem::Revision), true);
+        if (currentIndex().isValid())
+            Q_EMIT revisionClicked(revisionAt(currentIndex()), true);
         break;
     case Qt::Key_Backspace:
     case Qt::Key_Delete:
@@ -172,7 +140,7 @@ void LogListView::keyPressEvent(QKeyEvent *e)
     case Qt::Key_PageDown:
     case Qt::Key_PageUp:
         if (e->modifiers() == Qt::NoModifier)
-            QTreeWidget::keyPressEvent(e);
+            QTreeView::keyPressEvent(e);
         else
             QApplication::postEvent(this, new QKeyEvent(QEvent::KeyPress, e->key(), Qt::NoModifier, e->text()));
         break;
@@ -184,9 +152,10 @@ void LogListView::keyPressEvent(QKeyEvent *e)
 
 void LogListView::slotQueryToolTip(const QPoint &viewportPos, QRect &viewportRect, QString &text)
 {
-    if (const LogListViewItem *item = static_cast<LogListViewItem *>(itemAt(viewportPos))) {
-        viewportRect = visualRect(indexAt(viewportPos));
-        text = item->m_logInfo.createToolTipText();
+    const QModelIndex index(indexAt(viewportPos));
+    if (index.isValid()) {
+        viewportRect = visualRect(index);
+        text = m_model->revision(m_sortModel->mapToSource(index).row())->createToolTipText();
     }
 }
 
@@ -22,29 +22,32 @@
 
 #include <QKeyEvent>
 #include <QMouseEvent>
-#include <QTreeWidget>
+#include <QTreeView>
 
-class KConfig;
+class QBitArray;
 
-namespace Cervisia
-{
-struct LogInfo;
-}
+class KConfig;
+class LogModel;
+class LogSortModel;
 
-class LogListView : public QTreeWidget
+class LogListView : public QTreeView
 {
     Q_OBJECT
 
 public:
-    explicit LogListView(KConfig &cfg, QWidget *parent);
+    explicit LogListView(KConfig &cfg, LogModel *model, QWidget *parent);
     ~LogListView() override;
 
-    void addRevision(const Cervisia::LogInfo &logInfo);
     void setSelectedPair(const QString &selectionA, const QString &selectionB);
 
 Q_SIGNALS:
     void revisionClicked(QString rev, bool rmb);
 
+    /**
+     * Shows only the revisions of @p matches, see LogSortModel::setMatches().
+     */
+    void setMatches(const QBitArray &matches);
+
 protected:
     void mousePressEvent(QMouseEvent *e) override;
     void keyPressEvent(QKeyEvent *e) override;
@@ -54,7 +57,14 @@ private Q_SLOTS:
     void slotQueryToolTip(const QPoint &, QRect &, QString &);
 
 private:
+    QString revisionAt(const QModelIndex &index) const;
+    void updateSelection();
+
     KConfig &partConfig;
+    LogModel *m_model;
+    LogSortModel *m_sortModel;
+    QString m_selectionA;
+    QString m_selectionB;
 };
 
 #endif
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "logmodel.h"
+
+#include <KLocalizedString>
+
+#include "loginfo.h"
+#include "misc.h"
+
+static QString truncateLine(const QString &s)
+{
+    int pos;
+
+    QString res = s.simplified();
+    if ((pos = res.indexOf('\n')) != -1)
+        res = res.left(pos) + "...";
+
+    return res;
+}
+
+LogModel::LogModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+LogModel::~LogModel()
+{
+    qDeleteAll(m_revisions);
+}
+
+void LogModel::addRevision(const Cervisia::LogInfo &logInfo)
+{
+    const int row = m_revisions.count();
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_revisions.append(new Cervisia::LogInfo(logInfo));
+    m_rows.insert(logInfo.m_revision, row);
+    m_index.addRevision(logInfo);
+    endInsertRows();
+}
+
+const Cervisia::LogInfo *LogModel::revision(int row) const
+{
+    return m_revisions.at(row);
+}
+
+int LogModel::findRevision(const QString &revision) const
+{
+    return m_rows.value(Cervisia::Revision(revision), -1);
+}
+
+const LogIndex &LogModel::logIndex() const
+{
+    return m_index;
+}
+
+int LogModel::columnCount(const QModelIndex & /*parent*/) const
+{
+    return ColumnCount;
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_revisions.count();
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_revisions.count() || role != Qt::DisplayRole)
+        return {};
+
+    const Cervisia::LogInfo &logInfo = *m_revisions.at(index.row());
+
+    switch (index.column()) {
+    case RevisionColumn:
+        return logInfo.m_revision.toString();
+    case AuthorColumn:
+        return logInfo.m_author;
+    case DateColumn:
+        return logInfo.dateTimeToString();
+    case BranchColumn: {
+        QString branch;
+        for (Cervisia::LogInfo::TTagInfoSeq::const_iterator it = logInfo.m_tags.begin(); it != logInfo.m_tags.end(); ++it) {
+            if ((*it).m_type == Cervisia::TagInfo::OnBranch)
+                branch = (*it).m_name;
+        }
+        return branch;
+    }
+    case CommentColumn:
+        return truncateLine(logInfo.m_comment);
+    case TagsColumn:
+        return logInfo.tagsToString(Cervisia::TagInfo::Tag, Cervisia::LogInfo::NoTagType, QLatin1String(", "));
+    default:
+        return {};
+    }
+}
+
+QVariant LogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    // only provide text for the headers
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return {};
+
+    switch (section) {
+    case RevisionColumn:
+        return i18n("Revision");
+    case AuthorColumn:
+        return i18n("Author");
+    case DateColumn:
+        return i18n("Date");
+    case BranchColumn:
+        return i18n("Branch");
+    case CommentColumn:
+        return i18n("Comment");
+    case TagsColumn:
+        return i18n("Tags");
+    default:
+        return {};
+    }
+}
+
+LogSortModel::LogSortModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+void LogSortModel::setMatches(const QBitArray &matches)
+{
+    m_matches = matches;
+    invalidateFilter();
+}
+
+bool LogSortModel::filterAcceptsRow(int sourceRow, const QModelIndex & /*sourceParent*/) const
+{
+    // revisions which were added after the query aren't filtered yet
+    return m_matches.isNull() || sourceRow >= m_matches.size() || m_matches.testBit(sourceRow);
+}
+
+bool LogSortModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const auto model = static_cast<const LogModel *>(sourceModel());
+    const Cervisia::LogInfo *leftInfo = model->revision(left.row());
+    const Cervisia::LogInfo *rightInfo = model->revision(right.row());
+
+    switch (left.column()) {
+    case LogModel::RevisionColumn:
+        return leftInfo->m_revision < rightInfo->m_revision;
+    case LogModel::DateColumn:
+        return ::compare(leftInfo->m_dateTime, rightInfo->m_dateTime) == -1;
+    }
+
+    return QSortFilterProxyModel::lessThan(left, right);
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
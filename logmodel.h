@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QHash>
+#include <QSortFilterProxyModel>
+
+#include "logindex.h"
+#include "revision.h"
+
+namespace Cervisia
+{
+struct LogInfo;
+}
+
+/**
+ * The revisions of a log in the order of the log, shared by the views of
+ * the log dialog. The texts of the columns are only created when a view
+ * asks for them.
+ */
+class LogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Columns { RevisionColumn = 0, AuthorColumn, DateColumn, BranchColumn, CommentColumn, TagsColumn, ColumnCount };
+
+    explicit LogModel(QObject *parent = nullptr);
+    ~LogModel() override;
+
+    void addRevision(const Cervisia::LogInfo &logInfo);
+
+    const Cervisia::LogInfo *revision(int row) const;
+
+    /**
+     * @return The row of @p revision or -1 if it isn't in the log.
+     */
+    int findRevision(const QString &revision) const;
+
+    const LogIndex &logIndex() const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QList<Cervisia::LogInfo *> m_revisions;
+    QHash<Cervisia::Revision, int> m_rows;
+    LogIndex m_index;
+};
+
+/**
+ * Sorts revisions and dates by their value instead of their text and
+ * shows only the revisions which match the filter.
+ */
+class LogSortModel : public QSortFilterProxyModel
+{
+public:
+    explicit LogSortModel(QObject *parent = nullptr);
+
+    /**
+     * @param matches a bit for each revision of the log as returned by
+     *        LogIndex::query(), a null array shows all revisions
+     */
+    void setMatches(const QBitArray &matches);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    QBitArray m_matches;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -19,17 +19,26 @@
 #include "logplainview.h"
 
 #include "loginfo.h"
+#include "logmodel.h"
 #include <KLocalizedString>
 #include <QScrollBar>
+#include <QTimer>
 #include <kfind.h>
 #include <kfinddialog.h>
 
 using namespace Cervisia;
 
-LogPlainView::LogPlainView(QWidget *parent)
+// number of revisions which are rendered at once
+static const int RENDER_CHUNK = 50;
+
+LogPlainView::LogPlainView(LogModel *model, QWidget *parent)
     : QTextBrowser(parent)
+    , m_model(model)
+    , m_renderedCount(0)
     , m_find(0)
 {
+    connect(model, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(renderVisibleRevisions()));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(renderVisibleRevisions()));
 }
 
 LogPlainView::~LogPlainView()
@@ -38,44 +47,110 @@ LogPlainView::~LogPlainView()
     m_find = 0;
 }
 
-void LogPlainView::addRevision(const LogInfo &logInfo)
+void LogPlainView::showEvent(QShowEvent *event)
+{
+    QTextBrowser::showEvent(event);
+
+    renderVisibleRevisions();
+}
+
+void LogPlainView::renderVisibleRevisions()
+{
+    if (!isVisible() || m_renderedCount >= m_model->rowCount())
+        return;
+
+    // keep a page below the visible part rendered
+    const QScrollBar *scrollBar = verticalScrollBar();
+    if (scrollBar->maximum() - scrollBar->value() > 2 * viewport()->height())
+        return;
+
+    renderRevisions(RENDER_CHUNK);
+
+    // check again when the new text is laid out
+    QTimer::singleShot(0, this, SLOT(renderVisibleRevisions()));
+}
+
+void LogPlainView::setMatches(const QBitArray &matches)
+{
+    if (matches.isNull() && m_matches.isNull())
+        return;
+
+    // a running search refers to the old text
+    delete m_find;
+    m_find = 0;
+
+    m_matches = matches;
+    m_renderedCount = 0;
+    clear();
+
+    renderVisibleRevisions();
+}
+
+void LogPlainView::renderRevisions(int count)
+{
+    QString html;
+    for (; count > 0 && m_renderedCount < m_model->rowCount(); ++m_renderedCount) {
+        // revisions which are added later aren't filtered yet
+        const int row = m_renderedCount;
+        if (!m_matches.isNull() && row < m_matches.size() && !m_matches.testBit(row))
+            continue;
+
+        html += revisionToHtml(*m_model->revision(row));
+        --count;
+    }
+
+    if (html.isEmpty())
+        return;
+
+    // append without moving the cursor of the view
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+
+    // workaround Qt bug (TT ID 166111)
+    const QTextBlockFormat blockFmt(cursor.blockFormat());
+
+    cursor.insertHtml(html);
+
+    cursor.setBlockFormat(blockFmt);
+}
+
+QString LogPlainView::revisionToHtml(const LogInfo &logInfo)
 {
     // assemble revision information lines
     QString logEntry;
 
-    logEntry += "<b>" + i18n("revision %1", logInfo.m_revision.toHtmlEscaped()) + "</b>";
-    logEntry += " &nbsp;[<a href=\"revA#" + logInfo.m_revision.toHtmlEscaped() + "\">" + i18n("Select for revision A") + "</a>]";
-    logEntry += " [<a href=\"revB#" + logInfo.m_revision.toHtmlEscaped() + "\">" + i18n("Select for revision B") + "</a>]<br>";
+    const QString revision(logInfo.m_revision.toString());
+    logEntry += "<b>" + i18n("revision %1", revision) + "</b>";
+    logEntry += " &nbsp;[<a href=\"revA#" + revision + "\">" + i18n("Select for revision A") + "</a>]";
+    logEntry += " [<a href=\"revB#" + revision + "\">" + i18n("Select for revision B") + "</a>]<br>";
     logEntry += "<i>" + i18n("date: %1; author: %2", logInfo.dateTimeToString().toHtmlEscaped(), logInfo.m_author.toHtmlEscaped()) + "</i><br><br>";
 
-    insertHtml(logEntry);
-
     const QLatin1String lineBreak("<br>");
 
-    insertPlainText(logInfo.m_comment);
-    insertHtml(lineBreak);
+    // the comment is plain text
+    QString comment(logInfo.m_comment.toHtmlEscaped());
+    comment.replace('\n', lineBreak);
+    logEntry += "<span style=\"white-space: pre-wrap\">" + comment + "</span>" + lineBreak;
 
     for (LogInfo::TTagInfoSeq::const_iterator it = logInfo.m_tags.begin(); it != logInfo.m_tags.end(); ++it) {
-        insertHtml("<br><i>" + (*it).toString().toHtmlEscaped() + "</i>");
+        logEntry += "<br><i>" + (*it).toString().toHtmlEscaped() + "</i>";
     }
 
     // add an empty line when we had tags or branches
     if (!logInfo.m_tags.empty())
-        insertHtml(lineBreak);
-    // seems to be superfluous with Qt 4.4
-    // insertHtml(lineBreak);
-
-    // workaround Qt bug (TT ID 166111)
-    const QTextBlockFormat blockFmt(textCursor().blockFormat());
+        logEntry += lineBreak;
 
     // add horizontal line
-    insertHtml(QLatin1String("<hr><br>"));
+    logEntry += QLatin1String("<hr><br>");
 
-    textCursor().setBlockFormat(blockFmt);
+    return logEntry;
 }
 
 void LogPlainView::searchText(int options, const QString &pattern)
 {
+    // the whole log is searched
+    renderRevisions(m_model->rowCount());
+
     m_find = new KFind(pattern, options, this);
 
     connect(m_find, SIGNAL(highlight(QString, int, int)), this, SLOT(searchHighlight(QString, int, int)));
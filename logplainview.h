@@ -21,9 +21,11 @@
 
 #include <qtextbrowser.h>
 
+#include <QBitArray>
 #include <QTextBlock>
 
 class KFind;
+class LogModel;
 
 namespace Cervisia
 {
@@ -35,13 +37,21 @@ class LogPlainView : public QTextBrowser
     Q_OBJECT
 
 public:
-    explicit LogPlainView(QWidget *parent = nullptr);
+    /**
+     * The revisions of @p model are rendered once the view is shown, and
+     * only as far as they are scrolled into view.
+     */
+    explicit LogPlainView(LogModel *model, QWidget *parent = nullptr);
     ~LogPlainView() override;
 
-    void addRevision(const Cervisia::LogInfo &logInfo);
-
     void searchText(int options, const QString &pattern);
 
+    /**
+     * Shows only the revisions of @p matches, a bit for each revision in
+     * the order of the log. A null array shows all revisions.
+     */
+    void setMatches(const QBitArray &matches);
+
 Q_SIGNALS:
     void revisionClicked(QString rev, bool rmb);
 
@@ -51,13 +61,23 @@ public Q_SLOTS:
     void searchHighlight(const QString &text, int index, int length);
 
 protected:
+    void showEvent(QShowEvent *event) override;
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     void setSource(const QUrl &name) override;
 #else
     void doSetSource(const QUrl &name, QTextDocument::ResourceType type) override;
 #endif
 
+private Q_SLOTS:
+    void renderVisibleRevisions();
+
 private:
+    void renderRevisions(int count);
+    static QString revisionToHtml(const Cervisia::LogInfo &logInfo);
+
+    LogModel *m_model;
+    QBitArray m_matches;
+    int m_renderedCount; // rows of the model which were looked at
     KFind *m_find;
     QTextBlock m_currentBlock;
 };
@@ -20,50 +20,107 @@
 
 #include "logtree.h"
 
-#include <QApplication>
+#include <QContextMenuEvent>
+#include <QHash>
+#include <QMenu>
+#include <QScrollBar>
+#include <QTimer>
+#include <QWheelEvent>
 #include <kcolorscheme.h>
 #include <qpainter.h>
 
+#include <KLocalizedString>
+
+#include <algorithm>
+
 #include "loginfo.h"
 #include "tooltip.h"
 
-#include <QHeaderView>
-
 const int LogTreeView::BORDER = 5;
 const int LogTreeView::INSPACE = 3;
 
-namespace
-{
-bool static_initialized = false;
-int static_width;
-int static_height;
-}
+// delay (in ms) of the layout after revisions were added
+static const int LAYOUT_DELAY = 250;
+
+// range of the zoom factor and the factor of one zoom step
+static const qreal MIN_ZOOM = 0.02;
+static const qreal MAX_ZOOM = 1.0;
+static const qreal ZOOM_STEP = 1.25;
+
+// below this zoom factor the revisions are drawn without text
+static const qreal DETAIL_ZOOM = 0.5;
+
+// maximum size of the overview map and its distance to the border
+static const int MINIMAP_SIZE = 160;
+static const int MINIMAP_MARGIN = 8;
 
 class LogTreeItem
 {
 public:
     Cervisia::LogInfo m_logInfo;
-    QString branchpoint;
-    bool firstonbranch;
-    int row;
+    Cervisia::Revision branch; // e.g. 1.1.2 for 1.1.2.3, null on the trunk
+    Cervisia::Revision branchpoint; // e.g. 1.1 for 1.1.2.3
+    int row; // -1 if the item isn't shown
     int col;
     SelectedRevision selected;
+    bool matched; // by the filter of the dialog
+
+    // cached by computeSize()
+    QString revision;
+    QString tags;
+    QSize size; // of the box
+    int authorHeight;
+    int tagsHeight;
 };
 
-class LogTreeConnection
+namespace
 {
-public:
-    LogTreeItem *start;
-    LogTreeItem *end;
+bool static_initialized = false;
+int static_width;
+int static_height;
+
+struct LogTreeBranch {
+    LogTreeItem *branchpoint; // 0 for the trunk
+    LogTreeItemList items; // newest first, as in the log
+    QList<LogTreeBranch *> children; // in the order they appear in the log
+    int column;
 };
 
+bool lessCell(const LogTreeItem *item1, const LogTreeItem *item2)
+{
+    return item1->row < item2->row || (item1->row == item2->row && item1->col < item2->col);
+}
+
+bool lessColumn(const LogTreeItem *item, int col)
+{
+    return item->col < col;
+}
+
+bool lessEdge(const LogTreeEdge &edge1, const LogTreeEdge &edge2)
+{
+    return edge1.row < edge2.row;
+}
+}
+
 LogTreeView::LogTreeView(QWidget *parent, const char *name)
-    : QTableView(parent)
+    : QAbstractScrollArea(parent)
+    , firstCell(1, 0)
+    , firstEdge(1, 0)
+    , columnX(1, 0)
+    , rowY(1, 0)
     , rowCount(0)
-    , columnCount(1)
+    , columnCount(0)
+    , zoom(1.0)
+    , minimapVisible(false)
+    , minimapDragging(false)
 {
     setObjectName(QLatin1String(name));
 
+    layoutTimer = new QTimer(this);
+    layoutTimer->setSingleShot(true);
+    layoutTimer->setInterval(LAYOUT_DELAY);
+    connect(layoutTimer, SIGNAL(timeout()), this, SLOT(layoutRevisions()));
+
     if (!static_initialized) {
         static_initialized = true;
         QFontMetrics fm(fontMetrics());
@@ -71,162 +128,168 @@ LogTreeView::LogTreeView(QWidget *parent, const char *name)
         static_height = 2 * fm.height() + 2 * BORDER + 3 * INSPACE;
     }
 
-    setItemDelegate(new LogTreeDelegate(this));
-    setModel(model = new LogTreeModel(this));
-
-    setSelectionMode(QAbstractItemView::NoSelection);
-    setShowGrid(false);
-    horizontalHeader()->hide();
-    verticalHeader()->hide();
     setFrameStyle(QFrame::WinPanel | QFrame::Sunken);
-    setBackgroundRole(QPalette::Base);
+    viewport()->setBackgroundRole(QPalette::Base);
     setFocusPolicy(Qt::NoFocus);
-    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
 
     auto toolTip = new Cervisia::ToolTip(viewport());
 
     connect(toolTip, SIGNAL(queryToolTip(QPoint, QRect &, QString &)), this, SLOT(slotQueryToolTip(QPoint, QRect &, QString &)));
-
-    connect(this, SIGNAL(pressed(QModelIndex)), this, SLOT(mousePressed(QModelIndex)));
 }
 
 LogTreeView::~LogTreeView()
 {
     qDeleteAll(items);
-    qDeleteAll(connections);
 }
 
 void LogTreeView::addRevision(const Cervisia::LogInfo &logInfo)
 {
-    QString branchpoint, branchrev;
-
-    const QString rev(logInfo.m_revision);
+    auto item = new LogTreeItem;
+    item->m_logInfo = logInfo;
+    item->row = item->col = -1;
+    item->selected = NoRevision;
+    item->matched = matches.isNull();
 
     // find branch
-    int pos1, pos2;
-    if ((pos2 = rev.lastIndexOf('.')) > 0 && (pos1 = rev.lastIndexOf('.', pos2 - 1)) > 0) {
-        // e. g. for rev = 1.1.2.3 we have
-        // branchrev = 1.1.2, branchpoint = 1.1
-        branchrev = rev.left(pos2);
-        branchpoint = rev.left(pos1);
+    item->branch = logInfo.m_revision.branch();
+    item->branchpoint = logInfo.m_revision.branchpoint();
+
+    computeSize(item);
+    items.append(item);
+
+    // the layout depends on all revisions, so do it once for a bunch
+    if (!layoutTimer->isActive())
+        layoutTimer->start();
+}
+
+void LogTreeView::layoutRevisions()
+{
+    layoutTimer->stop();
+
+    // group the revisions by branch
+    QHash<Cervisia::Revision, LogTreeItem *> revisions;
+    QHash<Cervisia::Revision, LogTreeBranch *> branches;
+    QList<LogTreeBranch *> branchList; // in the order they appear in the log
+    LogTreeBranch trunk;
+    trunk.branchpoint = 0;
+
+    foreach (LogTreeItem *item, items) {
+        item->row = item->col = -1;
+        revisions.insert(item->m_logInfo.m_revision, item);
+
+        if (item->branch.isNull()) {
+            trunk.items.append(item);
+            continue;
+        }
+
+        LogTreeBranch *&branch = branches[item->branch];
+        if (!branch) {
+            branch = new LogTreeBranch;
+            branchList.append(branch);
+        }
+        branch->items.append(item);
     }
 
-    if (branchrev.isEmpty()) {
-        // Most probably we are on the trunk
-        model->beginInsertRows(QModelIndex(), rowCount, rowCount);
-        rowCount++;
-        auto item = new LogTreeItem;
-        item->m_logInfo = logInfo;
-        item->branchpoint = branchpoint;
-        item->firstonbranch = false;
-        item->row = rowCount - 1;
-        item->col = 0;
-        item->selected = NoRevision;
-        items.append(item);
-        model->endInsertRows();
-        return;
+    // attach each branch to the branch of its branchpoint, branches whose
+    // branchpoint isn't in the log can't be shown
+    foreach (LogTreeBranch *branch, branchList) {
+        LogTreeItem *branchItem = branch->items.first();
+        branch->branchpoint = revisions.value(branchItem->branchpoint);
+        if (!branch->branchpoint)
+            continue;
+
+        LogTreeBranch *parent = branch->branchpoint->branch.isNull() ? &trunk : branches.value(branch->branchpoint->branch);
+        if (parent)
+            parent->children.append(branch);
     }
 
-    // look whether we have revisions on this branch
-    // shift them up
-    int row = -1, col = -1;
-    foreach (LogTreeItem *item1, items) {
-        if (branchrev == (item1->m_logInfo.m_revision).left(branchrev.length())) {
-            item1->firstonbranch = false;
-            row = item1->row;
-            col = item1->col;
-            item1->row--;
-            // Are we at the top of the widget?
-            if (row == 0) {
-                foreach (LogTreeItem *item2, items)
-                    item2->row++;
-                model->beginInsertRows(QModelIndex(), rowCount, rowCount);
-                rowCount++;
-                row = 1;
-                model->endInsertRows();
-            }
-        }
+    // Each branch gets its own column. The columns are ordered depth first
+    // and the latest branch is next to its parent.
+    int column = 0;
+    QList<LogTreeBranch *> stack;
+    stack.append(&trunk);
+    while (!stack.isEmpty()) {
+        LogTreeBranch *branch = stack.takeLast();
+        branch->column = column++;
+        stack.append(branch->children);
     }
 
-    if (row == -1) {
-        // Ok, so we must open a new branch
-        // Let's find the branch point
-        QListIterator<LogTreeItem *> iter(items);
-        iter.toBack();
-        while (iter.hasPrevious()) {
-            LogTreeItem *item1(iter.previous());
-            if (branchpoint == item1->m_logInfo.m_revision) {
-                // Move existing branches to the right
-                foreach (LogTreeItem *item2, items)
-                    if (item2->col > item1->col)
-                        item2->col++;
-                model->beginInsertColumns(QModelIndex(), columnCount, columnCount);
-                columnCount++;
-                row = item1->row - 1;
-                col = item1->col + 1;
-                if (row == -1) {
-                    foreach (LogTreeItem *item3, items)
-                        item3->row++;
-                    model->beginInsertRows(QModelIndex(), rowCount, rowCount);
-                    rowCount++;
-                    row = 0;
-                    model->endInsertRows();
-                }
-                model->endInsertColumns();
-                break;
-            }
+    // The trunk goes down from the newest revision, the revisions of a
+    // branch are stacked above its branchpoint. Parents are placed before
+    // their children.
+    int minRow = 0, maxRow = -1;
+    QList<LogTreeBranch *> queue;
+    queue.append(&trunk);
+    for (int i = 0; i < queue.count(); ++i) {
+        LogTreeBranch *branch = queue.at(i);
+
+        const int count = branch->items.count();
+        const int firstRow = branch->branchpoint ? branch->branchpoint->row - count : 0;
+        for (int j = 0; j < count; ++j) {
+            LogTreeItem *item = branch->items.at(j);
+            item->row = firstRow + j;
+            item->col = branch->column;
         }
-    }
 
-    auto item = new LogTreeItem;
-    item->m_logInfo = logInfo;
-    item->branchpoint = branchpoint;
-    item->firstonbranch = true;
-    item->row = row;
-    item->col = col;
-    item->selected = NoRevision;
-    items.append(item);
+        minRow = qMin(minRow, firstRow);
+        maxRow = qMax(maxRow, firstRow + count - 1);
 
-#if 0
-    qCDebug(log_cervisia) << "Dump:";
-    qCDebug(log_cervisia) << "Rows:" << numRows() << "Cols:" << numCols();
-    foreach (LogTreeItem* treeItem, items)
-    {
-        qCDebug(log_cervisia) << "Rev:" << treeItem->m_logInfo.m_revision;
-        qCDebug(log_cervisia) << "row:" << treeItem->row << ", col:" << treeItem->col;
-        qCDebug(log_cervisia) << "fob:" << treeItem->firstonbranch;
+        queue.append(branch->children);
     }
-    qCDebug(log_cervisia) << "End Dump";
-#endif
-}
 
-void LogTreeView::collectConnections()
-{
-    for (LogTreeItemList::const_iterator it(items.begin()), itEnd(items.end()); it != itEnd; ++it) {
-        QString rev = (*it)->m_logInfo.m_revision;
+    rowCount = maxRow - minRow + 1;
+    columnCount = column;
 
-        LogTreeItemList::const_iterator it2(it);
-        ++it2;
-        for (; it2 != itEnd; ++it2)
-            if ((*it2)->branchpoint == rev && (*it2)->firstonbranch) {
-                auto conn = new LogTreeConnection;
-                conn->start = (*it);
-                conn->end = (*it2);
-                connections.append(conn);
-            }
+    cells.clear();
+    foreach (LogTreeItem *item, items) {
+        if (item->col < 0)
+            continue;
+        item->row -= minRow;
+        cells.append(item);
+    }
+    std::sort(cells.begin(), cells.end(), lessCell);
+
+    // connect the revisions on each branch and the branchpoint with the
+    // oldest revision of the branch
+    edges.clear();
+    foreach (const LogTreeBranch *branch, queue) {
+        for (int j = 1; j < branch->items.count(); ++j) {
+            const LogTreeItem *item = branch->items.at(j);
+            edges.append(LogTreeEdge{item->row, item->col, item->col});
+        }
+        if (branch->branchpoint)
+            edges.append(LogTreeEdge{branch->branchpoint->row, branch->branchpoint->col, branch->column});
+    }
+    std::sort(edges.begin(), edges.end(), lessEdge);
+
+    firstCell.fill(0, rowCount + 1);
+    foreach (const LogTreeItem *item, cells)
+        ++firstCell[item->row + 1];
+    firstEdge.fill(0, rowCount + 1);
+    foreach (const LogTreeEdge &edge, edges)
+        ++firstEdge[edge.row + 1];
+    for (int row = 0; row < rowCount; ++row) {
+        firstCell[row + 1] += firstCell[row];
+        firstEdge[row + 1] += firstEdge[row];
     }
+
+    qDeleteAll(branchList);
+
+    recomputeCellSizes();
 }
 
 void LogTreeView::setSelectedPair(QString selectionA, QString selectionB)
 {
+    const Cervisia::Revision revisionA(selectionA);
+    const Cervisia::Revision revisionB(selectionB);
+
     foreach (LogTreeItem *item, items) {
         const SelectedRevision oldSelection = item->selected;
         SelectedRevision newSelection;
 
-        if (selectionA == item->m_logInfo.m_revision)
+        if (!revisionA.isNull() && revisionA == item->m_logInfo.m_revision)
             newSelection = RevisionA;
-        else if (selectionB == item->m_logInfo.m_revision)
+        else if (!revisionB.isNull() && revisionB == item->m_logInfo.m_revision)
             newSelection = RevisionB;
         else
             newSelection = NoRevision;
@@ -238,127 +301,290 @@ void LogTreeView::setSelectedPair(QString selectionA, QString selectionB)
     }
 }
 
+void LogTreeView::setMatches(const QBitArray &newMatches)
+{
+    matches = newMatches;
+
+    // revisions which are added later aren't filtered yet
+    for (int i = 0; i < items.count(); ++i)
+        items.at(i)->matched = matches.isNull() || i >= matches.size() || matches.testBit(i);
+
+    minimap = QPixmap();
+    viewport()->update();
+}
+
 QSize LogTreeView::sizeHint() const
 {
     return {2 * static_width, 3 * static_height};
 }
 
-QString LogTreeView::text(int row, int col) const
+LogTreeItem *LogTreeView::itemAt(int row, int col) const
 {
-    LogTreeItem *item = 0;
+    if (row < 0 || row >= rowCount)
+        return 0;
 
-    foreach (LogTreeItem *treeItem, items) {
-        if (treeItem->col == col && treeItem->row == row) {
-            item = treeItem;
-            break;
-        }
-    }
+    const auto end = cells.constBegin() + firstCell.at(row + 1);
+    const auto it = std::lower_bound(cells.constBegin() + firstCell.at(row), end, col, lessColumn);
 
-    QString text;
+    return (it != end && (*it)->col == col) ? *it : 0;
+}
 
-    if (item && !item->m_logInfo.m_author.isNull())
-        text = item->m_logInfo.createToolTipText();
+int LogTreeView::rowAt(qreal y) const
+{
+    if (y < 0 || y >= rowY.last())
+        return -1;
 
-    return text;
+    return std::upper_bound(rowY.constBegin(), rowY.constEnd(), int(y)) - rowY.constBegin() - 1;
 }
 
-void LogTreeView::paintCell(QPainter *p, int row, int col)
+int LogTreeView::columnAt(qreal x) const
 {
-    bool followed, branched;
-    LogTreeItem *item;
+    if (x < 0 || x >= columnX.last())
+        return -1;
 
-    branched = false;
-    followed = false;
-    item = 0;
+    return std::upper_bound(columnX.constBegin(), columnX.constEnd(), int(x)) - columnX.constBegin() - 1;
+}
 
-    foreach (LogTreeItem *treeItem, items) {
-        int itcol = treeItem->col;
-        int itrow = treeItem->row;
-        if (itrow == row - 1 && itcol == col)
-            followed = true;
-        if (itrow == row && itcol == col)
-            item = treeItem;
-    }
-    foreach (LogTreeConnection *connection, connections) {
-        int itcol1 = connection->start->col;
-        int itcol2 = connection->end->col;
-        int itrow = connection->start->row;
-        if (itrow == row && itcol1 <= col && itcol2 > col)
-            branched = true;
-    }
+QRect LogTreeView::cellRect(int row, int col) const
+{
+    return QRect(columnX.at(col), rowY.at(row), columnX.at(col + 1) - columnX.at(col), rowY.at(row + 1) - rowY.at(row));
+}
+
+QRect LogTreeView::boxRect(const LogTreeItem *item) const
+{
+    const QRect cell(cellRect(item->row, item->col));
+
+    return QRect(QPoint(cell.x() + (cell.width() - item->size.width()) / 2, cell.y() + (cell.height() - item->size.height()) / 2), item->size);
+}
 
-    if (item)
-        paintRevisionCell(p, row, col, item->m_logInfo, followed, branched, item->selected);
-    else if (followed || branched)
-        paintConnector(p, row, col, followed, branched);
+QPointF LogTreeView::contentsPos(const QPoint &viewportPos) const
+{
+    return QPointF(viewportPos.x() + horizontalScrollBar()->value(), viewportPos.y() + verticalScrollBar()->value()) / zoom;
 }
 
-void LogTreeView::paintConnector(QPainter *p, int row, int col, bool followed, bool branched)
+QString LogTreeView::text(int row, int col) const
 {
-    const int midx = columnWidth(col) / 2;
-    const int midy = rowHeight(row) / 2;
+    const LogTreeItem *item = itemAt(row, col);
+
+    QString text;
+
+    if (item && !item->m_logInfo.m_author.isNull())
+        text = item->m_logInfo.createToolTipText();
 
-    p->drawLine(0, midy, branched ? columnWidth(col) : midx, midy);
-    if (followed)
-        p->drawLine(midx, midy, midx, 0);
+    return text;
 }
 
-QSize LogTreeView::computeSize(const Cervisia::LogInfo &logInfo, int *authorHeight, int *tagsHeight) const
+void LogTreeView::computeSize(LogTreeItem *item) const
 {
     const QFontMetrics fm(fontMetrics());
+    const Cervisia::LogInfo &logInfo(item->m_logInfo);
 
-    const QString tags(logInfo.tagsToString(Cervisia::TagInfo::Branch | Cervisia::TagInfo::Tag, Cervisia::TagInfo::Branch));
+    item->revision = logInfo.m_revision.toString();
+    item->tags = logInfo.tagsToString(Cervisia::TagInfo::Branch | Cervisia::TagInfo::Tag, Cervisia::TagInfo::Branch);
 
-    const QSize r1 = fm.size(Qt::AlignCenter, logInfo.m_revision);
+    const QSize r1 = fm.size(Qt::AlignCenter, item->revision);
     const QSize r3 = fm.size(Qt::AlignCenter, logInfo.m_author);
 
-    if (authorHeight)
-        *authorHeight = r3.height();
+    item->authorHeight = r3.height();
 
     int infoWidth = qMax(static_width - 2 * BORDER, qMax(r1.width(), r3.width()));
     int infoHeight = r1.height() + r3.height() + 3 * INSPACE;
 
-    if (!tags.isEmpty()) {
-        const QSize r2 = fm.size(Qt::AlignCenter, tags);
+    if (!item->tags.isEmpty()) {
+        const QSize r2 = fm.size(Qt::AlignCenter, item->tags);
         infoWidth = qMax(infoWidth, r2.width());
         infoHeight += r2.height() + INSPACE;
-        if (tagsHeight)
-            *tagsHeight = r2.height();
+        item->tagsHeight = r2.height();
     } else {
-        if (tagsHeight)
-            *tagsHeight = 0;
+        item->tagsHeight = 0;
     }
     infoWidth += 2 * INSPACE;
 
-    return {infoWidth, infoHeight};
+    item->size = QSize(infoWidth, infoHeight);
 }
 
-void LogTreeView::paintRevisionCell(QPainter *p, int row, int col, const Cervisia::LogInfo &logInfo, bool followed, bool branched, SelectedRevision selected)
+void LogTreeView::recomputeCellSizes()
 {
-    int authorHeight;
-    int tagsHeight;
-    const QSize infoSize(computeSize(logInfo, &authorHeight, &tagsHeight));
-    const QSize cellSize(columnWidth(col), rowHeight(row));
+    // Compute maximum for each column and row
+    QVector<int> widths(columnCount, static_width);
+    QVector<int> heights(rowCount, static_height);
+
+    foreach (const LogTreeItem *item, cells) {
+        widths[item->col] = qMax(widths.at(item->col), item->size.width() + 2 * BORDER);
+        heights[item->row] = qMax(heights.at(item->row), item->size.height() + 2 * BORDER);
+    }
+
+    columnX.resize(columnCount + 1);
+    for (int col = 0; col < columnCount; ++col)
+        columnX[col + 1] = columnX.at(col) + widths.at(col);
+
+    rowY.resize(rowCount + 1);
+    for (int row = 0; row < rowCount; ++row)
+        rowY[row + 1] = rowY.at(row) + heights.at(row);
+
+    minimap = QPixmap();
+
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogTreeView::updateScrollBars()
+{
+    const QSize size(viewport()->size());
+    const int width = qRound(columnX.last() * zoom);
+    const int height = qRound(rowY.last() * zoom);
+
+    horizontalScrollBar()->setRange(0, qMax(0, width - size.width()));
+    horizontalScrollBar()->setPageStep(size.width());
+    horizontalScrollBar()->setSingleStep(qMax(1, qRound(static_width * zoom / 4)));
+
+    verticalScrollBar()->setRange(0, qMax(0, height - size.height()));
+    verticalScrollBar()->setPageStep(size.height());
+    verticalScrollBar()->setSingleStep(qMax(1, qRound(static_height * zoom / 4)));
+}
+
+void LogTreeView::setZoom(qreal newZoom, const QPoint &anchor)
+{
+    newZoom = qBound(MIN_ZOOM, newZoom, MAX_ZOOM);
+    if (qFuzzyCompare(newZoom, zoom))
+        return;
+
+    // keep the point under the anchor where it is
+    const QPointF pos(contentsPos(anchor));
+
+    zoom = newZoom;
+    updateScrollBars();
+
+    horizontalScrollBar()->setValue(qRound(pos.x() * zoom - anchor.x()));
+    verticalScrollBar()->setValue(qRound(pos.y() * zoom - anchor.y()));
+
+    viewport()->update();
+}
+
+void LogTreeView::zoomIn()
+{
+    setZoom(zoom * ZOOM_STEP, viewport()->rect().center());
+}
+
+void LogTreeView::zoomOut()
+{
+    setZoom(zoom / ZOOM_STEP, viewport()->rect().center());
+}
+
+void LogTreeView::resetZoom()
+{
+    setZoom(1.0, viewport()->rect().center());
+}
+
+void LogTreeView::zoomToFit()
+{
+    if (cells.isEmpty())
+        return;
+
+    const qreal fit = qMin(viewport()->width() / qreal(columnX.last()), viewport()->height() / qreal(rowY.last()));
+    setZoom(qMin(fit, qreal(1.0)), QPoint());
+}
+
+void LogTreeView::setMinimapVisible(bool visible)
+{
+    minimapVisible = visible;
+    viewport()->update();
+}
+
+void LogTreeView::collectLines(int firstRow, int lastRow, int firstCol, int lastCol, QVector<QLine> *lines) const
+{
+    // the edges of the row below end in the last row
+    const int lastEdgeRow = qMin(lastRow + 1, rowCount - 1);
+
+    for (int i = firstEdge.at(firstRow); i < firstEdge.at(lastEdgeRow + 1); ++i) {
+        const LogTreeEdge &edge = edges.at(i);
+        if (qMax(edge.col1, edge.col2) < firstCol || qMin(edge.col1, edge.col2) > lastCol)
+            continue;
+
+        const QPoint start(cellRect(edge.row, edge.col1).center());
+        const QPoint corner(cellRect(edge.row, edge.col2).center());
+        const QPoint end(cellRect(edge.row - 1, edge.col2).center());
+
+        if (edge.col1 != edge.col2)
+            lines->append(QLine(start, corner));
+        lines->append(QLine(corner, end));
+    }
+}
+
+void LogTreeView::paintEvent(QPaintEvent *event)
+{
+    QPainter p(viewport());
+
+    if (cells.isEmpty())
+        return;
+
+    // the part of the graph which needs to be painted
+    const QRect exposed(event->rect());
+    const QRectF area(contentsPos(exposed.topLeft()), QSizeF(exposed.size()) / zoom);
+    const int firstRow = rowAt(qBound(qreal(0), area.top(), qreal(rowY.last() - 1)));
+    const int lastRow = rowAt(qBound(qreal(0), area.bottom(), qreal(rowY.last() - 1)));
+    const int firstCol = columnAt(qBound(qreal(0), area.left(), qreal(columnX.last() - 1)));
+    const int lastCol = columnAt(qBound(qreal(0), area.right(), qreal(columnX.last() - 1)));
+
+    p.save();
+    p.translate(-horizontalScrollBar()->value(), -verticalScrollBar()->value());
+    p.scale(zoom, zoom);
+
+    // the connections first, the boxes are painted over them
+    QVector<QLine> lines;
+    collectLines(firstRow, lastRow, firstCol, lastCol, &lines);
+    p.drawLines(lines);
+
+    const bool detailed = zoom >= DETAIL_ZOOM;
+    const KColorScheme scheme(QPalette::Active, KColorScheme::Selection);
+
+    QVector<QRect> boxes, dimmedBoxes;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const auto end = cells.constBegin() + firstCell.at(row + 1);
+        for (auto it = std::lower_bound(cells.constBegin() + firstCell.at(row), end, firstCol, lessColumn); it != end && (*it)->col <= lastCol; ++it) {
+            const LogTreeItem *item = *it;
+            if (detailed)
+                paintRevision(&p, item);
+            else if (item->selected == RevisionA)
+                p.fillRect(boxRect(item), scheme.background());
+            else if (item->selected == RevisionB)
+                p.fillRect(boxRect(item), scheme.background().color().lighter(130));
+            else if (item->matched)
+                boxes.append(boxRect(item));
+            else
+                dimmedBoxes.append(boxRect(item));
+        }
+    }
 
-    const int midx(cellSize.width() / 2);
-    const int midy(cellSize.height() / 2);
+    p.setBrush(palette().base());
+    if (!boxes.isEmpty())
+        p.drawRects(boxes);
+    if (!dimmedBoxes.isEmpty()) {
+        p.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+        p.drawRects(dimmedBoxes);
+    }
 
-    QRect rect(QPoint((cellSize.width() - infoSize.width()) / 2, (cellSize.height() - infoSize.height()) / 2), infoSize);
+    p.restore();
 
-    // Connectors
-    if (followed)
-        p->drawLine(midx, 0, midx, rect.y()); // to the top
+    if (minimapVisible)
+        paintMinimap(&p);
+}
 
-    if (branched)
-        p->drawLine(rect.x() + infoSize.width(), midy, cellSize.width(), midy); // to the right
+void LogTreeView::paintRevision(QPainter *p, const LogTreeItem *item) const
+{
+    QRect rect(boxRect(item));
 
-    p->drawLine(midx, rect.y() + infoSize.height(), midx, cellSize.height()); // to the bottom
+    p->save();
 
-    // The box itself
-    if (selected == NoRevision) {
+    if (!item->matched)
+        p->setPen(palette().color(QPalette::Disabled, QPalette::Text));
+
+    // The box itself, it hides the connections
+    if (item->selected == NoRevision) {
+        p->setBrush(palette().base());
         p->drawRoundedRect(rect, 10, 10);
     } else {
-        if (selected == RevisionA) {
+        if (item->selected == RevisionA) {
             p->fillRect(rect, KColorScheme(QPalette::Active, KColorScheme::Selection).background());
             p->setPen(KColorScheme(QPalette::Active, KColorScheme::Selection).foreground().color());
             p->drawText(rect, Qt::AlignLeft | Qt::AlignTop, "A");
@@ -371,81 +597,203 @@ void LogTreeView::paintRevisionCell(QPainter *p, int row, int col, const Cervisi
 
     rect.setY(rect.y() + INSPACE);
 
-    p->drawText(rect, Qt::AlignHCenter, logInfo.m_author);
-    rect.setY(rect.y() + authorHeight + INSPACE);
+    p->drawText(rect, Qt::AlignHCenter, item->m_logInfo.m_author);
+    rect.setY(rect.y() + item->authorHeight + INSPACE);
 
-    const QString tags(logInfo.tagsToString(Cervisia::TagInfo::Branch | Cervisia::TagInfo::Tag, Cervisia::TagInfo::Branch));
-    if (!tags.isEmpty()) {
+    if (!item->tags.isEmpty()) {
         const QFont font(p->font());
         QFont underline(font);
         underline.setUnderline(true);
 
         p->setFont(underline);
-        p->drawText(rect, Qt::AlignHCenter, tags);
+        p->drawText(rect, Qt::AlignHCenter, item->tags);
         p->setFont(font);
 
-        rect.setY(rect.y() + tagsHeight + INSPACE);
+        rect.setY(rect.y() + item->tagsHeight + INSPACE);
     }
 
-    p->drawText(rect, Qt::AlignHCenter, logInfo.m_revision);
+    p->drawText(rect, Qt::AlignHCenter, item->revision);
+
+    p->restore();
 }
 
-void LogTreeView::mousePressed(const QModelIndex &index)
+QRect LogTreeView::minimapRect() const
 {
-    Qt::MouseButtons buttons = QApplication::mouseButtons();
+    const QSize contents(columnX.last(), rowY.last());
+    if (contents.isEmpty())
+        return QRect();
 
-    if (buttons == Qt::MiddleButton || buttons == Qt::LeftButton) {
-        int row = index.row();
-        int col = index.column();
+    // very narrow or flat graphs are stretched a little
+    const QSize size(contents.scaled(MINIMAP_SIZE, MINIMAP_SIZE, Qt::KeepAspectRatio).expandedTo(QSize(MINIMAP_SIZE / 4, MINIMAP_SIZE / 4)));
 
-        foreach (LogTreeItem *item, items) {
-            if (item->row == row && item->col == col) {
-                // Change selection for revision B if the middle mouse button or
-                // the left mouse button with the control key was pressed
-                bool changeRevB = (buttons == Qt::MiddleButton) || (buttons == Qt::LeftButton && QApplication::keyboardModifiers() & Qt::ControlModifier);
+    return QRect(QPoint(viewport()->width() - size.width() - MINIMAP_MARGIN, viewport()->height() - size.height() - MINIMAP_MARGIN), size);
+}
 
-                Q_EMIT revisionClicked(item->m_logInfo.m_revision, changeRevB);
-                viewport()->update();
-                break;
-            }
-        }
+void LogTreeView::paintMinimap(QPainter *p)
+{
+    const QRect rect(minimapRect());
+    if (rect.isEmpty())
+        return;
+
+    const qreal scaleX = rect.width() / qreal(columnX.last());
+    const qreal scaleY = rect.height() / qreal(rowY.last());
+
+    // the whole graph is only drawn again after a layout
+    if (minimap.size() != rect.size()) {
+        minimap = QPixmap(rect.size());
+        minimap.fill(palette().color(QPalette::AlternateBase));
+
+        QPainter mp(&minimap);
+        mp.setPen(palette().color(QPalette::Mid));
+        mp.drawRect(0, 0, rect.width() - 1, rect.height() - 1);
+        mp.scale(scaleX, scaleY);
+
+        QVector<QLine> lines;
+        collectLines(0, rowCount - 1, 0, columnCount - 1, &lines);
+        mp.setPen(QPen(palette().color(QPalette::Text), 0));
+        mp.drawLines(lines);
+
+        QVector<QRect> boxes;
+        QVector<QRect> dimmedBoxes;
+        boxes.reserve(cells.count());
+        foreach (const LogTreeItem *item, cells)
+            (item->matched ? boxes : dimmedBoxes).append(boxRect(item));
+        mp.setBrush(palette().text());
+        mp.drawRects(boxes);
+        mp.setPen(QPen(palette().color(QPalette::Disabled, QPalette::Text), 0));
+        mp.setBrush(palette().brush(QPalette::Disabled, QPalette::Text));
+        mp.drawRects(dimmedBoxes);
     }
+
+    p->drawPixmap(rect.topLeft(), minimap);
+
+    // the visible part of the graph
+    const QPointF pos(contentsPos(QPoint()));
+    const QRectF visible(rect.x() + pos.x() * scaleX, rect.y() + pos.y() * scaleY, viewport()->width() / zoom * scaleX, viewport()->height() / zoom * scaleY);
+
+    p->setPen(palette().color(QPalette::Highlight));
+    p->setBrush(Qt::NoBrush);
+    p->drawRect(visible.intersected(QRectF(rect).adjusted(0, 0, -1, -1)));
 }
 
-void LogTreeView::recomputeCellSizes()
+void LogTreeView::scrollToMinimapPos(const QPoint &pos)
 {
-    // Compute maximum for each column and row
-    foreach (const LogTreeItem *item, items) {
-        const QSize cellSize(computeSize(item->m_logInfo) + QSize(2 * BORDER, 2 * BORDER));
+    const QRect rect(minimapRect());
+    if (rect.isEmpty())
+        return;
+
+    // center the view at the position
+    const qreal x = (pos.x() - rect.x()) * columnX.last() / qreal(rect.width());
+    const qreal y = (pos.y() - rect.y()) * rowY.last() / qreal(rect.height());
+
+    horizontalScrollBar()->setValue(qRound(x * zoom - viewport()->width() / 2));
+    verticalScrollBar()->setValue(qRound(y * zoom - viewport()->height() / 2));
+}
+
+void LogTreeView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+
+    updateScrollBars();
+}
+
+void LogTreeView::changeEvent(QEvent *event)
+{
+    QAbstractScrollArea::changeEvent(event);
+
+    if (event->type() == QEvent::FontChange) {
+        foreach (LogTreeItem *item, items)
+            computeSize(item);
+        recomputeCellSizes();
+    } else if (event->type() == QEvent::PaletteChange) {
+        minimap = QPixmap();
+    }
+}
 
-        setColumnWidth(item->col, qMax(columnWidth(item->col), cellSize.width()));
-        setRowHeight(item->row, qMax(rowHeight(item->row), cellSize.height()));
+void LogTreeView::mousePressEvent(QMouseEvent *event)
+{
+    if (minimapVisible && event->button() == Qt::LeftButton && minimapRect().contains(event->pos())) {
+        minimapDragging = true;
+        scrollToMinimapPos(event->pos());
+        return;
     }
 
-    viewport()->update();
+    if (event->button() == Qt::MiddleButton || event->button() == Qt::LeftButton) {
+        const QPointF pos(contentsPos(event->pos()));
+
+        if (const LogTreeItem *item = itemAt(rowAt(pos.y()), columnAt(pos.x()))) {
+            // Change selection for revision B if the middle mouse button or
+            // the left mouse button with the control key was pressed
+            bool changeRevB = (event->button() == Qt::MiddleButton) || (event->modifiers() & Qt::ControlModifier);
+
+            Q_EMIT revisionClicked(item->revision, changeRevB);
+            viewport()->update();
+        }
+    }
 }
 
-void LogTreeView::slotQueryToolTip(const QPoint &viewportPos, QRect &viewportRect, QString &tipText)
+void LogTreeView::mouseMoveEvent(QMouseEvent *event)
 {
-    QModelIndex index(indexAt(viewportPos));
+    if (minimapDragging)
+        scrollToMinimapPos(event->pos());
+}
 
-    tipText = text(index.row(), index.column());
-    if (tipText.isEmpty())
+void LogTreeView::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event)
+
+    minimapDragging = false;
+}
+
+void LogTreeView::wheelEvent(QWheelEvent *event)
+{
+    if (event->modifiers() & Qt::ControlModifier) {
+        const int delta = event->angleDelta().y();
+        if (delta != 0)
+            setZoom(delta > 0 ? zoom * ZOOM_STEP : zoom / ZOOM_STEP, event->position().toPoint());
+        event->accept();
         return;
+    }
 
-    viewportRect = visualRect(index);
+    QAbstractScrollArea::wheelEvent(event);
 }
 
-//---------------------------------------------------------------------
+void LogTreeView::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu;
+
+    QAction *action = menu.addAction(QIcon::fromTheme("zoom-in"), i18n("Zoom In"), this, SLOT(zoomIn()));
+    action->setEnabled(zoom < MAX_ZOOM);
+    action = menu.addAction(QIcon::fromTheme("zoom-out"), i18n("Zoom Out"), this, SLOT(zoomOut()));
+    action->setEnabled(zoom > MIN_ZOOM);
+    menu.addAction(QIcon::fromTheme("zoom-original"), i18n("Actual Size"), this, SLOT(resetZoom()));
+    menu.addAction(QIcon::fromTheme("zoom-fit-best"), i18n("Zoom to Fit"), this, SLOT(zoomToFit()));
+    menu.addSeparator();
+
+    action = menu.addAction(i18n("Show Overview Map"));
+    action->setCheckable(true);
+    action->setChecked(minimapVisible);
+    connect(action, SIGNAL(toggled(bool)), this, SLOT(setMinimapVisible(bool)));
+
+    menu.exec(event->globalPos());
+}
 
-void LogTreeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+void LogTreeView::slotQueryToolTip(const QPoint &viewportPos, QRect &viewportRect, QString &tipText)
 {
-    painter->save();
+    if (minimapVisible && minimapRect().contains(viewportPos))
+        return;
 
-    painter->translate(option.rect.x(), option.rect.y());
-    logView->paintCell(painter, index.row(), index.column());
+    const QPointF pos(contentsPos(viewportPos));
+    const int row = rowAt(pos.y());
+    const int col = columnAt(pos.x());
+
+    tipText = text(row, col);
+    if (tipText.isEmpty())
+        return;
 
-    painter->restore();
+    const QRect cell(cellRect(row, col));
+    viewportRect = QRectF(cell.x() * zoom - horizontalScrollBar()->value(), cell.y() * zoom - verticalScrollBar()->value(), cell.width() * zoom, cell.height() * zoom)
+                       .toAlignedRect();
 }
 
 // Local Variables:
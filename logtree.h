@@ -21,14 +21,16 @@
 #ifndef LOGTREE_H
 #define LOGTREE_H
 
+#include <qbitarray.h>
 #include <qlist.h>
+#include <qpixmap.h>
+#include <qvector.h>
 
-#include <QAbstractTableModel>
-#include <QStyledItemDelegate>
-#include <QTableView>
+#include <QAbstractScrollArea>
 
+class QLine;
+class QTimer;
 class LogTreeItem;
-class LogTreeConnection;
 
 namespace Cervisia
 {
@@ -36,11 +38,27 @@ struct LogInfo;
 }
 
 using LogTreeItemList = QList<LogTreeItem *>;
-using LogTreeConnectionList = QList<LogTreeConnection *>;
 
 enum SelectedRevision { NoRevision, RevisionA, RevisionB };
 
-class LogTreeView : public QTableView
+/**
+ * A line from the revision in (row, col1) over to col2 and up to the
+ * revision in the row above. Without the horizontal part (col1 == col2) it
+ * joins two revisions on a branch, otherwise a branchpoint and its branch.
+ */
+struct LogTreeEdge {
+    int row;
+    int col1;
+    int col2;
+};
+
+/**
+ * Shows the revisions of a file as a graph, the trunk in the first column
+ * and each branch in a column of its own. Only the visible part of the graph
+ * is painted. When zoomed out the revisions are drawn as plain boxes, and an
+ * overview map of the whole graph can be shown in the corner.
+ */
+class LogTreeView : public QAbstractScrollArea
 {
     Q_OBJECT
 
@@ -49,11 +67,18 @@ public:
 
     ~LogTreeView() override;
 
+    /**
+     * Adds a revision in the order of the log. The graph is laid out
+     * shortly afterwards, or immediately with layoutRevisions().
+     */
     void addRevision(const Cervisia::LogInfo &logInfo);
     void setSelectedPair(QString selectionA, QString selectionB);
-    void collectConnections();
-    void recomputeCellSizes();
-    void paintCell(QPainter *p, int row, int col);
+
+    /**
+     * Dims the revisions which aren't in @p matches, a bit for each
+     * revision in the order of the log. A null array dims none.
+     */
+    void setMatches(const QBitArray &matches);
 
     QSize sizeHint() const override;
 
@@ -62,71 +87,73 @@ public:
 Q_SIGNALS:
     void revisionClicked(QString rev, bool rmb);
 
+public Q_SLOTS:
+    /**
+     * Assigns the rows and columns to all revisions and collects the
+     * connections between them.
+     */
+    void layoutRevisions();
+
+    void zoomIn();
+    void zoomOut();
+    void resetZoom();
+    /**
+     * Zooms out until the whole graph fits into the view.
+     */
+    void zoomToFit();
+    void setMinimapVisible(bool visible);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
 private Q_SLOTS:
-    void mousePressed(const QModelIndex &index);
     void slotQueryToolTip(const QPoint &, QRect &, QString &);
 
 private:
-    QSize computeSize(const Cervisia::LogInfo &, int * = 0, int * = 0) const;
-    void paintRevisionCell(QPainter *p, int row, int col, const Cervisia::LogInfo &logInfo, bool followed, bool branched, SelectedRevision selected);
-    void paintConnector(QPainter *p, int row, int col, bool followed, bool branched);
-
-    LogTreeItemList items;
-    LogTreeConnectionList connections;
+    LogTreeItem *itemAt(int row, int col) const;
+    int rowAt(qreal y) const;
+    int columnAt(qreal x) const;
+    QRect cellRect(int row, int col) const;
+    QRect boxRect(const LogTreeItem *item) const;
+    QPointF contentsPos(const QPoint &viewportPos) const;
+
+    void computeSize(LogTreeItem *item) const;
+    void recomputeCellSizes();
+    void updateScrollBars();
+    void setZoom(qreal newZoom, const QPoint &anchor);
+
+    void collectLines(int firstRow, int lastRow, int firstCol, int lastCol, QVector<QLine> *lines) const;
+    void paintRevision(QPainter *p, const LogTreeItem *item) const;
+
+    QRect minimapRect() const;
+    void paintMinimap(QPainter *p);
+    void scrollToMinimapPos(const QPoint &pos);
+
+    LogTreeItemList items; // in the order of the log
+    QVector<LogTreeItem *> cells; // the placed items ordered by row and column
+    QVector<int> firstCell; // index into cells for each row, and the count
+    QVector<LogTreeEdge> edges; // ordered by row
+    QVector<int> firstEdge; // index into edges for each row, and the count
+    QVector<int> columnX; // offset of each column, and the total width
+    QVector<int> rowY; // offset of each row, and the total height
+    QBitArray matches; // null if all revisions match
+    QTimer *layoutTimer;
     int rowCount, columnCount;
 
+    qreal zoom;
+    bool minimapVisible;
+    bool minimapDragging;
+    QPixmap minimap; // cached, null when outdated
+
     static const int BORDER;
     static const int INSPACE;
-
-    friend class LogTreeModel;
-
-    class LogTreeModel *model;
-};
-
-class LogTreeModel : public QAbstractTableModel
-{
-public:
-    explicit LogTreeModel(LogTreeView *t)
-        : logView(t)
-    {
-    }
-
-    int rowCount(const QModelIndex &parent = QModelIndex()) const override
-    {
-        Q_UNUSED(parent)
-        return logView->rowCount;
-    }
-
-    int columnCount(const QModelIndex &parent = QModelIndex()) const override
-    {
-        Q_UNUSED(parent)
-        return logView->columnCount;
-    }
-
-    QVariant data(const QModelIndex &, int) const override
-    {
-        return {};
-    }
-
-private:
-    LogTreeView *logView;
-
-    friend class LogTreeView;
-};
-
-class LogTreeDelegate : public QStyledItemDelegate
-{
-    Q_OBJECT
-
-public:
-    explicit LogTreeDelegate(LogTreeView *t)
-        : logView(t)
-    {
-    }
-    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
-
-private:
-    LogTreeView *logView;
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include "debug.h"
 
 #include <KLocalizedString>
+#include <QDBusConnection>
 #include <QTemporaryFile>
 #include <cctype>
 #include <kemailsettings.h>
@@ -31,12 +32,16 @@
 #include <qfile.h>
 #include <qfileinfo.h>
 #include <qregexp.h>
+#include <qset.h>
 #include <qstringlist.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "cvsservice/cvsrecords.h"
 #include "cvsserviceinterface.h"
 #include "progressdialog.h"
+#include "revision.h"
+#include "tagcatalog.h"
 
 // These regular expression parts aren't useful to check the validity of the
 // CVSROOT specification. They are just used to extract the different parts of it.
@@ -46,57 +51,42 @@ static const QString hostNameRegExp("([^:/@]+)");
 static const QString portRegExp("(:(\\d*))?");
 static const QString pathRegExp("(/.*)");
 
-static int FindWhiteSpace(const QString &str, int index)
+static const QStringList FetchBranchesAndTags(const QString &searchedType, OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, QWidget *parent)
 {
-    const int length = str.length();
-
-    if (index < 0)
-        index += length;
-
-    if (index < 0 || index >= length)
-        return -1;
-
-    const QChar *const startPos = str.unicode();
-    const QChar *const endPos = startPos + length;
+    QStringList branchOrTagList;
 
-    const QChar *pos = startPos + index;
-    while (pos < endPos && !pos->isSpace())
-        ++pos;
+    const bool searchBranches = searchedType == QLatin1String("branch");
 
-    const int foundIndex = pos - startPos;
-    return (foundIndex < length ? foundIndex : -1);
-}
+    // the catalog answers from its cache and refreshes it in the background
+    if (TagCatalog *catalog = TagCatalog::forWorkingCopy(cvsService)) {
+        if (catalog->isValid())
+            catalog->refresh();
+        else if (!catalog->update(parent))
+            return branchOrTagList;
 
-static const QStringList FetchBranchesAndTags(const QString &searchedType, OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, QWidget *parent)
-{
-    QStringList branchOrTagList;
+        return searchBranches ? catalog->branches() : catalog->tags();
+    }
 
+    // without the module the status of each file is needed
     QDBusReply<QDBusObjectPath> job = cvsService->status(QStringList(), true, true);
     if (!job.isValid())
         return branchOrTagList;
 
     ProgressDialog dlg(parent, "Status", cvsService->service(), job, QString(), i18n("CVS Status"));
+    dlg.setRecordsOnly(true);
 
     if (dlg.execute()) {
-        QString line;
-        while (dlg.getLine(line)) {
-            int wsPos, bracketPos, colonPos;
-
-            if (line.isEmpty() || line[0] != '\t')
-                continue;
-            if ((wsPos = FindWhiteSpace(line, 2)) < 0)
-                continue;
-            if ((bracketPos = line.indexOf('(', wsPos + 1)) < 0)
-                continue;
-            if ((colonPos = line.indexOf(':', bracketPos + 1)) < 0)
-                continue;
-
-            const QString tag = line.mid(1, wsPos - 1);
-            const QString type = line.mid(bracketPos + 1, colonPos - bracketPos - 1);
-            if (type == searchedType && !branchOrTagList.contains(tag))
-                branchOrTagList.push_back(tag);
+        QSet<QString> names;
+
+        const QList<CvsRecords::StatusRecord> records = CvsRecords::read<CvsRecords::StatusRecord>(dlg.getRecords(CvsRecords::Status));
+        for (const CvsRecords::StatusRecord &record : records) {
+            for (const CvsRecords::TagRecord &tag : record.tags) {
+                if (tag.isBranch == searchBranches)
+                    names.insert(tag.name);
+            }
         }
 
+        branchOrTagList = QStringList(names.begin(), names.end());
         branchOrTagList.sort();
     }
 
@@ -232,6 +222,46 @@ const QStringList fetchTags(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsSer
     return FetchBranchesAndTags(QLatin1String("revision"), cvsService, parent);
 }
 
+/**
+ * @return The cvs job @p jobPath if @p service is the in-process service
+ *         (see CervisiaSettings::inProcessService()), 0 otherwise.
+ */
+static QObject *localCvsJob(const QString &service, const QString &jobPath)
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (service != bus.baseService())
+        return 0;
+
+    return bus.objectRegisteredAt(jobPath);
+}
+
+/**
+ * @return The name of @p signal, e.g. "jobExited" for
+ *         SIGNAL(jobExited(bool, int)).
+ */
+static QString signalName(const char *signal)
+{
+    // skip the code added by the SIGNAL() macro
+    const QString name = QString::fromLatin1(signal + 1);
+    return name.left(name.indexOf('('));
+}
+
+bool connectCvsJob(const QString &service, const QString &jobPath, const char *signal, QObject *receiver, const char *slot)
+{
+    if (QObject *job = localCvsJob(service, jobPath))
+        return QObject::connect(job, signal, receiver, slot);
+
+    return QDBusConnection::sessionBus().connect(QString(), jobPath, "org.kde.cervisia5.cvsservice.cvsjob", signalName(signal), receiver, slot);
+}
+
+bool disconnectCvsJob(const QString &service, const QString &jobPath, const char *signal, QObject *receiver, const char *slot)
+{
+    if (QObject *job = localCvsJob(service, jobPath))
+        return QObject::disconnect(job, signal, receiver, slot);
+
+    return QDBusConnection::sessionBus().disconnect(QString(), jobPath, "org.kde.cervisia5.cvsservice.cvsjob", signalName(signal), receiver, slot);
+}
+
 static QStringList *tempFiles = 0;
 
 void cleanupTempFiles()
@@ -258,46 +288,14 @@ QString tempFileName(const QString &suffix)
 
 int compareRevisions(const QString &rev1, const QString &rev2)
 {
-    const int length1(rev1.length());
-    const int length2(rev2.length());
-
-    // compare all parts of the revision
-
-    int startPos1(0);
-    int startPos2(0);
-    while (startPos1 < length1 && startPos2 < length2) {
-        int pos1(rev1.indexOf('.', startPos1));
-        if (pos1 < 0)
-            pos1 = length1;
-        const int partLength1(pos1 - startPos1);
-
-        int pos2(rev2.indexOf('.', startPos2));
-        if (pos2 < 0)
-            pos2 = length2;
-        const int partLength2(pos2 - startPos2);
-
-        // if the number of digits in both parts is not equal we are ready
-        if (const int comp = ::compare(partLength1, partLength2))
-            return comp;
-
-        // if the parts are not equal we are ready
-        if (const int comp = ::compare(rev1.mid(startPos1, partLength1), rev2.mid(startPos2, partLength2)))
-            return comp;
-
-        // continue with next part
-        startPos1 = pos1 + 1;
-        startPos2 = pos2 + 1;
-    }
+    const Cervisia::Revision revision1(rev1);
+    const Cervisia::Revision revision2(rev2);
 
-    // rev1 has more parts than rev2: rev2 < rev1
-    if (startPos1 < length1)
-        return 1;
-    // rev2 has more parts than rev1: rev1 < rev2
-    else if (startPos2 < length2)
-        return -1;
-    // all parts of rev1 and rev2 were compared (the number of parts is equal): rev1 == rev2
-    else
-        return 0;
+    // e.g. an empty revision
+    if (revision1.isNull() || revision2.isNull())
+        return ::compare(rev1, rev2);
+
+    return revision1.compare(revision2);
 }
 
 // Local Variables:
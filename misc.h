@@ -23,6 +23,7 @@
 
 #include <QStringList>
 
+class QObject;
 class QString;
 class QWidget;
 class OrgKdeCervisia5CvsserviceCvsserviceInterface;
@@ -58,6 +59,15 @@ void cleanupTempFiles();
 const QStringList fetchBranches(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, QWidget *parent);
 const QStringList fetchTags(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, QWidget *parent);
 
+/**
+ * Connects @p signal (e.g. SIGNAL(jobExited(bool, int))) of the cvs job
+ * @p jobPath of @p service to @p slot of @p receiver. The jobs of the
+ * in-process service don't send their signals over the bus, they are
+ * connected directly.
+ */
+bool connectCvsJob(const QString &service, const QString &jobPath, const char *signal, QObject *receiver, const char *slot);
+bool disconnectCvsJob(const QString &service, const QString &jobPath, const char *signal, QObject *receiver, const char *slot);
+
 /**
  * Compares two revision numbers.
  *
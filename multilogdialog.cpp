@@ -0,0 +1,279 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "multilogdialog.h"
+
+#include <QCheckBox>
+#include <QDateEdit>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KHelpClient>
+#include <KLocalizedString>
+#include <KMessageBox>
+
+#include "cvsjobinterface.h"
+#include "cvsservice/cvsjob.h"
+#include "cvsservice/cvsrecords.h"
+#include "cvsserviceinterface.h"
+#include "logdialog.h"
+#include "multilogmodel.h"
+#include "progressdialog.h"
+
+namespace
+{
+// adds the revisions of the rlog output to the model
+class ModelLogParser : public CvsRecords::LogParser
+{
+public:
+    ModelLogParser(MultiLogModel *model, const QString &module)
+        : m_model(model)
+        , m_module(module)
+    {
+    }
+
+protected:
+    void revisionParsed(const CvsRecords::LogRecord &file, const CvsRecords::RevisionRecord &revision) override
+    {
+        // all revisions of a file have the same RCS file
+        if (file.fileName != m_rcsFile) {
+            m_rcsFile = file.fileName;
+            m_fileName = CvsRecords::moduleFileName(m_rcsFile, m_module);
+        }
+
+        m_model->addRevision(m_fileName, revision.revision, revision.dateTime, revision.author, revision.comment);
+    }
+
+private:
+    MultiLogModel *const m_model;
+    const QString m_module;
+    QString m_rcsFile;
+    QString m_fileName; // of m_rcsFile
+};
+}
+
+MultiLogDialog::MultiLogDialog(KConfig &cfg, QWidget *parent)
+    : QDialog(parent)
+    , parser(0)
+    , cvsService(0)
+    , partConfig(cfg)
+{
+    auto mainLayout = new QVBoxLayout;
+    setLayout(mainLayout);
+
+    model = new MultiLogModel(this);
+
+    // the filters need the complete log, see parseCvsLog()
+    filters = new QWidget;
+    filters->setEnabled(false);
+    mainLayout->addWidget(filters);
+
+    auto grid = new QGridLayout(filters);
+    grid->setContentsMargins(0, 0, 0, 0);
+    grid->setColumnStretch(1, 1);
+
+    author_edit = new QLineEdit;
+    author_edit->setClearButtonEnabled(true);
+    auto authorLabel = new QLabel(i18n("&Author:"));
+    authorLabel->setBuddy(author_edit);
+    grid->addWidget(authorLabel, 0, 0);
+    grid->addWidget(author_edit, 0, 1);
+
+    path_edit = new QLineEdit;
+    path_edit->setClearButtonEnabled(true);
+    path_edit->setWhatsThis(i18n("Shows only the files whose path begins with this text, e.g. a subfolder."));
+    auto pathLabel = new QLabel(i18n("&Path:"));
+    pathLabel->setBuddy(path_edit);
+    grid->addWidget(pathLabel, 1, 0);
+    grid->addWidget(path_edit, 1, 1);
+
+    from_box = new QCheckBox(i18n("&From:"));
+    from_edit = new QDateEdit(QDate::currentDate().addMonths(-1));
+    from_edit->setCalendarPopup(true);
+    from_edit->setEnabled(false);
+    grid->addWidget(from_box, 0, 2);
+    grid->addWidget(from_edit, 0, 3);
+
+    to_box = new QCheckBox(i18n("&To:"));
+    to_edit = new QDateEdit(QDate::currentDate());
+    to_edit->setCalendarPopup(true);
+    to_edit->setEnabled(false);
+    grid->addWidget(to_box, 1, 2);
+    grid->addWidget(to_edit, 1, 3);
+
+    connect(author_edit, SIGNAL(textChanged(QString)), this, SLOT(applyFilter()));
+    connect(path_edit, SIGNAL(textChanged(QString)), this, SLOT(applyFilter()));
+    connect(from_box, SIGNAL(toggled(bool)), from_edit, SLOT(setEnabled(bool)));
+    connect(from_box, SIGNAL(toggled(bool)), this, SLOT(applyFilter()));
+    connect(from_edit, SIGNAL(dateChanged(QDate)), this, SLOT(applyFilter()));
+    connect(to_box, SIGNAL(toggled(bool)), to_edit, SLOT(setEnabled(bool)));
+    connect(to_box, SIGNAL(toggled(bool)), this, SLOT(applyFilter()));
+    connect(to_edit, SIGNAL(dateChanged(QDate)), this, SLOT(applyFilter()));
+
+    splitter = new QSplitter(Qt::Vertical);
+    mainLayout->addWidget(splitter, 1);
+
+    // all rows have the same height, so the view never asks for more
+    // rows than it shows
+    view = new QTreeView;
+    view->setModel(model);
+    view->setRootIsDecorated(false);
+    view->setUniformRowHeights(true);
+    view->setAllColumnsShowFocus(true);
+    view->setWhatsThis(i18n("Double-click a revision to show the log of its file."));
+    splitter->addWidget(view);
+    splitter->setStretchFactor(0, 1);
+
+    connect(view->selectionModel(), SIGNAL(currentRowChanged(QModelIndex, QModelIndex)), this, SLOT(revisionSelected(QModelIndex)));
+    connect(view, SIGNAL(activated(QModelIndex)), this, SLOT(revisionActivated(QModelIndex)));
+
+    commentbox = new QPlainTextEdit;
+    commentbox->setReadOnly(true);
+    splitter->addWidget(commentbox);
+
+    status = new QLabel;
+    mainLayout->addWidget(status);
+
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Help | QDialogButtonBox::Close);
+    connect(buttonBox, &QDialogButtonBox::helpRequested, this, &MultiLogDialog::slotHelp);
+    connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+    mainLayout->addWidget(buttonBox);
+
+    // the filters are applied while typing, "return" isn't needed
+    buttonBox->button(QDialogButtonBox::Close)->setDefault(true);
+
+    setAttribute(Qt::WA_DeleteOnClose, true);
+
+    KConfigGroup cg(&partConfig, "MultiLogDialog");
+    restoreGeometry(cg.readEntry<QByteArray>("geometry", QByteArray()));
+    splitter->restoreState(cg.readEntry<QByteArray>("Splitter", QByteArray()));
+    view->header()->restoreState(cg.readEntry<QByteArray>("MultiLogListView", QByteArray()));
+}
+
+MultiLogDialog::~MultiLogDialog()
+{
+    KConfigGroup cg(&partConfig, "MultiLogDialog");
+    cg.writeEntry("geometry", saveGeometry());
+    cg.writeEntry("Splitter", splitter->saveState());
+    cg.writeEntry("MultiLogListView", view->header()->saveState());
+
+    delete parser;
+}
+
+bool MultiLogDialog::parseCvsLog(OrgKdeCervisia5CvsserviceCvsserviceInterface *service,
+                                 const QString &repository,
+                                 const QString &module,
+                                 const QString &dir)
+{
+    cvsService = service;
+    directory = dir;
+
+    setWindowTitle(i18n("CVS Multi-File Log: %1", module));
+
+    if (!model->open()) {
+        KMessageBox::error(this, i18n("Could not create the temporary files for the log."), "Cervisia");
+        return false;
+    }
+
+    QDBusReply<QDBusObjectPath> job = cvsService->rlog(repository, module, true);
+    if (!job.isValid())
+        return false;
+
+    OrgKdeCervisia5CvsserviceCvsjobInterface cvsJob(cvsService->service(), job.value().path(), QDBusConnection::sessionBus());
+    // the revisions are kept by the model
+    cvsJob.setOutputRetention(CvsJob::RetainNone, 0);
+
+    delete parser;
+    parser = new ModelLogParser(model, module);
+
+    ProgressDialog dlg(this, "Logging", cvsService->service(), job, "rlog", i18n("CVS Log"));
+    dlg.setStreaming(true);
+    connect(&dlg, SIGNAL(receivedLine(QString)), this, SLOT(parseLogLine(QString)));
+    if (!dlg.execute())
+        return false;
+
+    model->finish();
+    filters->setEnabled(true);
+    applyFilter();
+
+    return true;
+}
+
+void MultiLogDialog::slotHelp()
+{
+    KHelpClient::invokeHelp(QLatin1String("browsinglogs"));
+}
+
+void MultiLogDialog::applyFilter()
+{
+    model->setFilter(author_edit->text().trimmed(),
+                     path_edit->text().trimmed(),
+                     from_box->isChecked() ? from_edit->date() : QDate(),
+                     to_box->isChecked() ? to_edit->date() : QDate());
+
+    commentbox->clear();
+    status->setText(i18np("%2 of 1 revision", "%2 of %1 revisions", model->revisionCount(), model->rowCount()));
+}
+
+void MultiLogDialog::parseLogLine(const QString &line)
+{
+    parser->parseLine(line);
+}
+
+void MultiLogDialog::revisionSelected(const QModelIndex &index)
+{
+    if (!index.isValid()) {
+        commentbox->clear();
+        return;
+    }
+
+    const QString file = model->fileName(index.row());
+    const int count = model->revisionCount(file);
+
+    commentbox->setPlainText(i18np("%2, revision %3 (1 revision)", "%2, revision %3 (%1 revisions)", count, file, model->revision(index.row()))
+                             + QLatin1String("\n\n") + model->comment(index.row()));
+}
+
+void MultiLogDialog::revisionActivated(const QModelIndex &index)
+{
+    if (!index.isValid() || !cvsService)
+        return;
+
+    const QString file = model->fileName(index.row());
+
+    // Non-modal dialog
+    auto l = new LogDialog(partConfig);
+    if (l->parseCvsLog(cvsService, directory.isEmpty() ? file : directory + '/' + file))
+        l->show();
+    else
+        delete l;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MULTILOGDIALOG_H
+#define MULTILOGDIALOG_H
+
+#include <QDialog>
+
+class QCheckBox;
+class QDateEdit;
+class QLabel;
+class QLineEdit;
+class QModelIndex;
+class QPlainTextEdit;
+class QSplitter;
+class QTreeView;
+class KConfig;
+class MultiLogModel;
+class OrgKdeCervisia5CvsserviceCvsserviceInterface;
+
+namespace CvsRecords
+{
+class LogParser;
+}
+
+/**
+ * Shows the revisions of all files of a folder and its subfolders newest
+ * first, as reported by rlog. The log is parsed while it arrives and kept
+ * on disk by MultiLogModel, so even the log of a large module needs little
+ * memory.
+ */
+class MultiLogDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MultiLogDialog(KConfig &cfg, QWidget *parent = nullptr);
+    ~MultiLogDialog() override;
+
+    /**
+     * @param module the place of @p directory in the repository as found
+     *        in CVS/Repository
+     * @param directory the folder relative to the working copy, empty for
+     *        the working copy itself
+     */
+    bool parseCvsLog(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, const QString &repository, const QString &module, const QString &directory);
+
+private Q_SLOTS:
+    void slotHelp();
+    void applyFilter();
+    void parseLogLine(const QString &line);
+    void revisionSelected(const QModelIndex &index);
+    void revisionActivated(const QModelIndex &index);
+
+private:
+    CvsRecords::LogParser *parser; // adds the revisions to the model
+    MultiLogModel *model;
+    QSplitter *splitter;
+    QTreeView *view;
+    QPlainTextEdit *commentbox;
+    QWidget *filters;
+    QLineEdit *author_edit, *path_edit;
+    QCheckBox *from_box, *to_box;
+    QDateEdit *from_edit, *to_edit;
+    QLabel *status;
+
+    OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    QString directory;
+    KConfig &partConfig;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
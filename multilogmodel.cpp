@@ -0,0 +1,385 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "multilogmodel.h"
+
+#include <QBitArray>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QLocale>
+#include <QStringList>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include <KLocalizedString>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// a revision in the entry file
+struct Entry {
+    qint64 textOffset; // of "revision\ncomment" in the text file
+    quint32 textLength;
+    quint32 time; // seconds since the epoch
+    quint32 file;
+    quint32 author;
+};
+
+// the chronological order only needs the date and the place of the entry
+struct SortKey {
+    quint32 time;
+    quint32 entry;
+};
+
+bool newerThan(const SortKey &a, const SortKey &b)
+{
+    if (a.time != b.time)
+        return a.time > b.time;
+
+    // the log lists the newest revision of a file first
+    return a.entry < b.entry;
+}
+
+quint32 toTime(const QDateTime &dateTime)
+{
+    return quint32(qBound<qint64>(0, dateTime.toSecsSinceEpoch(), std::numeric_limits<quint32>::max()));
+}
+
+int intern(const QString &name, QStringList &names, QHash<QString, int> &ids)
+{
+    const auto it = ids.constFind(name);
+    if (it != ids.constEnd())
+        return it.value();
+
+    const int id = names.count();
+    names.append(name);
+    ids.insert(name, id);
+    return id;
+}
+
+QString firstLine(const QString &comment)
+{
+    const int pos = comment.indexOf('\n');
+    return (pos < 0) ? comment.simplified() : comment.left(pos).simplified() + "...";
+}
+}
+
+struct MultiLogModel::Private {
+    Private()
+        : textSize(0)
+        , entries(0)
+        , texts(0)
+        , first(0)
+        , last(0)
+        , filtered(false)
+        , finished(false)
+    {
+    }
+
+    Entry entry(int row) const;
+    Entry readEntry(quint32 index) const;
+    QString text(const Entry &entry) const;
+
+    QTemporaryFile entryFile;
+    QTemporaryFile textFile;
+    qint64 textSize;
+
+    // both files are mapped once the log is complete, otherwise they are
+    // read with their own handles so that the write position stays put
+    const Entry *entries;
+    const char *texts;
+    mutable QFile entryReader;
+    mutable QFile textReader;
+
+    QStringList files;
+    QHash<QString, int> fileIds;
+    QVector<quint32> revisionCounts; // by file id
+
+    QStringList authors;
+    QHash<QString, int> authorIds;
+
+    QVector<SortKey> order; // newest first
+
+    // the shown part of the order, restricted by the dates...
+    int first;
+    int last;
+    // ... and by the authors and the files
+    bool filtered;
+    QVector<quint32> rows;
+
+    // the order is only sorted and the files only readable after finish()
+    bool finished;
+};
+
+Entry MultiLogModel::Private::entry(int row) const
+{
+    return readEntry(order.at(filtered ? int(rows.at(row)) : first + row).entry);
+}
+
+Entry MultiLogModel::Private::readEntry(quint32 index) const
+{
+    if (entries)
+        return entries[index];
+
+    // the file couldn't be mapped, e.g. in a 32 bit process
+    Entry result = {};
+    if (entryReader.seek(qint64(index) * sizeof(Entry)))
+        entryReader.read(reinterpret_cast<char *>(&result), sizeof(Entry));
+    return result;
+}
+
+QString MultiLogModel::Private::text(const Entry &entry) const
+{
+    if (texts)
+        return QString::fromUtf8(texts + entry.textOffset, entry.textLength);
+
+    if (!textReader.seek(entry.textOffset))
+        return QString();
+    return QString::fromUtf8(textReader.read(entry.textLength));
+}
+
+MultiLogModel::MultiLogModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , d(new Private)
+{
+}
+
+MultiLogModel::~MultiLogModel()
+{
+    delete d;
+}
+
+bool MultiLogModel::open()
+{
+    return d->entryFile.open() && d->textFile.open();
+}
+
+void MultiLogModel::addRevision(const QString &fileName, const QString &revision, const QDateTime &date, const QString &author, const QString &comment)
+{
+    // the order can't have more entries
+    if (d->order.count() == std::numeric_limits<int>::max())
+        return;
+
+    const QByteArray text = (revision + '\n' + comment).toUtf8();
+    if (d->textFile.write(text) != text.size())
+        return;
+
+    Entry entry;
+    entry.textOffset = d->textSize;
+    entry.textLength = text.size();
+    entry.time = toTime(date);
+    entry.author = intern(author, d->authors, d->authorIds);
+
+    // the revisions of a file follow each other
+    if (!d->files.isEmpty() && d->files.last() == fileName) {
+        entry.file = d->files.count() - 1;
+    } else {
+        entry.file = intern(fileName, d->files, d->fileIds);
+        if (int(entry.file) == d->revisionCounts.count())
+            d->revisionCounts.append(0);
+    }
+
+    if (d->entryFile.write(reinterpret_cast<const char *>(&entry), sizeof(Entry)) != sizeof(Entry))
+        return;
+
+    d->textSize += text.size();
+    ++d->revisionCounts[entry.file];
+
+    SortKey key;
+    key.time = entry.time;
+    key.entry = d->order.count();
+    d->order.append(key);
+}
+
+void MultiLogModel::finish()
+{
+    beginResetModel();
+
+    d->entryFile.flush();
+    d->textFile.flush();
+
+    const qint64 entrySize = qint64(d->order.count()) * sizeof(Entry);
+    if (entrySize > 0) {
+        d->entries = reinterpret_cast<const Entry *>(d->entryFile.map(0, entrySize));
+        if (d->textSize > 0)
+            d->texts = reinterpret_cast<const char *>(d->textFile.map(0, d->textSize));
+        if (!d->texts)
+            d->entries = 0;
+    }
+
+    if (!d->entries) {
+        d->entryReader.setFileName(d->entryFile.fileName());
+        d->entryReader.open(QIODevice::ReadOnly);
+        d->textReader.setFileName(d->textFile.fileName());
+        d->textReader.open(QIODevice::ReadOnly);
+    }
+
+    std::sort(d->order.begin(), d->order.end(), newerThan);
+
+    d->first = 0;
+    d->last = d->order.count();
+    d->filtered = false;
+    d->rows.clear();
+    d->finished = true;
+
+    endResetModel();
+}
+
+int MultiLogModel::revisionCount() const
+{
+    return d->order.count();
+}
+
+int MultiLogModel::revisionCount(const QString &fileName) const
+{
+    const int file = d->fileIds.value(fileName, -1);
+    return (file < 0) ? 0 : int(d->revisionCounts.at(file));
+}
+
+void MultiLogModel::setFilter(const QString &author, const QString &path, const QDate &from, const QDate &to)
+{
+    if (!d->finished)
+        return;
+
+    beginResetModel();
+
+    // the order is by date, so the days are a contiguous part of it
+    const SortKey *begin = d->order.constData();
+    const SortKey *end = begin + d->order.count();
+    const SortKey *firstKey = begin;
+    const SortKey *lastKey = end;
+    if (to.isValid()) {
+        const quint32 limit = toTime(to.addDays(1).startOfDay());
+        firstKey = std::partition_point(begin, end, [limit](const SortKey &key) {
+            return key.time >= limit;
+        });
+    }
+    if (from.isValid()) {
+        const quint32 limit = toTime(from.startOfDay());
+        lastKey = std::partition_point(firstKey, end, [limit](const SortKey &key) {
+            return key.time >= limit;
+        });
+    }
+    d->first = firstKey - begin;
+    d->last = qMax(d->first, int(lastKey - begin));
+
+    // the names are compared once, the entries only need a bit
+    d->filtered = !author.isEmpty() || !path.isEmpty();
+    d->rows.clear();
+    if (d->filtered) {
+        QBitArray authorMatches(d->authors.count(), author.isEmpty());
+        if (!author.isEmpty()) {
+            for (int i = 0; i < d->authors.count(); ++i)
+                authorMatches.setBit(i, d->authors.at(i).startsWith(author, Qt::CaseInsensitive));
+        }
+
+        QBitArray fileMatches(d->files.count(), path.isEmpty());
+        if (!path.isEmpty()) {
+            for (int i = 0; i < d->files.count(); ++i)
+                fileMatches.setBit(i, d->files.at(i).startsWith(path));
+        }
+
+        for (int position = d->first; position < d->last; ++position) {
+            const Entry entry = d->readEntry(d->order.at(position).entry);
+            if (authorMatches.testBit(entry.author) && fileMatches.testBit(entry.file))
+                d->rows.append(position);
+        }
+    }
+
+    endResetModel();
+}
+
+QString MultiLogModel::fileName(int row) const
+{
+    return d->files.at(d->entry(row).file);
+}
+
+QString MultiLogModel::revision(int row) const
+{
+    return d->text(d->entry(row)).section('\n', 0, 0);
+}
+
+QString MultiLogModel::comment(int row) const
+{
+    return d->text(d->entry(row)).section('\n', 1);
+}
+
+int MultiLogModel::columnCount(const QModelIndex & /*parent*/) const
+{
+    return ColumnCount;
+}
+
+int MultiLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return d->filtered ? d->rows.count() : d->last - d->first;
+}
+
+QVariant MultiLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount() || role != Qt::DisplayRole)
+        return {};
+
+    const Entry entry = d->entry(index.row());
+
+    switch (index.column()) {
+    case DateColumn:
+        return QLocale().toString(QDateTime::fromSecsSinceEpoch(entry.time), QLocale::ShortFormat);
+    case AuthorColumn:
+        return d->authors.at(entry.author);
+    case FileColumn:
+        return d->files.at(entry.file);
+    case RevisionColumn:
+        return d->text(entry).section('\n', 0, 0);
+    case CommentColumn:
+        return firstLine(d->text(entry).section('\n', 1));
+    default:
+        return {};
+    }
+}
+
+QVariant MultiLogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    // only provide text for the headers
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return {};
+
+    switch (section) {
+    case DateColumn:
+        return i18n("Date");
+    case AuthorColumn:
+        return i18n("Author");
+    case FileColumn:
+        return i18n("File");
+    case RevisionColumn:
+        return i18n("Revision");
+    case CommentColumn:
+        return i18n("Comment");
+    default:
+        return {};
+    }
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MULTILOGMODEL_H
+#define MULTILOGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QDate>
+
+/**
+ * The revisions of many files, e.g. the output of rlog for a module, newest
+ * first. The revisions are kept in temporary files instead of memory: one
+ * fixed-size entry per revision in the order of the log, i.e. the entries
+ * of a file are next to each other, and the texts in a second file. Only
+ * the file names, the authors and the chronological order stay in memory.
+ * The texts of the columns are read when a view asks for them.
+ */
+class MultiLogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Columns { DateColumn = 0, AuthorColumn, FileColumn, RevisionColumn, CommentColumn, ColumnCount };
+
+    explicit MultiLogModel(QObject *parent = nullptr);
+    ~MultiLogModel() override;
+
+    /**
+     * Creates the temporary files.
+     *
+     * @return false if they can't be created
+     */
+    bool open();
+
+    /**
+     * Appends a revision of @p fileName. The revisions of a file must be
+     * added one after another.
+     */
+    void addRevision(const QString &fileName, const QString &revision, const QDateTime &date, const QString &author, const QString &comment);
+
+    /**
+     * Sorts the revisions added so far by their date and shows them.
+     */
+    void finish();
+
+    /**
+     * @return The number of revisions of all files.
+     */
+    int revisionCount() const;
+
+    /**
+     * @return The number of revisions of @p fileName.
+     */
+    int revisionCount(const QString &fileName) const;
+
+    /**
+     * Shows only the revisions which match all the given conditions, an
+     * empty string or an invalid date doesn't restrict anything.
+     *
+     * @param author the beginning of the author name (case insensitive)
+     * @param path the beginning of the file path
+     * @param from, to the first and the last day
+     *
+     * Does nothing before finish(), while the revisions are still added.
+     */
+    void setFilter(const QString &author, const QString &path, const QDate &from, const QDate &to);
+
+    QString fileName(int row) const;
+    QString revision(int row) const;
+    QString comment(int row) const;
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Private;
+    Private *d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
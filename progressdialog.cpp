@@ -21,6 +21,7 @@
 
 #include <QApplication>
 #include <QDialogButtonBox>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -32,7 +33,9 @@
 #include <QVBoxLayout>
 
 #include "cervisiasettings.h"
+#include "cvsservice/linesplitter.h"
 #include "debug.h"
+#include "misc.h"
 #include <cvsjobinterface.h>
 
 //---------------------------------------------------------------------
@@ -42,13 +45,16 @@ struct ProgressDialog::Private {
     bool isShown;
     bool hasError;
     bool isDiff;
+    bool isStreaming;
+    bool isRecordsOnly;
 
     OrgKdeCervisia5CvsserviceCvsjobInterface *cvsJob;
     QString jobPath;
-    QString buffer;
+    LineSplitter splitter;
     QString errorId1, errorId2;
     QStringList output;
     QEventLoop eventLoop;
+    QElapsedTimer clientTimer; // started when the caller gets the output
 
     QTimer *timer;
     QProgressBar *busy;
@@ -75,6 +81,8 @@ ProgressDialog::ProgressDialog(QWidget *parent,
     d->isShown = false;
     d->hasError = false;
     d->isDiff = heading == QLatin1String("Diff"); // cvs returns error status when there is a difference
+    d->isStreaming = false;
+    d->isRecordsOnly = false;
 
     QDBusObjectPath path = jobPath;
     d->jobPath = path.path();
@@ -90,6 +98,13 @@ ProgressDialog::ProgressDialog(QWidget *parent,
 
 ProgressDialog::~ProgressDialog()
 {
+    // the caller has processed the output now
+    if (d->clientTimer.isValid())
+        d->cvsJob->reportClientTime(d->clientTimer.elapsed());
+
+    // we are done with the job, let the service free it
+    d->cvsJob->release();
+
     delete d->cvsJob;
     delete d;
 }
@@ -126,6 +141,20 @@ void ProgressDialog::setupGui(const QString &heading)
 
 //---------------------------------------------------------------------
 
+void ProgressDialog::setStreaming(bool streaming)
+{
+    d->isStreaming = streaming;
+}
+
+//---------------------------------------------------------------------
+
+void ProgressDialog::setRecordsOnly(bool recordsOnly)
+{
+    d->isRecordsOnly = recordsOnly;
+}
+
+//---------------------------------------------------------------------
+
 bool ProgressDialog::execute()
 {
     // get command line and display it
@@ -133,13 +162,14 @@ bool ProgressDialog::execute()
     d->resultbox->insertPlainText(cmdLine);
     qCDebug(log_cervisia) << "cmdLine:" << cmdLine;
 
-    QDBusConnection::sessionBus().connect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "jobExited", this, SLOT(slotJobExited(bool, int)));
+    connectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(jobExited(bool, int)), this, SLOT(slotJobExited(bool, int)));
 
-    QDBusConnection::sessionBus()
-        .connect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStdout", this, SLOT(slotReceivedOutputNonGui(QString)));
+    if (d->isRecordsOnly)
+        d->cvsJob->setForwardStdout(false);
+    else
+        connectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStdout(QString)), this, SLOT(slotReceivedOutputNonGui(QString)));
 
-    QDBusConnection::sessionBus()
-        .connect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStderr", this, SLOT(slotReceivedOutputNonGui(QString)));
+    connectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStderr(QString)), this, SLOT(slotReceivedOutputNonGui(QString)));
 
     // we wait for 4 seconds (or the timeout set by the user) before we
     // force the dialog to show up
@@ -159,7 +189,17 @@ bool ProgressDialog::execute()
     if (QApplication::overrideCursor())
         QApplication::restoreOverrideCursor();
 
-    return !d->isCancelled;
+    d->clientTimer.start();
+
+    // a streaming caller keeps what it got until the user cancelled
+    return !d->isCancelled || (d->isStreaming && !d->hasError);
+}
+
+//---------------------------------------------------------------------
+
+bool ProgressDialog::wasCancelled() const
+{
+    return d->isCancelled;
 }
 
 //---------------------------------------------------------------------
@@ -184,11 +224,19 @@ QStringList ProgressDialog::getOutput() const
 
 //---------------------------------------------------------------------
 
+QByteArray ProgressDialog::getRecords(int type) const
+{
+    const QDBusReply<QByteArray> records = d->cvsJob->records(type);
+    return records.isValid() ? records.value() : QByteArray();
+}
+
+//---------------------------------------------------------------------
+
 void ProgressDialog::slotReceivedOutputNonGui(QString buffer)
 {
     qCDebug(log_cervisia) << buffer;
 
-    d->buffer += buffer;
+    d->splitter.append(buffer);
 
     processOutput();
     if (d->hasError) {
@@ -202,7 +250,7 @@ void ProgressDialog::slotReceivedOutputNonGui(QString buffer)
 void ProgressDialog::slotReceivedOutput(QString buffer)
 {
     qCDebug(log_cervisia) << buffer;
-    d->buffer += buffer;
+    d->splitter.append(buffer);
     processOutput();
 }
 
@@ -217,13 +265,17 @@ void ProgressDialog::slotJobExited(bool normalExit, int status)
 
     d->busy->hide();
 
-    if (!d->buffer.isEmpty()) {
-        d->buffer += '\n';
-        processOutput();
+    d->splitter.finish();
+    processOutput();
+
+    if (d->isStreaming && d->isCancelled) {
+        d->eventLoop.exit();
+        return;
     }
 
     if ((status != 0) && !d->isDiff) // cvs command exited with error -> show error text
     {
+        d->hasError = true;
         QString line;
         while (getLine(line)) {
             d->resultbox->insertPlainText(QLatin1String("\n"));
@@ -270,22 +322,24 @@ void ProgressDialog::stopNonGuiPart()
 {
     d->timer->stop();
 
-    QDBusConnection::sessionBus()
-        .disconnect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStdout", this, SLOT(slotReceivedOutputNonGui(QString)));
+    if (!d->isRecordsOnly)
+        disconnectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStdout(QString)), this, SLOT(slotReceivedOutputNonGui(QString)));
 
-    QDBusConnection::sessionBus()
-        .disconnect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStderr", this, SLOT(slotReceivedOutputNonGui(QString)));
+    disconnectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStderr(QString)), this, SLOT(slotReceivedOutputNonGui(QString)));
 }
 
 //---------------------------------------------------------------------
 
 void ProgressDialog::startGuiPart()
 {
-    QDBusConnection::sessionBus()
-        .connect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStdout", this, SLOT(slotReceivedOutput(QString)));
+    if (!d->isRecordsOnly)
+        connectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStdout(QString)), this, SLOT(slotReceivedOutput(QString)));
+
+    connectCvsJob(d->cvsJob->service(), d->jobPath, SIGNAL(receivedStderr(QString)), this, SLOT(slotReceivedOutput(QString)));
 
-    QDBusConnection::sessionBus()
-        .connect(QString(), d->jobPath, "org.kde.cervisia5.cvsservice.cvsjob", "receivedStderr", this, SLOT(slotReceivedOutput(QString)));
+    // let the user watch the output arrive
+    if (d->isStreaming && parentWidget())
+        parentWidget()->window()->show();
 
     show();
     d->isShown = true;
@@ -298,21 +352,19 @@ void ProgressDialog::startGuiPart()
 
 void ProgressDialog::processOutput()
 {
-    int pos;
-    while ((pos = d->buffer.indexOf('\n')) != -1) {
-        QString item = d->buffer.left(pos);
+    QStringView item;
+    while (d->splitter.nextLine(&item)) {
         if (item.startsWith(d->errorId1) || item.startsWith(d->errorId2) || item.startsWith(QLatin1String("cvs [server aborted]:"))) {
             d->hasError = true;
             d->resultbox->insertPlainText(QLatin1String("\n"));
-            d->resultbox->insertPlainText(item);
+            d->resultbox->insertPlainText(item.toString());
         } else if (item.startsWith(QLatin1String("cvs server:"))) {
             d->resultbox->insertPlainText(QLatin1String("\n"));
-            d->resultbox->insertPlainText(item);
-        } else
-            d->output.append(item);
-
-        // remove item from buffer
-        d->buffer.remove(0, pos + 1);
+            d->resultbox->insertPlainText(item.toString());
+        } else if (d->isStreaming)
+            Q_EMIT receivedLine(item.toString());
+        else
+            d->output.append(item.toString());
     }
 }
 
@@ -39,10 +39,42 @@ public:
                    const QString &caption = "");
     ~ProgressDialog() override;
 
+    /**
+     * Delivers the output lines with receivedLine() as soon as they arrive
+     * instead of collecting them for getLine(). When the job takes long,
+     * the parent is shown together with the progress dialog, so the user
+     * can watch it fill and cancel the job once enough is shown. The lines
+     * received so far are kept then, i.e. execute() returns true.
+     */
+    void setStreaming(bool streaming);
+
+    /**
+     * The caller only fetches the output with getRecords(), so the
+     * service doesn't send the standard output as text. getLine() and
+     * getOutput() deliver the standard error only then.
+     */
+    void setRecordsOnly(bool recordsOnly);
+
     bool execute();
+
+    /**
+     * @return true if the user cancelled the job. A streaming caller then
+     *         only received a part of the output.
+     */
+    bool wasCancelled() const;
+
     bool getLine(QString &line);
     QStringList getOutput() const;
 
+    /**
+     * @return The output of the job parsed by the service into records
+     *         of @p type (one of CvsRecords::Type).
+     */
+    QByteArray getRecords(int type) const;
+
+Q_SIGNALS:
+    void receivedLine(const QString &line);
+
 public Q_SLOTS:
     void slotReceivedOutputNonGui(QString buffer);
     void slotReceivedOutput(QString buffer);
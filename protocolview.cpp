@@ -23,7 +23,14 @@
 
 #include <QAction>
 #include <QContextMenuEvent>
+#include <QElapsedTimer>
+#include <QFileDialog>
 #include <QMenu>
+#include <QScrollBar>
+#include <QTemporaryFile>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTimer>
 
 #include <KLocalizedString>
 #include <kmessagebox.h>
@@ -32,11 +39,17 @@
 #include "cervisiasettings.h"
 #include "cvsjobinterface.h"
 #include "debug.h"
+#include "misc.h"
+
+// delay (in ms) in which received lines are collected before they are shown
+static const int FLUSH_DELAY = 50;
 
 ProtocolView::ProtocolView(const QString &appId, QWidget *parent)
-    : QTextEdit(parent)
+    : QPlainTextEdit(parent)
+    , m_spillFile(0)
     , job(0)
     , m_isUpdateJob(false)
+    , m_clientTime(0)
 {
     new ProtocolviewAdaptor(this);
     QDBusConnection::sessionBus().registerObject("/ProtocolView", this);
@@ -45,16 +58,17 @@ ProtocolView::ProtocolView(const QString &appId, QWidget *parent)
     setUndoRedoEnabled(false);
     setTabChangesFocus(true);
 
-    // qCDebug(log_cervisia) << "protocol view appId :" << appId;
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_DELAY);
+    connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flushLines()));
 
-    job = new OrgKdeCervisia5CvsserviceCvsjobInterface(appId, "/NonConcurrentJob", QDBusConnection::sessionBus(), this);
+    // qCDebug(log_cervisia) << "protocol view appId :" << appId;
 
-    QDBusConnection::sessionBus()
-        .connect(QString(), "/NonConcurrentJob", "org.kde.cervisia5.cvsservice.cvsjob", "jobExited", this, SLOT(slotJobExited(bool, int)));
-    QDBusConnection::sessionBus()
-        .connect(QString(), "/NonConcurrentJob", "org.kde.cervisia5.cvsservice.cvsjob", "receivedStdout", this, SLOT(slotReceivedOutput(QString)));
-    QDBusConnection::sessionBus()
-        .connect(QString(), "/NonConcurrentJob", "org.kde.cervisia5.cvsservice.cvsjob", "receivedStderr", this, SLOT(slotReceivedOutput(QString)));
+    // the connection to the job is made when it is needed, as each
+    // connect is a round trip to the bus and the service might not even
+    // be running yet
+    m_appId = appId;
 
     configChanged();
 
@@ -63,34 +77,64 @@ ProtocolView::ProtocolView(const QString &appId, QWidget *parent)
 
 ProtocolView::~ProtocolView()
 {
+    delete m_spillFile;
     delete job;
 }
 
-bool ProtocolView::startJob(bool isUpdateJob)
+void ProtocolView::setAppId(const QString &appId)
 {
-    m_isUpdateJob = isUpdateJob;
+    m_appId = appId;
+}
 
-    // get command line and add it to output buffer
-    QString cmdLine = job->cvsCommand();
-    buf += cmdLine;
-    buf += '\n';
-    processOutput();
+void ProtocolView::connectJob()
+{
+    if (job)
+        return;
+
+    job = new OrgKdeCervisia5CvsserviceCvsjobInterface(m_appId, "/NonConcurrentJob", QDBusConnection::sessionBus(), this);
+
+    connectCvsJob(m_appId, "/NonConcurrentJob", SIGNAL(jobExited(bool, int)), this, SLOT(slotJobExited(bool, int)));
+    connectCvsJob(m_appId, "/NonConcurrentJob", SIGNAL(receivedStdout(QString)), this, SLOT(slotReceivedOutput(QString)));
+    connectCvsJob(m_appId, "/NonConcurrentJob", SIGNAL(receivedStderr(QString)), this, SLOT(slotReceivedOutput(QString)));
+}
+
+bool ProtocolView::startJob(bool isUpdateJob, QString *cmdLine)
+{
+    connectJob();
+
+    m_isUpdateJob = isUpdateJob;
+    m_clientTime = 0;
 
     // disconnect 3rd party slots from our signals
     disconnect(SIGNAL(receivedLine(QString)));
     disconnect(SIGNAL(jobFinished(bool, int)));
 
-    return job->execute();
+    // start the job and get its command line in one call; the output
+    // of the job is delivered later from the event loop
+    const QDBusReply<QString> reply = job->submit();
+    const QString command = reply.isValid() ? reply.value() : QString();
+
+    // add command line to output buffer
+    m_splitter.append(command + '\n');
+    processOutput();
+
+    if (cmdLine)
+        *cmdLine = command;
+
+    return !command.isEmpty();
 }
 
 void ProtocolView::contextMenuEvent(QContextMenuEvent *event)
 {
-    QMenu *menu = QTextEdit::createStandardContextMenu();
+    QMenu *menu = QPlainTextEdit::createStandardContextMenu();
 
-    QAction *clearAction = menu->addAction(i18n("Clear"), this, SLOT(clear()));
+    QAction *saveAction = menu->addAction(i18n("Save As..."), this, SLOT(saveProtocol()));
+    QAction *clearAction = menu->addAction(i18n("Clear"), this, SLOT(clearProtocol()));
 
-    if (document()->isEmpty())
+    if (document()->isEmpty() && m_pendingLines.isEmpty()) {
+        saveAction->setEnabled(false);
         clearAction->setEnabled(false);
+    }
 
     menu->exec(event->globalPos());
     delete menu;
@@ -99,22 +143,82 @@ void ProtocolView::contextMenuEvent(QContextMenuEvent *event)
 void ProtocolView::cancelJob()
 {
     qCDebug(log_cervisia);
-    job->cancel();
+    if (job)
+        job->cancel();
 }
 
 void ProtocolView::configChanged()
 {
-    conflictColor = CervisiaSettings::conflictColor();
-    localChangeColor = CervisiaSettings::localChangeColor();
-    remoteChangeColor = CervisiaSettings::remoteChangeColor();
+    // Colors are the same as in UpdateViewItem::paintCell()
+    const QColor colors[] = {QColor(), CervisiaSettings::conflictColor(), CervisiaSettings::localChangeColor(), CervisiaSettings::remoteChangeColor()};
+    for (int status = ConflictLine; status <= RemoteChangeLine; ++status) {
+        QTextCharFormat format;
+        format.setForeground(colors[status]);
+        format.setFontWeight(QFont::Bold);
+        m_formats[status] = format;
+    }
 
     setFont(CervisiaSettings::protocolFont());
+
+    // the document always ends with an empty block
+    setMaximumBlockCount(CervisiaSettings::protocolMaxLines() + 1);
+
+    if (!CervisiaSettings::keepFullProtocol()) {
+        delete m_spillFile;
+        m_spillFile = 0;
+    }
+}
+
+void ProtocolView::clearProtocol()
+{
+    m_pendingLines.clear();
+    m_flushTimer->stop();
+    clear();
+
+    if (m_spillFile) {
+        m_spillFile->resize(0);
+        m_spillFile->seek(0);
+    }
+}
+
+void ProtocolView::saveProtocol()
+{
+    flushLines();
+
+    const QString fileName = QFileDialog::getSaveFileName(this);
+    if (fileName.isEmpty())
+        return;
+
+    if (!Cervisia::CheckOverwrite(fileName, this))
+        return;
+
+    QFile f(fileName);
+    if (!f.open(QIODevice::WriteOnly)) {
+        KMessageBox::error(this, i18n("Could not open file for writing."), "Cervisia");
+        return;
+    }
+
+    // the view might have dropped lines already, the spill file didn't
+    if (m_spillFile && m_spillFile->flush() && m_spillFile->seek(0)) {
+        while (!m_spillFile->atEnd())
+            f.write(m_spillFile->read(64 * 1024));
+        m_spillFile->seek(m_spillFile->size());
+    } else {
+        f.write(toPlainText().toUtf8());
+    }
+
+    f.close();
 }
 
 void ProtocolView::slotReceivedOutput(QString buffer)
 {
-    buf += buffer;
+    QElapsedTimer timer;
+    timer.start();
+
+    m_splitter.append(buffer);
     processOutput();
+
+    m_clientTime += timer.elapsed();
 }
 
 void ProtocolView::slotJobExited(bool normalExit, int exitStatus)
@@ -130,57 +234,98 @@ void ProtocolView::slotJobExited(bool normalExit, int exitStatus)
     } else
         msg = i18n("[Aborted]\n");
 
-    buf += '\n';
-    buf += msg;
+    QElapsedTimer timer;
+    timer.start();
+
+    m_splitter.append('\n' + msg);
     processOutput();
 
     Q_EMIT jobFinished(normalExit, exitStatus);
+
+    // includes the processing of the lines by the update view
+    if (job)
+        job->reportClientTime(m_clientTime + timer.elapsed());
 }
 
 void ProtocolView::processOutput()
 {
-    int pos;
-    while ((pos = buf.indexOf('\n')) != -1) {
-        QString line = buf.left(pos);
-        if (!line.isEmpty()) {
-            appendLine(line);
-            Q_EMIT receivedLine(line);
-        }
-        buf = buf.right(buf.length() - pos - 1);
+    QStringView view;
+    while (m_splitter.nextLine(&view)) {
+        if (view.isEmpty())
+            continue;
+
+        const QString line = view.toString();
+        appendLine(line);
+        Q_EMIT receivedLine(line);
     }
 }
 
 void ProtocolView::appendLine(const QString &line)
 {
-    // Escape output line, so that html tags in commit
-    // messages aren't interpreted
-    const QString escapedLine = line.toHtmlEscaped();
-
+    PendingLine pending;
+    pending.text = line;
     // When we don't get the output from an update job then
     // just add it to the text edit.
-    if (!m_isUpdateJob) {
-        appendHtml(escapedLine);
-        return;
-    }
+    pending.status = m_isUpdateJob ? lineStatus(line) : PlainLine;
+    m_pendingLines.append(pending);
 
-    QColor color;
-    // Colors are the same as in UpdateViewItem::paintCell()
+    if (CervisiaSettings::keepFullProtocol())
+        spillLine(line);
+
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
+}
+
+ProtocolView::LineStatus ProtocolView::lineStatus(const QString &line) const
+{
     if (line.startsWith(QLatin1String("C ")))
-        color = conflictColor;
-    else if (line.startsWith(QLatin1String("M ")) || line.startsWith(QLatin1String("A ")) || line.startsWith(QLatin1String("R ")))
-        color = localChangeColor;
-    else if (line.startsWith(QLatin1String("P ")) || line.startsWith(QLatin1String("U ")))
-        color = remoteChangeColor;
+        return ConflictLine;
+    if (line.startsWith(QLatin1String("M ")) || line.startsWith(QLatin1String("A ")) || line.startsWith(QLatin1String("R ")))
+        return LocalChangeLine;
+    if (line.startsWith(QLatin1String("P ")) || line.startsWith(QLatin1String("U ")))
+        return RemoteChangeLine;
+    return PlainLine;
+}
+
+void ProtocolView::spillLine(const QString &line)
+{
+    if (!m_spillFile) {
+        m_spillFile = new QTemporaryFile;
+        if (!m_spillFile->open()) {
+            qCDebug(log_cervisia) << "can't create the protocol file" << m_spillFile->errorString();
+            delete m_spillFile;
+            m_spillFile = 0;
+            return;
+        }
+    }
 
-    appendHtml(color.isValid() ? QString("<font color=\"%1\"><b>%2</b></font>").arg(color.name()).arg(escapedLine) : escapedLine);
+    m_spillFile->write(line.toUtf8());
+    m_spillFile->write("\n", 1);
 }
 
-void ProtocolView::appendHtml(const QString &html)
+void ProtocolView::flushLines()
 {
-    QTextCursor cursor(textCursor());
-    cursor.insertHtml(html);
-    cursor.insertBlock();
-    ensureCursorVisible();
+    if (m_pendingLines.isEmpty())
+        return;
+
+    // only follow the output if the user didn't scroll away from the end
+    QScrollBar *scrollBar = verticalScrollBar();
+    const bool atEnd = scrollBar->value() == scrollBar->maximum();
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    for (const PendingLine &line : qAsConst(m_pendingLines)) {
+        cursor.insertText(line.text, m_formats[line.status]);
+        cursor.block().setUserState(line.status);
+        cursor.insertBlock();
+    }
+    cursor.endEditBlock();
+
+    m_pendingLines.clear();
+
+    if (atEnd)
+        scrollBar->setValue(scrollBar->maximum());
 }
 
 // Local Variables:
@@ -21,18 +21,48 @@
 #ifndef PROTOCOLVIEW_H
 #define PROTOCOLVIEW_H
 
-#include <QTextEdit>
+#include <QPlainTextEdit>
+#include <QTextCharFormat>
+#include <QVector>
 
+#include "cvsservice/linesplitter.h"
+
+class QTemporaryFile;
+class QTimer;
 class OrgKdeCervisia5CvsserviceCvsjobInterface;
 
-class ProtocolView : public QTextEdit
+/**
+ * Console for the output of the non-concurrent jobs.
+ *
+ * Only the last lines are kept (ProtocolMaxLines) and only the visible
+ * ones are laid out, so a huge output doesn't slow down Cervisia. New
+ * lines are collected and appended in batches. If KeepFullProtocol is
+ * set, the complete output is written to a temporary file in addition.
+ */
+class ProtocolView : public QPlainTextEdit
 {
     Q_OBJECT
 public:
+    /**
+     * The status of a line, stored as user state of its text block.
+     */
+    enum LineStatus { PlainLine, ConflictLine, LocalChangeLine, RemoteChangeLine };
+
     explicit ProtocolView(const QString &appId, QWidget *parent = nullptr);
     ~ProtocolView() override;
 
-    bool startJob(bool isUpdateJob = false);
+    /**
+     * Sets the D-Bus name of the cvs service, when it wasn't known yet at
+     * construction. Must be called before the first job.
+     */
+    void setAppId(const QString &appId);
+
+    /**
+     * Starts the non-concurrent job and shows its command line.
+     *
+     * @param cmdLine If non-null, receives the command line of the job.
+     */
+    bool startJob(bool isUpdateJob = false, QString *cmdLine = nullptr);
 
 protected:
     void contextMenuEvent(QContextMenuEvent *event) override;
@@ -48,21 +78,35 @@ Q_SIGNALS:
 private Q_SLOTS:
     void cancelJob();
     void configChanged();
+    void flushLines();
+    void clearProtocol();
+    void saveProtocol();
 
 private:
+    struct PendingLine {
+        QString text;
+        LineStatus status;
+    };
+
+    void connectJob();
     void processOutput();
     void appendLine(const QString &line);
-    void appendHtml(const QString &html);
+    LineStatus lineStatus(const QString &line) const;
+    void spillLine(const QString &line);
+
+    LineSplitter m_splitter;
 
-    QString buf;
+    QTextCharFormat m_formats[RemoteChangeLine + 1];
 
-    QColor conflictColor;
-    QColor localChangeColor;
-    QColor remoteChangeColor;
+    QVector<PendingLine> m_pendingLines;
+    QTimer *m_flushTimer;
+    QTemporaryFile *m_spillFile; // complete output, if KeepFullProtocol is set
 
-    OrgKdeCervisia5CvsserviceCvsjobInterface *job;
+    QString m_appId;
+    OrgKdeCervisia5CvsserviceCvsjobInterface *job; // created by the first job
 
     bool m_isUpdateJob;
+    qint64 m_clientTime; // time spent on the output of the job (in ms)
 };
 
 #endif
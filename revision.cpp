@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "revision.h"
+
+#include <QHash>
+
+using Cervisia::Revision;
+
+// a part with more digits would overflow
+static const int MAX_DIGITS = 9;
+
+Revision::Revision()
+{
+}
+
+Revision::Revision(const QString &revision)
+{
+    const QChar *it = revision.constData();
+    const QChar *const end = it + revision.length();
+
+    while (it != end) {
+        uint number = 0;
+        int digits = 0;
+        for (; it != end && it->unicode() >= '0' && it->unicode() <= '9'; ++it, ++digits)
+            number = number * 10 + (it->unicode() - '0');
+
+        if (digits == 0 || digits > MAX_DIGITS || (it != end && (*it != QLatin1Char('.') || it + 1 == end))) {
+            m_numbers.clear();
+            return;
+        }
+
+        m_numbers.append(number);
+        if (it != end)
+            ++it; // skip the dot
+    }
+}
+
+QString Revision::toString() const
+{
+    QString result;
+    result.reserve(4 * m_numbers.count());
+    for (int i = 0; i < m_numbers.count(); ++i) {
+        if (i > 0)
+            result += QLatin1Char('.');
+        result += QString::number(m_numbers.at(i));
+    }
+
+    return result;
+}
+
+bool Revision::isOnBranch() const
+{
+    return m_numbers.count() >= 4 && m_numbers.count() % 2 == 0 && !isMagicBranch();
+}
+
+bool Revision::isMagicBranch() const
+{
+    const int n = m_numbers.count();
+    return n >= 4 && n % 2 == 0 && m_numbers.at(n - 2) == 0;
+}
+
+Revision Revision::branch() const
+{
+    const int n = m_numbers.count();
+
+    Revision result;
+    if (isMagicBranch()) {
+        result.m_numbers.append(m_numbers.constData(), n - 2);
+        result.m_numbers.append(m_numbers.at(n - 1));
+    } else if (n >= 3 && n % 2 == 1) {
+        result = *this;
+    } else if (n >= 4) {
+        result.m_numbers.append(m_numbers.constData(), n - 1);
+    }
+
+    return result;
+}
+
+Revision Revision::branchpoint() const
+{
+    const int n = m_numbers.count();
+
+    Revision result;
+    if (n >= 3)
+        result.m_numbers.append(m_numbers.constData(), n % 2 == 1 ? n - 1 : n - 2);
+
+    return result;
+}
+
+Revision Revision::predecessor() const
+{
+    const int n = m_numbers.count();
+    if (n < 2 || n % 2 == 1 || isMagicBranch())
+        return Revision();
+
+    if (m_numbers.at(n - 1) > 1) {
+        Revision result(*this);
+        --result.m_numbers[n - 1];
+        return result;
+    }
+
+    // first revision on a branch (1.2.4.1) => branchpoint (1.2)
+    return branchpoint();
+}
+
+Revision Revision::successor() const
+{
+    const int n = m_numbers.count();
+    if (n < 2 || n % 2 == 1 || isMagicBranch())
+        return Revision();
+
+    Revision result(*this);
+    ++result.m_numbers[n - 1];
+    return result;
+}
+
+int Revision::compare(const Revision &other) const
+{
+    const int n = qMin(m_numbers.count(), other.m_numbers.count());
+    for (int i = 0; i < n; ++i) {
+        const uint lhs = m_numbers.at(i);
+        const uint rhs = other.m_numbers.at(i);
+        if (lhs != rhs)
+            return lhs < rhs ? -1 : 1;
+    }
+
+    // the revision with more parts is the greater one
+    if (m_numbers.count() != other.m_numbers.count())
+        return m_numbers.count() < other.m_numbers.count() ? -1 : 1;
+
+    return 0;
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint Cervisia::qHash(const Revision &revision, uint seed)
+#else
+size_t Cervisia::qHash(const Revision &revision, size_t seed)
+#endif
+{
+    for (int i = 0; i < revision.count(); ++i)
+        seed ^= ::qHash(revision.at(i)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+
+    return seed;
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
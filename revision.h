@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CERVISIA_REVISION_H
+#define CERVISIA_REVISION_H
+
+#include <QVarLengthArray>
+#include <qstring.h>
+
+namespace Cervisia
+{
+
+/**
+ * A CVS revision number like 1.2.4.3, stored as its numbers. Revisions of
+ * the usual depth are kept inline, so comparing them or computing their
+ * branch doesn't allocate.
+ */
+class Revision
+{
+public:
+    /**
+     * Creates a null revision.
+     */
+    Revision();
+
+    /**
+     * Parses @p revision. Anything which isn't a dot separated sequence of
+     * numbers (e.g. a tag or an empty string) results in a null revision.
+     */
+    explicit Revision(const QString &revision);
+
+    bool isNull() const
+    {
+        return m_numbers.isEmpty();
+    }
+
+    /**
+     * @return The number of parts (2 for 1.5, 4 for 1.2.4.3).
+     */
+    int count() const
+    {
+        return m_numbers.count();
+    }
+
+    uint at(int i) const
+    {
+        return m_numbers.at(i);
+    }
+
+    QString toString() const;
+
+    /**
+     * @return true for revisions on a branch like 1.2.4.3.
+     */
+    bool isOnBranch() const;
+
+    /**
+     * @return true for magic branch numbers like 1.2.0.4 as they are
+     *         used in the symbolic names of branch tags.
+     */
+    bool isMagicBranch() const;
+
+    /**
+     * @return The branch number: 1.2.4 for 1.2.4.3 and for the magic branch
+     *         number 1.2.0.4. A null revision for revisions on the trunk.
+     */
+    Revision branch() const;
+
+    /**
+     * @return The revision a branch starts from: 1.2 for 1.2.4.3, 1.2.4 and
+     *         1.2.0.4. A null revision for revisions on the trunk.
+     */
+    Revision branchpoint() const;
+
+    /**
+     * @return The previous revision on the same branch (1.4 for 1.5) or the
+     *         branchpoint for the first revision on a branch (1.2 for
+     *         1.2.4.1). A null revision for the first revision (1.1).
+     */
+    Revision predecessor() const;
+
+    /**
+     * @return The next revision on the same branch (1.6 for 1.5, 1.2.4.4
+     *         for 1.2.4.3). A null revision for branch numbers.
+     */
+    Revision successor() const;
+
+    /**
+     * @return -1 / 0 / 1 if this is < / == / > @p other
+     */
+    int compare(const Revision &other) const;
+
+    bool operator==(const Revision &other) const
+    {
+        return m_numbers == other.m_numbers;
+    }
+
+    bool operator!=(const Revision &other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator<(const Revision &other) const
+    {
+        return compare(other) < 0;
+    }
+
+private:
+    QVarLengthArray<uint, 6> m_numbers;
+};
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+uint qHash(const Revision &revision, uint seed = 0);
+#else
+size_t qHash(const Revision &revision, size_t seed = 0);
+#endif
+
+} // namespace Cervisia
+
+#endif // CERVISIA_REVISION_H
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "revisionprefetcher.h"
+
+#include <QFile>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+
+#include <KConfigGroup>
+#include <kconfig.h>
+
+#include "cvsjobinterface.h"
+#include "cvsservice/cvsjob.h"
+#include "cvsserviceinterface.h"
+#include "debug.h"
+#include "misc.h"
+#include "revision.h"
+
+// the prefetcher waits for this time (in ms) after a selection, so that
+// it doesn't compete with an immediate request of the user
+static const int IDLE_DELAY = 500;
+
+namespace
+{
+struct Request {
+    enum Type { Diff, Annotate, Download };
+
+    Type type;
+    QString revA;
+    QString revB;
+
+    QString id() const
+    {
+        return QString::number(type) + QLatin1Char(':') + revA + QLatin1Char(':') + revB;
+    }
+};
+}
+
+struct RevisionPrefetcher::Private {
+    OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    QString fileName;
+    QString diffOptions;
+    unsigned contextLines;
+    bool isEnabled;
+    int budget; // number of jobs which may still be started
+
+    QSet<QString> revisions;
+    QList<Request> pending;
+    QSet<QString> requested; // ids of started requests
+
+    QTimer *idleTimer;
+    OrgKdeCervisia5CvsserviceCvsjobInterface *job; // the running job
+    QString jobPath;
+    QString tempFile; // output of the running download
+};
+
+RevisionPrefetcher::RevisionPrefetcher(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService,
+                                       const QString &fileName,
+                                       KConfig &partConfig,
+                                       QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    d->cvsService = cvsService;
+    d->fileName = fileName;
+    d->job = 0;
+
+    // use the same options as DiffDialog, otherwise the prefetched
+    // diff would be a different request
+    KConfigGroup cs(&partConfig, "General");
+    d->diffOptions = cs.readEntry("DiffOptions");
+    d->contextLines = cs.readEntry("ContextLines", 65535);
+
+    KConfigGroup cg(&partConfig, "LogDialog");
+    d->isEnabled = cg.readEntry("Prefetch", true);
+    d->budget = cg.readEntry("PrefetchBudget", 16);
+
+    d->idleTimer = new QTimer(this);
+    d->idleTimer->setSingleShot(true);
+    d->idleTimer->setInterval(IDLE_DELAY);
+    connect(d->idleTimer, SIGNAL(timeout()), this, SLOT(startNextJob()));
+}
+
+RevisionPrefetcher::~RevisionPrefetcher()
+{
+    if (d->job) {
+        // release() also cancels the job
+        d->job->release();
+        delete d->job;
+    }
+    if (!d->tempFile.isEmpty())
+        QFile::remove(d->tempFile);
+
+    delete d;
+}
+
+void RevisionPrefetcher::setRevisions(const QStringList &revisions)
+{
+    d->revisions = QSet<QString>(revisions.begin(), revisions.end());
+}
+
+void RevisionPrefetcher::prefetch(const QString &revision)
+{
+    if (!d->isEnabled || !d->revisions.contains(revision))
+        return;
+
+    d->pending.clear();
+
+    // the requests of LogDialog in the order of their likelihood
+    const QString previous = predecessor(revision);
+    if (!previous.isEmpty())
+        d->pending.append({Request::Diff, previous, revision});
+    d->pending.append({Request::Annotate, revision, QString()});
+    d->pending.append({Request::Download, revision, QString()});
+    if (!previous.isEmpty())
+        d->pending.append({Request::Download, previous, QString()});
+
+    // the successor on the same branch
+    const QString next = Cervisia::Revision(revision).successor().toString();
+    if (!next.isEmpty() && d->revisions.contains(next))
+        d->pending.append({Request::Download, next, QString()});
+
+    if (!d->job)
+        d->idleTimer->start();
+}
+
+QString RevisionPrefetcher::predecessor(const QString &revision)
+{
+    // first revision on a branch (1.2.4.1) => branchpoint (1.2)
+    return Cervisia::Revision(revision).predecessor().toString();
+}
+
+void RevisionPrefetcher::startNextJob()
+{
+    while (!d->job && d->budget > 0 && !d->pending.isEmpty()) {
+        const Request request = d->pending.takeFirst();
+        if (d->requested.contains(request.id()))
+            continue;
+        d->requested.insert(request.id());
+
+        QDBusReply<QDBusObjectPath> reply;
+        switch (request.type) {
+        case Request::Diff:
+            reply = d->cvsService->diff(d->fileName, request.revA, request.revB, d->diffOptions, d->contextLines);
+            break;
+        case Request::Annotate:
+            reply = d->cvsService->annotate(d->fileName, request.revA);
+            break;
+        case Request::Download:
+            d->tempFile = tempFileName(QLatin1String("-prefetch"));
+            reply = d->cvsService->downloadRevision(d->fileName, request.revA, d->tempFile);
+            break;
+        }
+
+        if (!reply.isValid() || reply.value().path().isEmpty()) {
+            // e.g. the service is gone; don't try again
+            d->pending.clear();
+            break;
+        }
+
+        d->jobPath = reply.value().path();
+        d->job = new OrgKdeCervisia5CvsserviceCvsjobInterface(d->cvsService->service(), d->jobPath, QDBusConnection::sessionBus(), this);
+        // only the result cache needs the output
+        d->job->setOutputRetention(CvsJob::RetainNone, 0);
+
+        connectCvsJob(d->cvsService->service(), d->jobPath, SIGNAL(jobExited(bool, int)), this, SLOT(slotJobExited(bool, int)));
+
+        --d->budget;
+        qCDebug(log_cervisia) << "prefetching" << request.id();
+
+        QDBusReply<bool> started = d->job->execute();
+        if (!started.isValid() || !started.value())
+            slotJobExited(false, -1);
+    }
+}
+
+void RevisionPrefetcher::slotJobExited(bool normalExit, int status)
+{
+    Q_UNUSED(normalExit)
+    Q_UNUSED(status)
+
+    disconnectCvsJob(d->cvsService->service(), d->jobPath, SIGNAL(jobExited(bool, int)), this, SLOT(slotJobExited(bool, int)));
+
+    d->job->release();
+    delete d->job;
+    d->job = 0;
+
+    // the service keeps the content, we don't need it
+    if (!d->tempFile.isEmpty()) {
+        QFile::remove(d->tempFile);
+        d->tempFile.clear();
+    }
+
+    if (!d->pending.isEmpty())
+        d->idleTimer->start();
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef REVISIONPREFETCHER_H
+#define REVISIONPREFETCHER_H
+
+#include <qobject.h>
+#include <qstringlist.h>
+
+class KConfig;
+class OrgKdeCervisia5CvsserviceCvsserviceInterface;
+
+/**
+ * Runs the requests a user of the log dialog will probably make next (diff
+ * against the predecessor, annotate, view) in the background, one at a
+ * time, so that the result cache of the cvs service already holds their
+ * output when the user asks for it. The number of jobs is limited.
+ */
+class RevisionPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    RevisionPrefetcher(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, const QString &fileName, KConfig &partConfig, QObject *parent = nullptr);
+    ~RevisionPrefetcher() override;
+
+    /**
+     * Sets all revisions of the file, used to find the neighbours of
+     * a revision.
+     */
+    void setRevisions(const QStringList &revisions);
+
+    /**
+     * Replaces the pending requests with those for @p revision.
+     */
+    void prefetch(const QString &revision);
+
+    /**
+     * @return The revision preceding @p revision on its branch (or the
+     *         branchpoint for the first revision on a branch) or a null
+     *         string for the initial revision.
+     */
+    static QString predecessor(const QString &revision);
+
+private Q_SLOTS:
+    void startNextJob();
+    void slotJobExited(bool normalExit, int status);
+
+private:
+    struct Private;
+    Private *const d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -125,10 +125,14 @@ void SettingsDialog::readSettings()
     KConfigGroup group = serviceConfig->group("General");
     cvspathedit->setUrl(group.readPathEntry("CVSPath", "cvs"));
     m_advancedPage->kcfg_Compression->setValue(group.readEntry("Compression", 0));
+    m_advancedPage->kcfg_AdaptiveCompression->setChecked(group.readEntry("AdaptiveCompression", false));
+    m_advancedPage->kcfg_MinCompression->setValue(group.readEntry("MinCompression", 0));
+    m_advancedPage->kcfg_MaxCompression->setValue(group.readEntry("MaxCompression", 9));
     m_advancedPage->kcfg_UseSshAgent->setChecked(group.readEntry("UseSshAgent", false));
 
     group = config->group("General");
     m_advancedPage->kcfg_Timeout->setValue(CervisiaSettings::timeout());
+    m_advancedPage->kcfg_InProcessService->setChecked(CervisiaSettings::inProcessService());
     usernameedit->setText(group.readEntry("Username", Cervisia::UserName()));
 
     contextedit->setValue(group.readEntry("ContextLines", 65535));
@@ -162,6 +166,9 @@ void SettingsDialog::writeSettings()
     KConfigGroup group = serviceConfig->group("General");
     group.writePathEntry("CVSPath", cvspathedit->text());
     group.writeEntry("Compression", m_advancedPage->kcfg_Compression->value());
+    group.writeEntry("AdaptiveCompression", m_advancedPage->kcfg_AdaptiveCompression->isChecked());
+    group.writeEntry("MinCompression", qMin(m_advancedPage->kcfg_MinCompression->value(), m_advancedPage->kcfg_MaxCompression->value()));
+    group.writeEntry("MaxCompression", qMax(m_advancedPage->kcfg_MinCompression->value(), m_advancedPage->kcfg_MaxCompression->value()));
     group.writeEntry("UseSshAgent", m_advancedPage->kcfg_UseSshAgent->isChecked());
 
     // write to disk so other services can reparse the configuration
@@ -169,6 +176,7 @@ void SettingsDialog::writeSettings()
 
     group = config->group("General");
     CervisiaSettings::setTimeout(m_advancedPage->kcfg_Timeout->value());
+    CervisiaSettings::setInProcessService(m_advancedPage->kcfg_InProcessService->isChecked());
     group.writeEntry("Username", usernameedit->text());
 
     group.writePathEntry("ExternalDiff", extdiffedit->text());
@@ -321,6 +329,14 @@ void SettingsDialog::addAdvancedPage()
     m_advancedPage->kcfg_Timeout->setRange(0, 50000);
     m_advancedPage->kcfg_Timeout->setSingleStep(100);
     m_advancedPage->kcfg_Compression->setRange(0, 9);
+    m_advancedPage->kcfg_MinCompression->setRange(0, 9);
+    m_advancedPage->kcfg_MaxCompression->setRange(0, 9);
+
+    // the bounds only matter when the level is chosen automatically
+    m_advancedPage->kcfg_MinCompression->setEnabled(false);
+    m_advancedPage->kcfg_MaxCompression->setEnabled(false);
+    connect(m_advancedPage->kcfg_AdaptiveCompression, SIGNAL(toggled(bool)), m_advancedPage->kcfg_MinCompression, SLOT(setEnabled(bool)));
+    connect(m_advancedPage->kcfg_AdaptiveCompression, SIGNAL(toggled(bool)), m_advancedPage->kcfg_MaxCompression, SLOT(setEnabled(bool)));
 
     addPage(page);
 }
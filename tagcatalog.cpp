@@ -0,0 +1,317 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "tagcatalog.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+#include <KLocalizedString>
+
+#include "cvsjobinterface.h"
+#include "cvsservice/cvsjob.h"
+#include "cvsservice/linesplitter.h"
+#include "cvsserviceinterface.h"
+#include "debug.h"
+#include "misc.h"
+#include "progressdialog.h"
+#include "repositoryinterface.h"
+
+// identifies the catalog files and their layout
+static const quint32 CATALOG_MAGIC = 0x43565447;
+static const quint32 CATALOG_VERSION = 1;
+
+// a catalog which was refreshed less than this (in seconds) ago isn't
+// refreshed again
+static const int REFRESH_INTERVAL = 60;
+
+struct TagCatalog::Private {
+    OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService;
+    QString repository;
+    QString module;
+    QString fileName;
+
+    QStringList tags;
+    QStringList branches;
+    QDateTime refreshed; // in UTC, invalid if the names were never read
+
+    // the names found by the running query, each only once
+    QSet<QString> newTags;
+    QSet<QString> newBranches;
+
+    // the query running in the background
+    OrgKdeCervisia5CvsserviceCvsjobInterface *job;
+    QString jobPath;
+    LineSplitter splitter;
+
+    void finishQuery();
+    void releaseJob(QObject *receiver);
+};
+
+void TagCatalog::Private::finishQuery()
+{
+    tags = QStringList(newTags.begin(), newTags.end());
+    tags.sort();
+    branches = QStringList(newBranches.begin(), newBranches.end());
+    branches.sort();
+    refreshed = QDateTime::currentDateTimeUtc();
+
+    newTags.clear();
+    newBranches.clear();
+
+    qCDebug(log_cervisia) << "tag catalog:" << tags.count() << "tags and" << branches.count() << "branches of" << module;
+}
+
+void TagCatalog::Private::releaseJob(QObject *receiver)
+{
+    disconnectCvsJob(cvsService->service(), jobPath, SIGNAL(receivedStdout(QString)), receiver, SLOT(slotReceivedOutput(QString)));
+    disconnectCvsJob(cvsService->service(), jobPath, SIGNAL(jobExited(bool, int)), receiver, SLOT(slotJobExited(bool, int)));
+
+    // release() also cancels a running job
+    job->release();
+    delete job;
+    job = 0;
+    splitter.clear();
+}
+
+TagCatalog::TagCatalog(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, const QString &repository, const QString &module)
+    : QObject(cvsService)
+    , d(new Private)
+{
+    d->cvsService = cvsService;
+    d->repository = repository;
+    d->module = module;
+    d->job = 0;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(repository.toUtf8());
+    // separate the parts, so that ("ab", "c") != ("a", "bc")
+    hash.addData("\0", 1);
+    hash.addData(module.toUtf8());
+
+    d->fileName = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/cervisia/tags/")
+        + QString::fromLatin1(hash.result().toHex()) + QLatin1String(".tags");
+}
+
+TagCatalog::~TagCatalog()
+{
+    if (d->job)
+        d->releaseJob(this);
+
+    delete d;
+}
+
+TagCatalog *TagCatalog::forWorkingCopy(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService)
+{
+    OrgKdeCervisia5RepositoryInterface cvsRepository(cvsService->service(), "/CvsRepository", QDBusConnection::sessionBus());
+    const QString repository = cvsRepository.location();
+
+    // the tags are collected for the module of the working copy
+    QFile file(cvsRepository.workingCopy() + QLatin1String("/CVS/Repository"));
+    const QString module = file.open(QIODevice::ReadOnly) ? QString::fromLocal8Bit(file.readLine()).trimmed() : QString();
+    if (repository.isEmpty() || module.isEmpty())
+        return 0;
+
+    const QString name = repository + QLatin1Char('\n') + module;
+    auto catalog = cvsService->findChild<TagCatalog *>(name, Qt::FindDirectChildrenOnly);
+    if (!catalog) {
+        catalog = new TagCatalog(cvsService, repository, module);
+        catalog->setObjectName(name);
+        catalog->load();
+    }
+
+    return catalog;
+}
+
+bool TagCatalog::isValid() const
+{
+    return d->refreshed.isValid();
+}
+
+QStringList TagCatalog::tags() const
+{
+    return d->tags;
+}
+
+QStringList TagCatalog::branches() const
+{
+    return d->branches;
+}
+
+bool TagCatalog::update(QWidget *parent)
+{
+    // the user waits anyway
+    if (d->job)
+        d->releaseJob(this);
+
+    QDBusReply<QDBusObjectPath> job = d->cvsService->rlogHeader(d->repository, d->module);
+    if (!job.isValid())
+        return false;
+
+    // the names are collected while the output arrives
+    OrgKdeCervisia5CvsserviceCvsjobInterface cvsJob(d->cvsService->service(), job.value().path(), QDBusConnection::sessionBus());
+    cvsJob.setOutputRetention(CvsJob::RetainNone, 0);
+
+    beginQuery();
+
+    ProgressDialog dlg(parent, "Logging", d->cvsService->service(), job, "rlog", i18n("CVS Log"));
+    dlg.setStreaming(true);
+    connect(&dlg, SIGNAL(receivedLine(QString)), this, SLOT(addLogLine(QString)));
+    if (!dlg.execute() || dlg.wasCancelled()) {
+        beginQuery();
+        return false;
+    }
+
+    d->finishQuery();
+    save();
+    return true;
+}
+
+void TagCatalog::refresh()
+{
+    if (d->job || (d->refreshed.isValid() && d->refreshed.secsTo(QDateTime::currentDateTimeUtc()) < REFRESH_INTERVAL))
+        return;
+
+    QDBusReply<QDBusObjectPath> reply = d->cvsService->rlogHeader(d->repository, d->module);
+    if (!reply.isValid() || reply.value().path().isEmpty())
+        return;
+
+    d->jobPath = reply.value().path();
+    d->job = new OrgKdeCervisia5CvsserviceCvsjobInterface(d->cvsService->service(), d->jobPath, QDBusConnection::sessionBus(), this);
+    // the names are collected while the output arrives
+    d->job->setOutputRetention(CvsJob::RetainNone, 0);
+
+    connectCvsJob(d->cvsService->service(), d->jobPath, SIGNAL(receivedStdout(QString)), this, SLOT(slotReceivedOutput(QString)));
+    connectCvsJob(d->cvsService->service(), d->jobPath, SIGNAL(jobExited(bool, int)), this, SLOT(slotJobExited(bool, int)));
+
+    beginQuery();
+
+    QDBusReply<bool> started = d->job->execute();
+    if (!started.isValid() || !started.value())
+        slotJobExited(false, -1);
+}
+
+void TagCatalog::addLogLine(const QString &line)
+{
+    parseLine(line);
+}
+
+void TagCatalog::revisionParsed(const CvsRecords::LogRecord & /*file*/, const CvsRecords::RevisionRecord & /*revision*/)
+{
+    // rlog -h reports no revisions
+}
+
+void TagCatalog::fileParsed(const CvsRecords::LogRecord &file)
+{
+    for (const CvsRecords::TagRecord &tag : file.tags) {
+        if (tag.isBranch)
+            d->newBranches.insert(tag.name);
+        else
+            d->newTags.insert(tag.name);
+    }
+}
+
+void TagCatalog::beginQuery()
+{
+    d->newTags.clear();
+    d->newBranches.clear();
+    reset();
+}
+
+void TagCatalog::slotReceivedOutput(QString buffer)
+{
+    d->splitter.append(buffer);
+
+    QStringView line;
+    while (d->splitter.nextLine(&line))
+        parseLine(line.toString());
+}
+
+void TagCatalog::slotJobExited(bool normalExit, int status)
+{
+    d->splitter.finish();
+
+    QStringView line;
+    while (d->splitter.nextLine(&line))
+        parseLine(line.toString());
+
+    d->releaseJob(this);
+
+    // keep the old names if cvs failed
+    if (normalExit && status == 0) {
+        d->finishQuery();
+        save();
+    } else {
+        beginQuery();
+    }
+}
+
+bool TagCatalog::load()
+{
+    QFile file(d->fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic, version;
+    QString repository, module;
+    stream >> magic >> version >> repository >> module;
+    if (magic != CATALOG_MAGIC || version != CATALOG_VERSION || repository != d->repository || module != d->module)
+        return false;
+
+    QStringList tags, branches;
+    QDateTime refreshed;
+    stream >> refreshed >> tags >> branches;
+    if (stream.status() != QDataStream::Ok || !refreshed.isValid())
+        return false;
+
+    d->tags = tags;
+    d->branches = branches;
+    d->refreshed = refreshed.toUTC();
+    return true;
+}
+
+bool TagCatalog::save() const
+{
+    QDir().mkpath(QFileInfo(d->fileName).absolutePath());
+
+    QSaveFile file(d->fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << CATALOG_MAGIC << CATALOG_VERSION << d->repository << d->module;
+    stream << d->refreshed << d->tags << d->branches;
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef TAGCATALOG_H
+#define TAGCATALOG_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "cvsservice/cvsrecords.h"
+
+class QWidget;
+class OrgKdeCervisia5CvsserviceCvsserviceInterface;
+
+/**
+ * The names of the tags and branches of a module. They are taken from the
+ * symbolic names in the headers of the logs of the module (cvs rlog -h),
+ * instead of the status of each file of the working copy. Like there, a
+ * name is a branch if its TagRecord says so.
+ *
+ * The names are kept in a file per repository and module. Only the first
+ * query waits for cvs, later ones are answered from the file at once while
+ * the catalog is refreshed in the background.
+ */
+class TagCatalog : public QObject, private CvsRecords::LogParser
+{
+    Q_OBJECT
+
+public:
+    ~TagCatalog() override;
+
+    /**
+     * @return The catalog of the module of the working copy of
+     *         @p cvsService or 0 if the module isn't known. The catalog is
+     *         a child of @p cvsService, so it's created only once.
+     */
+    static TagCatalog *forWorkingCopy(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService);
+
+    /**
+     * @return false if the names were never read
+     */
+    bool isValid() const;
+
+    /**
+     * @return The sorted names of the tags.
+     */
+    QStringList tags() const;
+
+    /**
+     * @return The sorted names of the branches, including the vendor
+     *         branch.
+     */
+    QStringList branches() const;
+
+    /**
+     * Reads the names and waits for cvs.
+     *
+     * @return false if cvs failed or the user cancelled it; the catalog is
+     *         unchanged then
+     */
+    bool update(QWidget *parent);
+
+    /**
+     * Reads the names in the background, unless this is already done or
+     * the catalog was refreshed a moment ago.
+     */
+    void refresh();
+
+private Q_SLOTS:
+    void addLogLine(const QString &line);
+    void slotReceivedOutput(QString buffer);
+    void slotJobExited(bool normalExit, int status);
+
+private:
+    TagCatalog(OrgKdeCervisia5CvsserviceCvsserviceInterface *cvsService, const QString &repository, const QString &module);
+
+    void revisionParsed(const CvsRecords::LogRecord &file, const CvsRecords::RevisionRecord &revision) override;
+    void fileParsed(const CvsRecords::LogRecord &file) override;
+
+    void beginQuery();
+    bool load();
+    bool save() const;
+
+    struct Private;
+    Private *d;
+};
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 4
+// End:
@@ -35,6 +35,110 @@
 using Cervisia::Entry;
 using Cervisia::EntryStatus;
 
+namespace
+{
+// is the item part of UpdateView::multipleSelection()?
+bool isSelectedItem(const QTreeWidgetItem *item)
+{
+    return item->isSelected() && !item->isHidden();
+}
+
+/**
+ * Collects the arguments for UpdateView::minimalSelection(), once for
+ * a recursive command and once for a command with -l. Directories which
+ * weren't scanned can't be replaced by their content and vice versa, so
+ * one of the lists may be impossible.
+ */
+class SelectionPlanner
+{
+public:
+    explicit SelectionPlanner(bool recursive)
+        : m_recursive(recursive)
+        , recursivePossible(true)
+        , localPossible(true)
+    {
+    }
+
+    /**
+     * Visits the directory @p dirItem.
+     *
+     * @param inherited true if a selected parent directory covers the
+     *        whole sub tree
+     * @param used set to true if the directory covers any files
+     * @return true if all files in the sub tree are covered, so that the
+     *         directory itself can stand for them in a recursive command
+     */
+    bool visit(UpdateDirItem *dirItem, bool inherited, bool *used);
+
+    bool m_recursive; // mode of the original command
+
+    QStringList recursiveList;
+    QStringList localList;
+    bool recursivePossible;
+    bool localPossible;
+};
+
+bool SelectionPlanner::visit(UpdateDirItem *dirItem, bool inherited, bool *used)
+{
+    const bool selected = isSelectedItem(dirItem);
+    const bool coversTree = inherited || (m_recursive && selected);
+    const bool scanned = dirItem->wasScanned();
+
+    // without scanning we only know about the selected directory itself
+    bool full = coversTree || scanned;
+    bool allFilesCovered = true;
+
+    *used = selected || (coversTree && !scanned);
+
+    // arguments if this directory can't stand for its content
+    QStringList recursiveArgs;
+    QStringList localArgs;
+
+    for (int i = 0; i < dirItem->childCount(); ++i) {
+        auto item = static_cast<UpdateItem *>(dirItem->child(i));
+
+        if (isDirItem(item)) {
+            bool childUsed = false;
+            if (visit(static_cast<UpdateDirItem *>(item), coversTree, &childUsed)) {
+                if (childUsed)
+                    recursiveArgs.append(item->filePath());
+            } else {
+                full = false;
+            }
+            *used = *used || childUsed;
+        } else if (coversTree || selected || isSelectedItem(item)) {
+            recursiveArgs.append(item->filePath());
+            localArgs.append(item->filePath());
+            *used = true;
+        } else {
+            allFilesCovered = false;
+            full = false;
+        }
+    }
+
+    // the files in this directory for a command with -l
+    if ((selected && !m_recursive) || (scanned && allFilesCovered && !localArgs.isEmpty()))
+        localList.append(dirItem->filePath());
+    else
+        localList += localArgs;
+
+    // with -l the content of unscanned sub directories is unknown
+    if (coversTree && !scanned)
+        localPossible = false;
+
+    // and so is the content of this one, if the directory was selected for
+    // a command with -l
+    if (selected && !m_recursive && !scanned)
+        recursivePossible = false;
+
+    if (full)
+        return true;
+
+    recursiveList += recursiveArgs;
+    return false;
+}
+}
+
 UpdateView::UpdateView(KConfig &partConfig, QWidget *parent)
     : QTreeWidget(parent)
     , m_partConfig(partConfig)
@@ -104,7 +208,7 @@ void UpdateView::getSingleSelection(QString *filename, QString *revision) const
     if ((listSelectedItems.count() == 1) && isFileItem(listSelectedItems.first())) {
         auto fileItem(static_cast<UpdateFileItem *>(listSelectedItems.first()));
         tmpFileName = fileItem->filePath();
-        tmpRevision = fileItem->entry().m_revision;
+        tmpRevision = fileItem->entry().m_revision.toString();
     }
 
     *filename = tmpFileName;
@@ -138,6 +242,33 @@ QStringList UpdateView::fileSelection() const
     return res;
 }
 
+QStringList UpdateView::minimalSelection(bool *recursive, bool canSwitchMode) const
+{
+    const QStringList selection = multipleSelection();
+    if (selection.count() < 2 || !topLevelItem(0))
+        return selection;
+
+    SelectionPlanner planner(*recursive);
+    bool used = false;
+    if (planner.visit(static_cast<UpdateDirItem *>(topLevelItem(0)), false, &used) && used)
+        planner.recursiveList.append(static_cast<UpdateDirItem *>(topLevelItem(0))->filePath());
+
+    QStringList result = selection;
+    const bool originalMode = *recursive;
+
+    if (planner.recursivePossible && (canSwitchMode || originalMode) && planner.recursiveList.count() < result.count()) {
+        result = planner.recursiveList;
+        *recursive = true;
+    }
+
+    if (planner.localPossible && (canSwitchMode || !originalMode) && planner.localList.count() < result.count()) {
+        result = planner.localList;
+        *recursive = false;
+    }
+
+    return result;
+}
+
 const QColor &UpdateView::conflictColor() const
 {
     return m_conflictColor;
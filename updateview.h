@@ -49,6 +49,18 @@ public:
     QStringList multipleSelection() const;
     /* Returns a list of all marked files, excluding directories*/
     QStringList fileSelection() const;
+    /**
+     * Returns the shortest list of directories and files which stands for
+     * the same files as multipleSelection() does in a command with the
+     * given recursion mode. E.g. a directory replaces its children, when
+     * they are all selected.
+     *
+     * @param recursive in: the mode of the command; out: the mode to use
+     *        with the returned list
+     * @param canSwitchMode whether the returned list may use the other
+     *        mode (false for commands without the -l option)
+     */
+    QStringList minimalSelection(bool *recursive, bool canSwitchMode = true) const;
 
     void openDirectory(const QString &dirname);
     void prepareJob(bool recursive, Action action);
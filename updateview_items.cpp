@@ -268,7 +268,7 @@ void UpdateDirItem::syncWithEntries()
                         entry.m_status = Cervisia::LocallyModified;
                 }
 
-                entry.m_revision = rev;
+                entry.m_revision = Cervisia::Revision(rev);
 
                 updateEntriesItem(entry, isBinary);
             }
@@ -291,7 +291,7 @@ void UpdateDirItem::syncWithDirectory()
             // is file removed?
             if (!dir.exists(it.key())) {
                 fileItem->setStatus(Cervisia::Removed);
-                fileItem->setRevTag(QString(), QString());
+                fileItem->setRevTag(Cervisia::Revision(), QString());
             }
         }
     }
@@ -409,7 +409,7 @@ bool UpdateFileItem::applyFilter(UpdateView::Filter filter)
     return visible;
 }
 
-void UpdateFileItem::setRevTag(const QString &rev, const QString &tag)
+void UpdateFileItem::setRevTag(const Cervisia::Revision &rev, const QString &tag)
 {
     m_entry.m_revision = rev;
 
@@ -514,7 +514,7 @@ bool UpdateFileItem::operator<(const QTreeWidgetItem &other) const
             return false;
 
     case Revision:
-        return ::compareRevisions(entry().m_revision, item.entry().m_revision) < 0;
+        return entry().m_revision < item.entry().m_revision;
 
     case TagOrDate:
         return entry().m_tag.localeAwareCompare(item.entry().m_tag) < 0;
@@ -537,7 +537,7 @@ QVariant UpdateFileItem::data(int column, int role) const
             return toString(entry().m_status);
 
         case Revision:
-            return entry().m_revision;
+            return entry().m_revision.toString();
 
         case TagOrDate:
             return entry().m_tag;
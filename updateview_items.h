@@ -151,7 +151,7 @@ public:
     QVariant data(int column, int role) const override;
 
     void setStatus(Cervisia::EntryStatus status);
-    void setRevTag(const QString &rev, const QString &tag);
+    void setRevTag(const Cervisia::Revision &rev, const QString &tag);
     void setDate(const QDateTime &date);
     void setUndefinedState(bool b)
     {
@@ -72,11 +72,12 @@ bool WatchersDialog::parseWatchers(OrgKdeCervisia5CvsserviceCvsserviceInterface
         return false;
 
     ProgressDialog dlg(this, "Watchers", cvsService->service(), job, "watchers", i18n("CVS Watchers"));
+    dlg.setRecordsOnly(true);
     if (!dlg.execute())
         return false;
 
     auto proxyModel = new WatchersSortModel(this);
-    proxyModel->setSourceModel(new WatchersModel(dlg.getOutput()));
+    proxyModel->setSourceModel(new WatchersModel(CvsRecords::read<CvsRecords::WatcherRecord>(dlg.getRecords(CvsRecords::Watchers))));
     m_tableView->setModel(proxyModel);
     m_tableView->sortByColumn(0, Qt::AscendingOrder);
 
@@ -20,12 +20,10 @@
 
 #include <KLocalizedString>
 
-#include "misc.h"
-
-WatchersModel::WatchersModel(const QStringList &data, QObject *parent)
+WatchersModel::WatchersModel(const QList<CvsRecords::WatcherRecord> &records, QObject *parent)
     : QAbstractTableModel(parent)
+    , m_list(records)
 {
-    parseData(data);
 }
 
 int WatchersModel::columnCount(const QModelIndex & /*parent*/) const
@@ -43,12 +41,12 @@ QVariant WatchersModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || index.row() < 0 || index.row() >= m_list.count())
         return {};
 
-    WatchersEntry entry = m_list.at(index.row());
+    const CvsRecords::WatcherRecord &entry = m_list.at(index.row());
 
     if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case FileColumn:
-            return entry.file;
+            return entry.fileName;
         case WatcherColumn:
             return entry.watcher;
         default:
@@ -99,27 +97,6 @@ QVariant WatchersModel::headerData(int section, Qt::Orientation orientation, int
     return QString(section);
 }
 
-void WatchersModel::parseData(const QStringList &data)
-{
-    foreach (const QString &line, data) {
-        // parse the output line
-        QStringList list = splitLine(line);
-
-        // ignore empty lines and unknown files
-        if (list.isEmpty() || list[0] == "?")
-            continue;
-
-        WatchersEntry entry;
-        entry.file = list[0];
-        entry.watcher = list[1];
-        entry.edit = list.contains("edit");
-        entry.unedit = list.contains("unedit");
-        entry.commit = list.contains("commit");
-
-        m_list.append(entry);
-    }
-}
-
 WatchersSortModel::WatchersSortModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
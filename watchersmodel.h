@@ -22,13 +22,7 @@
 #include <QAbstractTableModel>
 #include <QSortFilterProxyModel>
 
-struct WatchersEntry {
-    QString file;
-    QString watcher;
-    bool edit;
-    bool unedit;
-    bool commit;
-};
+#include "cvsservice/cvsrecords.h"
 
 class WatchersModel : public QAbstractTableModel
 {
@@ -37,7 +31,7 @@ class WatchersModel : public QAbstractTableModel
     enum Columns { FileColumn = 0, WatcherColumn, EditColumn, UneditColumn, CommitColumn };
 
 public:
-    explicit WatchersModel(const QStringList &data, QObject *parent = nullptr);
+    explicit WatchersModel(const QList<CvsRecords::WatcherRecord> &records, QObject *parent = nullptr);
 
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -46,9 +40,7 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
 private:
-    void parseData(const QStringList &data);
-
-    QList<WatchersEntry> m_list;
+    QList<CvsRecords::WatcherRecord> m_list;
 };
 
 class WatchersSortModel : public QSortFilterProxyModel